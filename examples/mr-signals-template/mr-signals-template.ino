@@ -4,6 +4,7 @@
 #include <LocoNet.h>
 #include "loconet/mrrwa_loconet_adapter.h"
 #include "loconet/loconet_txmgr.h"
+#include "base/trace.h"
 #include "sensor_interface.h"
 #include "pin_switch.h"
 
@@ -16,7 +17,7 @@ bool debug__=false;
 
 const int tx_pin = 47;
 const size_t num_sensors = 40;
-const size_t tx_buffer_size = 600;
+const size_t tx_buffer_size = 512;     // At most MRRWA_LN_TX_BUFFER_CAPACITY
 
 Setup_collection setup_coll(3);
 Loop_collection loop_coll(2);
@@ -60,6 +61,7 @@ void setup() {
   setup_coll.execute();
 
   Serial.begin(57600);
+  Trace_ring::set_serial_fallback(true);     // Print trace events as they occur
   Serial.println("Blackwood South V1.0");
   Serial.write("free RAM : ");
   Serial.println(freeRam());
@@ -67,6 +69,10 @@ void setup() {
   check_init_size("Sensors", loconet.sensor_count(), loconet. sensor_init_size());
   check_init_size("Logics", logic_coll.logic_count(),logic_coll.logic_init_size());
   check_init_size("Setups Funcs",setup_coll.count(), setup_coll.init_size());
+
+  if(loconet.get_config_error_count()) {
+    Serial << F("-LocoNet adapter not as configured; tx buffer is ") << loconet.get_buffer_size() << F(" bytes\n");
+  }
   
   Serial << F("\n");
 
@@ -88,9 +94,16 @@ void loop() {
     // Periodically report statistics every 20s
 
     Serial << F("LocoNet Stats:\n");
-    Serial << F("-Tx buffer_high_watermark : ") << loconet.get_buffer_high_watermark() << F("/") << tx_buffer_size << endl;
+    Serial << F("-Tx buffer_high_watermark : ") << loconet.get_buffer_high_watermark() << F("/") << loconet.get_buffer_size() << endl;
+    Serial << F("-Urgent tx buffer_high_watermark : ") << loconet.get_urgent_buffer_high_watermark() << F("/") << MRRWA_LN_TX_URGENT_BUFFER_CAPACITY << endl;
     Serial << F("-Tx error count : ") << loconet.get_tx_error_count() << endl;
     Serial << F("-LONG_ACKs rcvd : ") << loconet.get_long_ack_count() << endl;
+    Serial << F("-Rx buffer near full count : ") << loconet.get_rx_near_full_count() << F(" (max backlog ") << loconet.get_rx_backlog_high_watermark() << F(" bytes)") << endl;
+    loconet.get_tx_telemetry().print();
+#if MR_SIGNALS_LOOP_TIMING      // Set in the library's mr_signals_config.h, not here
+    Loop_timing::report(Serial, 5);
+    Loop_timing::reset();
+#endif
     
     last_stat_report = millis() + 60000;
   }  
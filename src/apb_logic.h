@@ -8,7 +8,8 @@
 #ifndef SRC_BASE_APB_SENSOR_H_
 #define SRC_BASE_APB_SENSOR_H_
 
-#include <vector>
+#include <stdint.h>
+#include <cstddef>
 #include "base/logic_interface.h"
 #include "logic_collection.h"
 #include "sensor_interface.h"
@@ -56,6 +57,9 @@ namespace mr_signals
  * The add apb_logic.down_tumbledown() as a sensor to every signal protecting
  * travel in the --> direction and apb_logic.up_tumbledown as a sensor to every
  * signal protecting travel in the <--- direction
+ *
+ * The protected sensors are copied to storage drawn from Startup_arena;
+ * Static_simple_apb keeps them in the object instead.
  */
 class Simple_apb : public Logic_interface
 {
@@ -64,11 +68,23 @@ public:
 
     void loop() override;
 
+    bool list_dependencies(Logic_dependencies& dependencies) const override;
+
     Sensor_interface& down_tumbledown();
     Sensor_interface& up_tumbledown();
 
+    Simple_apb(const Simple_apb&) = delete;
+    Simple_apb& operator=(const Simple_apb&) = delete;
+
+    virtual ~Simple_apb();
+
 protected:
-    std::vector<Sensor_interface*> protected_sensors_;
+
+    /// Protected sensors held by the derived class
+    Simple_apb(Logic_collection& collection, Sensor_list protected_sensors);
+
+    Sensor_list protected_sensors_;
+    bool owns_sensors_;                 // protected_sensors_ were copied to Startup_arena storage by this object
     Sensor_base down_tumbledown_sensor;
     Sensor_base up_tumbledown_sensor;
 
@@ -83,6 +99,36 @@ protected:
 #define east_tumbledown up_tumbledown
 
 
+/**
+ * Simple_apb holding up to N protected sensors in the object, so that
+ * constructing it uses no heap.  Passing more than N sensors is a compile
+ * error.
+ *
+ * Static_simple_apb<3> apb_logic(collection, {&sensor_1, &sensor_15, &sensor_3});
+ */
+template <std::size_t N>
+class Static_simple_apb : private Sensor_storage<N>, public Simple_apb
+{
+public:
+    template <std::size_t M>
+    Static_simple_apb(Logic_collection& collection, Sensor_interface* const (&protected_sensors)[M]) :
+        Sensor_storage<N>(protected_sensors),
+        Simple_apb(collection, this->sensors_.view()) {}
+};
+
+
+/**
+ * APB logic with a tumbledown per protected block in each direction, so that
+ * following trains are protected (see Full_apb::loop())
+ *
+ * The tumbledowns are held as bits, with a known (determinate) bit and a
+ * state bit for each, and are accessed through Tumbledown views, so a block
+ * costs two views and four bits with no allocation per block.  Each loop()
+ * reads every protected sensor once.
+ *
+ * The sensors, views and bits are drawn from Startup_arena when constructed;
+ * Static_full_apb keeps them in the object instead.
+ */
 class Full_apb : public Logic_interface
 {
 public:
@@ -90,18 +136,106 @@ public:
 
     void loop() override;
 
+    bool list_dependencies(Logic_dependencies& dependencies) const override;
+
     Sensor_interface& down_tumbledown_num(uint8_t num);
     Sensor_interface& up_tumbledown_num(uint8_t num);
 
+    Full_apb(const Full_apb&) = delete;
+    Full_apb& operator=(const Full_apb&) = delete;
+
+    virtual ~Full_apb();
+
+    /// Sensor_interface view of one tumbledown's bits in its Full_apb
+    class Tumbledown : public Sensor_interface {
+    public:
+        Tumbledown() : apb_(nullptr), bit_(0) {}
+        Tumbledown(const Full_apb& apb, uint16_t bit) : apb_(&apb), bit_(bit) {}
+
+        bool is_active() override { return apb_->is_set(known_set, bit_) && apb_->is_set(state_set, bit_); }
+        bool is_indeterminate() const override { return !apb_->is_set(known_set, bit_); }
+
+        /// State only changes in Full_apb::loop(), which reports each change
+        const void* change_source() const override { return static_cast<const Sensor_interface*>(this); }
+
+    private:
+        const Full_apb* apb_;
+        uint16_t bit_;
+    };
+
+    /// Bytes of bits_ for a number of protected sensors
+    static constexpr std::size_t bit_bytes(std::size_t num_sensors) { return 4 * ((num_sensors + 7) / 8); }
+
 protected:
-    std::vector<Sensor_interface*> protected_sensors_;
 
-    std::vector<Sensor_interface*>::size_type num_sensors_;   // protected_sensors_ count
+    /**
+     * Storage held by the derived class
+     * @param tumbledowns   - 2 * max(1, protected_sensors.size()) views
+     * @param bits          - bit_bytes(max(1, protected_sensors.size())) bytes
+     */
+    Full_apb(Logic_collection& collection, Sensor_list protected_sensors, Tumbledown* tumbledowns, uint8_t* bits);
+
+    /// Size the bit sets and point the views at them
+    void init_tumbledowns();
+
+    /// Bit sets in bits_, each of set_bytes_: the up tumbledowns' bits, then the down's
+    static const uint8_t state_set = 0;
+    static const uint8_t known_set = 1;
+
+    bool is_set(uint8_t set, uint16_t bit) const {
+        return bits_[set * set_bytes_ + (bit >> 3)] & (1 << (bit & 7));
+    }
+
+    /**
+     * Set the tumbledowns of one direction active for the blocks from first
+     * to last and inactive for the others, reporting each change
+     * @param down  - true for the down tumbledowns
+     */
+    void set_tumbledowns(bool down, std::size_t first, std::size_t last);
+
+    /// true if any tumbledown of a direction is active
+    bool any_active(bool down) const;
+
+    Sensor_list protected_sensors_;
+
+    std::size_t num_sensors_;           // protected_sensors_ count (at least 1)
+
+    std::size_t direction_bytes_;       // Bytes of a direction's bits in a set
+    std::size_t set_bytes_;             // 2 * direction_bytes_
+
+    uint8_t* bits_;                     // State set, then known set
+    Tumbledown* tumbledowns_;           // Up tumbledowns, then down
+    bool owns_storage_;                 // The above were drawn from Startup_arena by this object
+    uint8_t traced_states_;             // Trace_apb_state bits of the last loop(), traced on change
+};
+
+
+/// Storage for Static_full_apb, constructed before its Full_apb
+template <std::size_t N>
+struct Full_apb_storage : Sensor_storage<N> {
+    template <std::size_t M>
+    Full_apb_storage(Sensor_interface* const (&sensors)[M]) : Sensor_storage<N>(sensors), bit_storage_() {}
+
+    Full_apb::Tumbledown tumbledown_storage_[2 * N];
+    uint8_t bit_storage_[Full_apb::bit_bytes(N)];
+};
 
 
-    // TODO: Should this be a vector or something else?  Could even just be a simple array, are they iterated over?
-    std::vector<Sensor_base*> down_tumbledown_sensors_;
-    std::vector<Sensor_base*> up_tumbledown_sensors_;
+/**
+ * Full_apb holding up to N protected sensors, and their tumbledowns, in the
+ * object, so that constructing it uses no heap.  Passing more than N sensors
+ * is a compile error.
+ *
+ * Static_full_apb<3> apb_logic(collection, {&sensor_1, &sensor_15, &sensor_3});
+ */
+template <std::size_t N>
+class Static_full_apb : private Full_apb_storage<N>, public Full_apb
+{
+public:
+    template <std::size_t M>
+    Static_full_apb(Logic_collection& collection, Sensor_interface* const (&protected_sensors)[M]) :
+        Full_apb_storage<N>(protected_sensors),
+        Full_apb(collection, this->sensors_.view(), this->tumbledown_storage_, this->bit_storage_) {}
 };
 
 
@@ -8,17 +8,54 @@
 #include <cstddef>      // size_t
 #include <apb_logic.h>
 #include "algorithm.h"
+#include "trace.h"
+#include "change_listener.h"
+#include "startup_arena.h"
 
 using namespace mr_signals;
 
 
+namespace {
+
+/// Bit of a Trace_apb_state in a set of states
+uint8_t apb_state_bit(const Trace_apb_state state)
+{
+    return 1 << (uint8_t)state;
+}
+
+/// Trace each state in a set of states
+void trace_apb_states(const uint8_t states)
+{
+    for(uint8_t code = 0; code < 8; code++) {
+        if(states & (1 << code)) {
+            trace(Trace_event::apb_state, &code, 1);
+        }
+    }
+}
+
+}
+
+
 
 Simple_apb::Simple_apb(Logic_collection& collection, std::initializer_list<Sensor_interface *> const & protected_sensors) :
-        Logic_interface(collection), protected_sensors_(protected_sensors)
+        Logic_interface(collection), protected_sensors_(arena_copy(protected_sensors, Arena_use::logic_sensors)), owns_sensors_(true)
 {
     // Leave the tumbdown_sensors in their default (indeterminate) state
 }
 
+Simple_apb::Simple_apb(Logic_collection& collection, Sensor_list protected_sensors) :
+        Logic_interface(collection), protected_sensors_(protected_sensors), owns_sensors_(false)
+{
+    // Leave the tumbdown_sensors in their default (indeterminate) state
+}
+
+Simple_apb::~Simple_apb()
+{
+    if(owns_sensors_) {
+        arena_delete(protected_sensors_.begin(), protected_sensors_.size(), Arena_use::logic_sensors);
+    }
+}
+
 void Simple_apb::loop()
 {
     // First check that none of the sensors are indeterminate
@@ -59,6 +96,18 @@ void Simple_apb::loop()
 }
 
 
+bool Simple_apb::list_dependencies(Logic_dependencies& dependencies) const
+{
+    for(Sensor_interface* sensor : protected_sensors_) {
+        dependencies.input(*sensor);
+    }
+
+    dependencies.output(down_tumbledown_sensor);
+    dependencies.output(up_tumbledown_sensor);
+
+    return true;
+}
+
 Sensor_interface& Simple_apb::down_tumbledown()
 {
     return dynamic_cast<Sensor_interface&>(down_tumbledown_sensor);
@@ -75,26 +124,66 @@ Sensor_interface& Simple_apb::up_tumbledown()
 
 
 Full_apb::Full_apb(Logic_collection& collection, std::initializer_list<Sensor_interface *> const & protected_sensors) :
-        Logic_interface(collection), protected_sensors_(protected_sensors) {
-
+        Logic_interface(collection), protected_sensors_(arena_copy(protected_sensors, Arena_use::logic_sensors)), owns_storage_(true) {
 
     // Check protection against an empty initializer list being passed
     // The tumbledown sensor get functions have to return something, so
     // at least one sensor in each is always allocated
     num_sensors_ = (protected_sensors_.size() > 0) ? protected_sensors_.size() : 1;
 
+    bits_ = arena_new<uint8_t>(bit_bytes(num_sensors_), Arena_use::logic_sensors);
+    tumbledowns_ = arena_new<Tumbledown>(2 * num_sensors_, Arena_use::logic_sensors);
+
+    init_tumbledowns();
+}
+
+Full_apb::Full_apb(Logic_collection& collection, Sensor_list protected_sensors, Tumbledown* tumbledowns,
+                   uint8_t* bits) :
+        Logic_interface(collection), protected_sensors_(protected_sensors),
+        num_sensors_((protected_sensors.size() > 0) ? protected_sensors.size() : 1),
+        bits_(bits), tumbledowns_(tumbledowns), owns_storage_(false) {
+
+    init_tumbledowns();
+}
+
+Full_apb::~Full_apb()
+{
+    if(owns_storage_) {
+        arena_delete(protected_sensors_.begin(), protected_sensors_.size(), Arena_use::logic_sensors);
+        arena_delete(bits_, bit_bytes(num_sensors_), Arena_use::logic_sensors);
+        arena_delete(tumbledowns_, 2 * num_sensors_, Arena_use::logic_sensors);
+    }
+}
 
-    down_tumbledown_sensors_.reserve(num_sensors_);
-    up_tumbledown_sensors_.reserve(num_sensors_);
+void Full_apb::init_tumbledowns()
+{
+    direction_bytes_ = (num_sensors_ + 7) / 8;
+    set_bytes_ = 2 * direction_bytes_;
+    traced_states_ = 0;
 
-    for(uint8_t i=0;i < num_sensors_; i++) {
-        down_tumbledown_sensors_.push_back(new Sensor_base());
-        up_tumbledown_sensors_.push_back(new Sensor_base());
+    // Tumbledowns start indeterminate (not known)
+    for(std::size_t i = 0; i < 2 * set_bytes_; i++) {
+        bits_[i] = 0;
     }
 
+    for(std::size_t i = 0; i < num_sensors_; i++) {
+        tumbledowns_[i] = Tumbledown(*this, i);
+        tumbledowns_[num_sensors_ + i] = Tumbledown(*this, 8 * direction_bytes_ + i);
+    }
 }
 
-#include <iostream>
+bool Full_apb::list_dependencies(Logic_dependencies& dependencies) const
+{
+    for(Sensor_interface* sensor : protected_sensors_) {
+        dependencies.input(*sensor);
+    }
+
+    for(std::size_t i = 0; i < 2 * num_sensors_; i++) {
+        dependencies.output(tumbledowns_[i]);
+    }
+
+    return true;
+}
 
 void Full_apb::loop() {
 
@@ -171,195 +260,156 @@ void Full_apb::loop() {
      *
      */
 
-    /*  //If [0] & no up tumbledowns
-     *  //    Set all up tumbledowns
-     *
-     *  //If [-1] & no down tumbledowns
-     *  //    Set all down tumbledowns
+    /*
+     * Up tumbledown[i] protects block i from a train entering at block 0,
+     * so is active if any block from 0 to i is occupied (the first occupied
+     * block onwards), and down tumbledown[i] is active if any block from i
+     * to n-1 is (up to the last occupied block).  A single pass over the
+     * protected sensors finds the first and last occupied blocks, from
+     * which both directions are set.
      *
      * If any up tumbledowns...
-     *   tumbledown_up = false
-     *   for sensor0 to sensorN-1
-     *      if sensorx is clear & ! tumbledown_up:
-     *         up_tumbledown[x].clear
-     *      else
-     *         tumbledown_up = true
-     *         up_tumbledown[x].set
-     * Else if protected_sensor[0]  // No up tumbledowns
-     *   Set all up tumbledowns``// train entering in down direction
+     *   Set up tumbledowns from the first occupied block
+     * Else if protected_sensor[n-1]    // Train entering in the up direction
+     *   Set all down tumbledowns
      *
      * If any down tumbledowns...
-     *   tumbledown_down = false
-     *   for sensorN-1 to sensor0
-     *      if sensorx is clear & ! tumbledown_down:
-     *         down_tumbledown[x].clear
-     *      else
-     *         tumbledown_down = true
-     *         down_tumbledown[x].set
-     * Else if protected_sensors[-1] // No down tumbledowns
-     *   Set all down tumbledowns  // train entering in up direction
-     *
-     *
+     *   Set down tumbledowns up to the last occupied block
+     * Else if protected_sensors[0]     // Train entering in the down direction
+     *   Set all up tumbledowns
      */
 
+    const std::size_t count = protected_sensors_.size();
 
-    // Do nothing until the state of the sensors is known
-    if (std::none_of(protected_sensors_.begin(),
-                    protected_sensors_.end(),
-                    [](Sensor_interface* sensor) {return sensor->is_indeterminate();})) {
-
-
-        if (std::none_of(protected_sensors_.begin(),
-                        protected_sensors_.end(),
-                        [](Sensor_interface* sensor) {return sensor->is_active();})) {
+    std::size_t first = count;      // First occupied block, count if none
+    std::size_t last = 0;           // Last occupied block
+    uint8_t states = 0;             // Trace_apb_state bits of this pass
 
-            std::cout << "No sensors active, clear all tumbledowns\n";
+    for(std::size_t i = 0; i < count; i++) {
+        Sensor_interface* sensor = protected_sensors_[i];
 
-            // All sensors are clear, clear all tumbledowns
-            for(auto const& tumbledown : up_tumbledown_sensors_) {
-                tumbledown -> set_state(false);
-            }
+        if(sensor->is_indeterminate()) {
+            return;     // Do nothing until the state of the sensors is known
+        }
 
-            for(auto const& tumbledown : down_tumbledown_sensors_) {
-                tumbledown -> set_state(false);
+        if(sensor->is_active()) {
+            if(first == count) {
+                first = i;
             }
+            last = i;
         }
-        else {
-
-            // At least one sensor is active; run the APB logic
-
-            if (std::any_of(up_tumbledown_sensors_.begin(),
-                            up_tumbledown_sensors_.end(),
-                            [](Sensor_interface* sensor) {return sensor->is_active();})) {
-
-                // There is an active up tumbledown sensor; run across the protected
-                // sensors to determine which ones should be set and which not
-
-                std::cout << "Up tumbledowns are active\n";
-
-                bool set_all_subsequent_tumbledowns = false;
-
-                // Loop through sensors in the 'down' direction (from 0 to n-1)
-                for(std::vector<Sensor_interface*>::size_type i = 0; i != num_sensors_; i++) {
-                    if(!protected_sensors_[i]->is_active() && !set_all_subsequent_tumbledowns) {
-                        // Block is clear, clear the corresponding protecting tumbledown
-                        up_tumbledown_sensors_[i]->set_state(false);
-                    }
-                    else {
-                        // Block is not clear; set tumbledown and record this to set
-                        // all subsequent ones
-                        set_all_subsequent_tumbledowns = true;
-                        up_tumbledown_sensors_[i]->set_state(true);
-                    }
-                }
-            }
-/*
-            else if (protected_sensors_[0]->is_active()) {
+    }
 
+    if(first == count) {
 
-                std::cout << "Up tumbledowns are inactive, sensor[0] active, set up tumbledowns\n";
+        states |= apb_state_bit(Trace_apb_state::all_clear);
 
+        // All sensors are clear, clear all tumbledowns
+        set_tumbledowns(false, 1, 0);
+        set_tumbledowns(true, 1, 0);
+    }
+    else {
 
-                // There are no up tumbledowns, but the first block in the down direction
-                // is active, so assume a train is entering in the down direction
-                // and set the up tumbledowns
-                for(auto const& tumbledown: up_tumbledown_sensors_) {
-                    tumbledown->set_state(true);
-                }
-            }
-*/
-            else if (protected_sensors_[num_sensors_-1]->is_active()) {
+        // At least one sensor is active; run the APB logic
 
-                std::cout << "Up tumbledowns are inactive, sensor[n-1] active, set down tumbledowns\n";
+        if(any_active(false)) {
 
+            // There is an active up tumbledown sensor; set the tumbledowns
+            // from the first occupied block to the end
 
-                // There are no down tumbledowns actives, but the first block in the up direction
-                // is active, so assume a train is entering in the up direction
-                // and set the down tumbledowns
-                for(auto const& tumbledown: down_tumbledown_sensors_) {
-                    tumbledown->set_state(true);
-                }
-            }
+            states |= apb_state_bit(Trace_apb_state::up_active);
+
+            set_tumbledowns(false, first, num_sensors_ - 1);
+        }
+        else if(last == count - 1) {
 
+            states |= apb_state_bit(Trace_apb_state::up_inactive_last_occupied);
 
+            // There are no up tumbledowns active, but the first block in the up direction
+            // is active, so assume a train is entering in the up direction
+            // and set the down tumbledowns
+            set_tumbledowns(true, 0, num_sensors_ - 1);
+        }
 
-            if (std::any_of(down_tumbledown_sensors_.begin(),
-                            down_tumbledown_sensors_.end(),
-                            [](Sensor_interface* sensor) {return sensor->is_active();})) {
+        if(any_active(true)) {
 
-                std::cout << "Down tumbledowns are active\n";
+            states |= apb_state_bit(Trace_apb_state::down_active);
 
+            // There is an active down tumbledown sensor; set the tumbledowns
+            // from the start to the last occupied block
+            set_tumbledowns(true, 0, last);
+        }
+        else if(0 == first) {
 
-                // There is an active down tumbledown sensor; run across the protected
-                // sensors to determine which ones should be set and which not
-                bool set_all_subsequent_tumbledowns = false;
+            states |= apb_state_bit(Trace_apb_state::down_inactive_first_occupied);
 
-                // Loop through sensors in the 'down' direction (from 0 to n-1)
-                for(int i = num_sensors_-1; i >= 0 ; --i) {
-                    if(!protected_sensors_[i]->is_active() && !set_all_subsequent_tumbledowns) {
-                        // Block is clear, clear the corresponding protecting tumbledown
-                        down_tumbledown_sensors_[i]->set_state(false);
-                    }
-                    else {
-                        // Block is not clear; set tumbledown and record this to set
-                        // all subsequent ones
-                        set_all_subsequent_tumbledowns = true;
-                        down_tumbledown_sensors_[i]->set_state(true);
-                    }
-                }
+            // There are no down tumbledowns active, but the first block in the down direction
+            // is active, so assume a train is entering in the down direction
+            // and set the up tumbledowns
+            set_tumbledowns(false, 0, num_sensors_ - 1);
+        }
+    }
 
+    // Trace the state only when it changes, not on every pass
+    if(states != traced_states_) {
+        traced_states_ = states;
+        trace_apb_states(states);
+    }
+}
 
-            }
-/*
-            else if (protected_sensors_[num_sensors_-1]->is_active()) {
+void Full_apb::set_tumbledowns(bool down, std::size_t first, std::size_t last)
+{
+    uint8_t* state = &bits_[state_set * set_bytes_ + (down ? direction_bytes_ : 0)];
+    uint8_t* known = &bits_[known_set * set_bytes_ + (down ? direction_bytes_ : 0)];
 
-                std::cout << "Down tumbledowns are inactive, sensor[n-1] active, set down tumbledowns\n";
+    Tumbledown* tumbledowns = &tumbledowns_[down ? num_sensors_ : 0];
 
+    for(std::size_t byte = 0; byte < direction_bytes_; byte++) {
+        const std::size_t low = 8 * byte;
 
-                // There are no down tumbledowns actives, but the first block in the up direction
-                // is active, so assume a train is entering in the up direction
-                // and set the down tumbledowns
-                for(auto const& tumbledown: down_tumbledown_sensors_) {
-                    tumbledown->set_state(true);
-                }
-            }
-*/
-            else if (protected_sensors_[0]->is_active()) {
+        // Bits of this byte for tumbledowns that exist, and that are set
+        uint8_t valid = (num_sensors_ - low >= 8) ? 0xFF : (uint8_t)(0xFF >> (8 - (num_sensors_ - low)));
+        uint8_t active = 0;
+
+        if(first <= last && first < low + 8 && last >= low) {
+            uint8_t from = (first > low) ? first - low : 0;
+            uint8_t to = (last < low + 7) ? last - low : 7;
 
+            active = (uint8_t)(0xFF << from) & (uint8_t)(0xFF >> (7 - to));
+        }
 
-                std::cout << "Down tumbledowns are inactive, sensor[0] active, set up tumbledowns\n";
+        uint8_t changed = (uint8_t)((state[byte] ^ active) | ~known[byte]) & valid;
 
+        state[byte] = active;
+        known[byte] = valid;
 
-                // There are no up tumbledowns, but the first block in the down direction
-                // is active, so assume a train is entering in the down direction
-                // and set the up tumbledowns
-                for(auto const& tumbledown: up_tumbledown_sensors_) {
-                    tumbledown->set_state(true);
-                }
+        for(uint8_t bit = 0; changed; bit++, changed >>= 1) {
+            if(changed & 1) {
+                Change_listener::notify(static_cast<const Sensor_interface*>(&tumbledowns[low + bit]));
             }
-
         }
     }
-    else {
-        // At least one sensor indeterminate; skip
+}
+
+bool Full_apb::any_active(bool down) const
+{
+    const uint8_t* state = &bits_[state_set * set_bytes_ + (down ? direction_bytes_ : 0)];
+    const uint8_t* known = &bits_[known_set * set_bytes_ + (down ? direction_bytes_ : 0)];
+
+    for(std::size_t byte = 0; byte < direction_bytes_; byte++) {
+        if(state[byte] & known[byte]) {
+            return true;
+        }
     }
 
+    return false;
 }
 
 
 Sensor_interface& Full_apb::down_tumbledown_num(uint8_t num) {
-    size_t idx = num < down_tumbledown_sensors_.size() ? num : 0;
-
-    // Can't cast a pointer to a reference directly; so use intermediate local pointer
-    Sensor_interface *sensor = static_cast<Sensor_interface*>(down_tumbledown_sensors_[idx]);
-    return *sensor;
+    return tumbledowns_[num_sensors_ + (num < num_sensors_ ? num : 0)];
 }
 
 Sensor_interface& Full_apb::up_tumbledown_num(uint8_t num) {
-    size_t idx = num < up_tumbledown_sensors_.size() ? num : 0;
-
-    // Can't cast a pointer to a reference directly; so use intermediate local pointer
-    Sensor_interface *sensor = static_cast<Sensor_interface*>(up_tumbledown_sensors_[idx]);
-    return *sensor;
+    return tumbledowns_[num < num_sensors_ ? num : 0];
 }
-
@@ -0,0 +1,12 @@
+/*
+ * change_listener.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "change_listener.h"
+
+using namespace mr_signals;
+
+
+Change_listener* Change_listener::listener_ = nullptr;
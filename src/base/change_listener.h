@@ -0,0 +1,48 @@
+/*
+ * change_listener.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_CHANGE_LISTENER_H_
+#define SRC_BASE_CHANGE_LISTENER_H_
+
+namespace mr_signals {
+
+/**
+ * Receives reports of sensors and heads whose state has changed
+ *
+ * Sensor_base::set_state() and Head_interface::set_aspect() report each
+ * change to the one registered listener (normally a Logic_collection with
+ * change propagation enabled), keyed by the address of the Sensor_interface
+ * or Head_interface that changed.  With no listener registered a report is a
+ * single pointer test.
+ */
+class Change_listener {
+public:
+
+    /// Called with the Sensor_interface* or Head_interface* that changed
+    virtual void changed(const void* source) = 0;
+
+    /// Register the listener for all changes; nullptr to stop reporting
+    static void set_listener(Change_listener* listener) { listener_ = listener; }
+
+    static Change_listener* get_listener() { return listener_; }
+
+    /// Report a change to the registered listener, if any
+    static void notify(const void* source) {
+        if(listener_) {
+            listener_->changed(source);
+        }
+    }
+
+    virtual ~Change_listener() = default;
+
+private:
+    static Change_listener* listener_;
+};
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_BASE_CHANGE_LISTENER_H_ */
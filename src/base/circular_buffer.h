@@ -10,56 +10,92 @@
 
 #include <cstddef>      // std::size_t
 #include <stdint.h>     // uint8_t
-#include <new>          // std::no_throw
+#include <algorithm>    // std::copy
 
+
+/**
+ * Fixed capacity FIFO with its storage embedded in the object
+ *
+ * The capacity N is a compile time constant that must be a power of two so
+ * that the read and write indexes are wrapped with a mask rather than a
+ * modulo (a software division on AVR).
+ *
+ * Example
+ *
+ * Circular_buffer<uint8_t, 64> buffer;     // 64 bytes of storage, no heap
+ *
+ * buffer.enqueue(0x12);
+ *
+ * Besides single element access, runs of elements can be moved in and out
+ * with at most two block copies (one either side of the wrap point), and
+ * writers/readers can work directly on the storage with reserve()/commit()
+ * and peek()/consume().  Queued elements can be read or updated in place
+ * with at().
+ *
+ * @param T Element type (copied in and out by value)
+ * @param N Capacity in elements; must be a power of two and at least 2
+ */
+template <class T, std::size_t N>
 class Circular_buffer {
 
+    static_assert(N >= 2, "Circular_buffer capacity must be at least 2");
+    static_assert((N & (N - 1)) == 0, "Circular_buffer capacity must be a power of two");
+
 public:
-    Circular_buffer() {
-        buffer_ = nullptr;
+    Circular_buffer() : head_(0), tail_(0), count_(0), high_watermark_(0) {}
 
-        head_ = 0;
-        tail_ = 0;
-        count_ = 0;
-        buffer_size_ = 0;
-        high_watermark_ = 0;
-    }
 
-    bool initialize(const std::size_t size) {
-        bool return_val = false;
+    bool enqueue(const T& element) {
+        bool return_value = false;
+
+        if(count_ < N) {
+
+            buffer_[tail_] = element;
+            tail_ = (tail_+1) & index_mask_;
+            count_ ++;
+
+            if(count_ > high_watermark_) {
+                high_watermark_ = count_;
+            }
 
-        // Check buffer doesn't already exist and that the requested size is valid
-        if(nullptr == buffer_ && size >= 2) {
+            return_value = true;
+        }
 
-            buffer_ = new (std::nothrow) uint8_t[size];
+        return (return_value);
+    }
 
-            if(buffer_) {
-                // buffer_ allocated; initialize member variables and indicate success to return
-                buffer_size_ = size;
 
-                head_ = 0;
-                tail_ = buffer_size_-1;
+    bool dequeue(T& element) {
+        bool return_val = false;
 
-                return_val = true;    // Buffer was created and class is initialized
-            }
+        if(count_ > 0) {
+            element = buffer_[head_];
+            head_ = (head_+1) & index_mask_;
+            count_--;
+
+            return_val = true;
         }
 
-        return (return_val);   // Any error occured
+        return(return_val);
     }
 
 
-    bool enqueue(const uint8_t& byte) {
+    /**
+     * Enqueue count elements, or none if they do not all fit
+     *
+     * @return true if all elements were enqueued
+     */
+    bool enqueue(const T* elements, const std::size_t count) {
         bool return_value = false;
 
-        if(count_ < buffer_size_) {
+        if(count <= get_free()) {
 
-            tail_ = (tail_+1) % buffer_size_;
-            buffer_[tail_] = byte;
-            count_ ++;
+            std::size_t first_len = contiguous(tail_, count);
 
-            if(count_ > high_watermark_) {
-                high_watermark_ = count_;
-            }
+            std::copy(elements, elements + first_len, &buffer_[tail_]);
+            std::copy(elements + first_len, elements + count, &buffer_[0]);
+
+            commit(count);
 
             return_value = true;
         }
@@ -68,13 +104,38 @@ public:
     }
 
 
-    bool dequeue(uint8_t& byte) {
+    /**
+     * Dequeue count elements, or none if fewer than count are held
+     *
+     * @return true if count elements were dequeued
+     */
+    bool dequeue(T* elements, const std::size_t count) {
+        bool return_val = peek(elements, count);
+
+        if(return_val) {
+            consume(count);
+        }
+
+        return(return_val);
+    }
+
+
+    /**
+     * Copy count elements, starting offset elements from the head, without
+     * removing them from the buffer
+     *
+     * @return true if the requested elements are held and were copied
+     */
+    bool peek(T* elements, const std::size_t count, const std::size_t offset = 0) const {
         bool return_val = false;
 
-        if(count_ > 0) {
-            byte = buffer_[head_];
-            head_ = (head_+1) % buffer_size_;
-            count_--;
+        if(offset + count <= count_) {
+
+            std::size_t start = (head_ + offset) & index_mask_;
+            std::size_t first_len = contiguous(start, count);
+
+            std::copy(&buffer_[start], &buffer_[start] + first_len, elements);
+            std::copy(&buffer_[0], &buffer_[0] + (count - first_len), elements + first_len);
 
             return_val = true;
         }
@@ -83,26 +144,95 @@ public:
     }
 
 
-    const std::size_t get_free() {
-        return(buffer_size_ - count_);
+    /**
+     * Get the contiguous free region at the write index for in-place writing
+     *
+     * The region ends at the lesser of the free space and the end of the
+     * storage; once it is filled, commit() the number of elements written.
+     * A further call after commit() returns the region after the wrap.
+     *
+     * @param length - Set to the number of elements that may be written
+     * @return Pointer to the first element of the region
+     */
+    T* reserve(std::size_t& length) {
+        length = contiguous(tail_, get_free());
+        return &buffer_[tail_];
+    }
+
+    /// Make count elements written through reserve() available to readers
+    void commit(const std::size_t count) {
+        tail_ = (tail_ + count) & index_mask_;
+        count_ += count;
+
+        if(count_ > high_watermark_) {
+            high_watermark_ = count_;
+        }
+    }
+
+
+    /**
+     * Get the contiguous readable region at the read index for in-place reading
+     *
+     * @param length - Set to the number of elements that may be read
+     * @return Pointer to the first element of the region
+     */
+    const T* peek(std::size_t& length) const {
+        length = contiguous(head_, count_);
+        return &buffer_[head_];
     }
 
-    const std::size_t max_size() {
-        return(buffer_size_);
+    /// Remove count elements (as read through peek()) from the buffer
+    void consume(const std::size_t count) {
+        head_ = (head_ + count) & index_mask_;
+        count_ -= count;
+    }
+
+
+    /**
+     * Access the element offset elements from the head in place, e.g. to
+     * update an element that is still queued
+     *
+     * @param offset - Must be less than size()
+     */
+    T& at(const std::size_t offset) {
+        return buffer_[(head_ + offset) & index_mask_];
     }
 
-    const std::size_t high_watermark() {
+    const T& at(const std::size_t offset) const {
+        return buffer_[(head_ + offset) & index_mask_];
+    }
+
+
+    std::size_t size() const {
+        return(count_);
+    }
+
+    std::size_t get_free() const {
+        return(N - count_);
+    }
+
+    static constexpr std::size_t max_size() {
+        return(N);
+    }
+
+    std::size_t high_watermark() const {
         return(high_watermark_);
     }
 
 
 private:
-    uint8_t *buffer_;
+    static const std::size_t index_mask_ = N - 1;
+
+    /// Number of count elements from index that fit before the end of the storage
+    static std::size_t contiguous(const std::size_t index, const std::size_t count) {
+        return (count < N - index) ? count : N - index;
+    }
+
+    T buffer_[N];
 
     std::size_t head_;                   // Index where the next element will be removed from the buffer
-    std::size_t tail_;                   // Index prior to where the next element will be inserted
+    std::size_t tail_;                   // Index where the next element will be inserted
     std::size_t count_;                  // Number of valid elements in the buffer
-    std::size_t buffer_size_;            // How many entries are in T *buffer in total
     std::size_t high_watermark_;         // Maximum value count has reached
 
 };  // class Circular_buffer
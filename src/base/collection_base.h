@@ -8,9 +8,11 @@
 #ifndef SRC_BASE_COLLECTION_BASE_H_
 #define SRC_BASE_COLLECTION_BASE_H_
 
-#include <vector>
 #include <stdint.h>
 
+#include "loop_timing.h"
+#include "startup_arena.h"
+
 typedef uint8_t collec_size;
 
 template <class T,void (T::*method)()>
@@ -18,17 +20,33 @@ class Collection_base {
 
 public:
 
-    Collection_base(const collec_size size) : init_size_(size ){
+    /**
+     * @param size          - Number of objects to reserve storage for
+     * @param timing_label  - Label of the objects in Loop_timing reports
+     */
+    Collection_base(const collec_size size, const char* timing_label = "task") : init_size_(size ){
         collected_objects_.reserve(init_size_);
+#if MR_SIGNALS_LOOP_TIMING
+        timing_label_ = timing_label;
+        timing_slots_.reserve(init_size_);
+#else
+        (void)timing_label;
+#endif
     }
 
     void attach(T* obj) {
         collected_objects_.push_back(obj);
+#if MR_SIGNALS_LOOP_TIMING
+        timing_slots_.push_back(mr_signals::Loop_timing::add(obj, timing_label_));
+#endif
     }
 
     void execute() {
-        for(T* obj : collected_objects_) {
-            (obj->*method)();
+        for(collec_size i = 0; i < collected_objects_.size(); i++) {
+#if MR_SIGNALS_LOOP_TIMING
+            mr_signals::Loop_timer timer(timing_slots_[i]);
+#endif
+            (collected_objects_[i]->*method)();
         }
     }
 
@@ -42,8 +60,13 @@ public:
 
 
 protected:
-    std::vector<T*> collected_objects_;
+    mr_signals::Arena_vector<T*, mr_signals::Arena_use::collections> collected_objects_;
     collec_size init_size_;
+
+#if MR_SIGNALS_LOOP_TIMING
+    const char* timing_label_;
+    mr_signals::Arena_vector<mr_signals::Timing_slot, mr_signals::Arena_use::loop_timing> timing_slots_;   // Per collected_objects_ entry
+#endif
 };
 
 
@@ -7,6 +7,7 @@
 
 #include <string.h>
 #include "head_interface.h"
+#include "change_listener.h"
 
 using namespace mr_signals;
 
@@ -17,8 +18,25 @@ Head_interface::Head_interface(const char* name)
     strncpy(name_, name, head_name_len);
     name_[head_name_len] = '\0';
 
-    set_aspect(Head_aspect::unknown);
+    aspect_ = (uint8_t) Head_aspect::unknown;
     held_ = held_false;
+    restricting_ = 0;
+}
+
+namespace {
+
+/// Order aspects from least to most restrictive; unknown is unranked (0)
+uint8_t restriction_rank(const Head_aspect aspect)
+{
+    switch(aspect) {
+    case Head_aspect::green:    return 1;
+    case Head_aspect::yellow:   return 2;
+    case Head_aspect::red:
+    case Head_aspect::dark:     return 3;
+    default:                    return 0;
+    }
+}
+
 }
 
 
@@ -55,6 +73,9 @@ bool Head_interface::request_aspect(const Head_aspect aspect)
 
                 // If the head's aspect isn't being held, and a different
                 // aspect is being requested, attempt to set the outputs
+                restricting_ = (Head_aspect::unknown != get_aspect() &&
+                                restriction_rank(aspect) > restriction_rank(get_aspect())) ? 1 : 0;
+
                 if (request_outputs(aspect)) {
 
                     // If the output set to the requested aspect, update
@@ -71,7 +92,10 @@ bool Head_interface::request_aspect(const Head_aspect aspect)
 
 void Head_interface::set_aspect(Head_aspect aspect)
 {
-    aspect_ = (uint8_t) aspect;
+    if((uint8_t) aspect != aspect_) {
+        aspect_ = (uint8_t) aspect;
+        Change_listener::notify(this);
+    }
 }
 
 bool Head_interface::request_outputs(Head_aspect aspect)
@@ -80,6 +104,11 @@ bool Head_interface::request_outputs(Head_aspect aspect)
 }
 
 
+bool Head_interface::is_restricting() const
+{
+    return (restricting_) ? true : false;
+}
+
 Head_aspect Head_interface::get_aspect() const
 {
     return (Head_aspect) aspect_;
@@ -122,6 +122,16 @@ protected:
      */
     virtual bool request_outputs(Head_aspect aspect);
 
+    /**
+     * Indicates whether the aspect being requested by the current call to
+     * request_outputs() is more restrictive than the current aspect (e.g.
+     * green to yellow or yellow to red).  Changes from an unknown aspect
+     * (initial setting) are not.
+     *
+     * Heads driving bus switches use this to request urgent transmission
+     */
+    bool is_restricting() const;
+
 private:
     static const int head_name_len = 5;
     char name_[head_name_len+1];        /// Name of the head.  Char array more RAM efficient than std::string
@@ -134,6 +144,7 @@ private:
         held_true
     };
     uint8_t held_ : 1;                 /// Aspect of the head is being held (locked)
+    uint8_t restricting_ : 1;          /// Aspect in request_outputs() is more restrictive than the current
 
 };
 
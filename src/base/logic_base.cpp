@@ -9,19 +9,145 @@
 
 #include "../logic_collection.h"
 #include "logic_interface.h"
+#include "head_interface.h"
+#include "../sensor_interface.h"
+
+#include <algorithm>
+#include <functional>   // std::less
 
 
 using namespace mr_signals;
 
 
+namespace {
+
+/// Vector for the working storage of enable_change_propagation(), drawn from
+/// Startup_arena above the index and released in reverse order so that the
+/// arena is rewound.  Blocks are in pointers, the largest element alignment.
+template <class T>
+using Scratch_vector = std::vector<T, Arena_allocator<T, Arena_use::logic, alignof(void*)>>;
+
+
+/// Collects the dependencies listed by one logic into the index entries, or
+/// only counts them if not given vectors to fill
+class Dependency_collector : public Logic_dependencies {
+public:
+    struct Entry {
+        const void* source;
+        uint16_t logic;
+    };
+
+    Dependency_collector(Scratch_vector<Entry>* inputs, Scratch_vector<Entry>* outputs) :
+        inputs_(inputs), outputs_(outputs), input_count_(0), output_count_(0), logic_(0), polled_(false) {}
+
+    void start(uint16_t logic) { logic_ = logic; polled_ = false; }
+
+    bool is_polled() const { return polled_; }
+
+    std::size_t input_count() const { return input_count_; }
+    std::size_t output_count() const { return output_count_; }
+
+    void input(const Sensor_interface& sensor) override {
+        const void* source = sensor.change_source();
+
+        if(nullptr == source) {
+            polled_ = true;     // Changes are not reported
+        }
+        else {
+            add(inputs_, input_count_, source);
+        }
+    }
+
+    void input(const Head_interface& head) override {
+        add(inputs_, input_count_, &head);
+    }
+
+    void output(const Sensor_interface& sensor) override {
+        const void* source = sensor.change_source();
+
+        if(nullptr != source) {
+            add(outputs_, output_count_, source);
+        }
+    }
+
+    void output(const Head_interface& head) override {
+        add(outputs_, output_count_, &head);
+    }
+
+private:
+    void add(Scratch_vector<Entry>* entries, std::size_t& count, const void* source) {
+        if(nullptr != entries) {
+            entries->push_back({source, logic_});
+        }
+
+        count++;
+    }
+
+    Scratch_vector<Entry>* inputs_;
+    Scratch_vector<Entry>* outputs_;
+    std::size_t input_count_;
+    std::size_t output_count_;
+    uint16_t logic_;
+    bool polled_;
+};
+
+bool source_less(const Dependency_collector::Entry& a, const Dependency_collector::Entry& b)
+{
+    return std::less<const void*>()(a.source, b.source);
+}
+
+#if MR_SIGNALS_LOOP_TIMING
+
+/// Finds the first head a logic sets, to name the logic in Loop_timing reports
+class First_output_head : public Logic_dependencies {
+public:
+    First_output_head() : head_(nullptr) {}
+
+    void input(const Sensor_interface&) override {}
+    void input(const Head_interface&) override {}
+    void output(const Sensor_interface&) override {}
+
+    void output(const Head_interface& head) override {
+        if(nullptr == head_) {
+            head_ = &head;
+        }
+    }
+
+    const Head_interface* head_;
+};
+
+const char* logic_timing_name(const void* object)
+{
+    First_output_head first;
+
+    (void) static_cast<const Logic_interface*>(object)->list_dependencies(first);
+
+    return first.head_ ? first.head_->get_name() : nullptr;
+}
+
+#endif
+
+}
+
+
     /// Dimension the storage at construction so that the storage ::vector
 /// does not continue to inefficiently grow.
 /// A reference to the Logic_Collection is passed to each Logic_interface
 /// so that the interface can be attached to the collection.
-Logic_collection::Logic_collection(size_t num_logic_interfaces) {
+Logic_collection::Logic_collection(size_t num_logic_interfaces) :
+        dirty_count_(0), polled_count_(0), propagate_(false) {
     init_size_ = num_logic_interfaces;
 
     logic_functions_.reserve(init_size_);
+#if MR_SIGNALS_LOOP_TIMING
+    timing_slots_.reserve(init_size_);
+#endif
+}
+
+Logic_collection::~Logic_collection() {
+    if(this == get_listener()) {
+        set_listener(nullptr);
+    }
 }
 
 /**
@@ -31,6 +157,9 @@ Logic_collection::Logic_collection(size_t num_logic_interfaces) {
  */
 void Logic_collection::attach_logic_interface(Logic_interface *interface) {
     logic_functions_.push_back(interface);
+#if MR_SIGNALS_LOOP_TIMING
+    timing_slots_.push_back(Loop_timing::add(interface, "logic", logic_timing_name));
+#endif
 }
 
 /**
@@ -52,8 +181,203 @@ size_t Logic_collection::logic_init_size() {
 /// To be called in the main Arduino loop() so that the logic functions
 /// are periodically run
 void Logic_collection::loop() {
-    for (Logic_interface* logic : logic_functions_) {
-        logic->loop();
+    if(!propagate_) {
+        for(uint16_t i = 0; i < logic_functions_.size(); i++) {
+#if MR_SIGNALS_LOOP_TIMING
+            Loop_timer timer(timing_slots_[i]);
+#endif
+            logic_functions_[i]->loop();
+        }
+        return;
+    }
+
+    if(0 == dirty_count_ && 0 == polled_count_) {
+        return;     // Nothing has changed
+    }
+
+    // Logic marked by a change made in this pass is evaluated in this pass
+    // if it comes later in the order, otherwise on the next loop()
+    for(uint16_t i = 0; i < logic_functions_.size(); i++) {
+        if(flags_[i] & logic_dirty) {
+            flags_[i] &= ~logic_dirty;
+            dirty_count_--;
+        }
+        else if(!(flags_[i] & logic_polled)) {
+            continue;
+        }
+
+        {
+#if MR_SIGNALS_LOOP_TIMING
+            Loop_timer timer(timing_slots_[i]);
+#endif
+            logic_functions_[i]->loop();
+        }
+
+        if(!logic_functions_[i]->is_settled()) {
+            mark_dirty(i);
+        }
+    }
+}
+
+
+/**
+ * Builds the input index and evaluation order for change propagation
+ *
+ * Logic is ordered by a topological sort of the graph from each logic to the
+ * logic that reads its outputs, taking the earliest attached logic that is
+ * ready at each step so unrelated logic keeps its attach order.  Logic in a
+ * cycle (e.g. heads protecting each other) is taken in attach order.  This
+ * is O(n^2) in the amount of logic, but is only run once at startup.
+ *
+ * The dependencies are counted first so that the index is drawn before the
+ * working storage, which is sized exactly and released (in reverse order of
+ * declaration) back to the top of Startup_arena, leaving nothing behind.
+ */
+void Logic_collection::enable_change_propagation() {
+    typedef Dependency_collector::Entry Entry;
+
+    const uint16_t count = logic_functions_.size();
+
+    Dependency_collector counter(nullptr, nullptr);
+
+    for(uint16_t i = 0; i < count; i++) {
+        counter.start(i);
+        (void) logic_functions_[i]->list_dependencies(counter);
+    }
+
+    flags_.assign(count, 0);
+    dependents_.clear();
+    dependents_.reserve(counter.input_count());
+
+    Scratch_vector<Entry> inputs;
+    Scratch_vector<Entry> outputs;
+    inputs.reserve(counter.input_count());
+    outputs.reserve(counter.output_count());
+
+    Scratch_vector<uint8_t> flags(count, logic_dirty);
+
+    Dependency_collector collector(&inputs, &outputs);
+
+    for(uint16_t i = 0; i < count; i++) {
+        collector.start(i);
+
+        if(!logic_functions_[i]->list_dependencies(collector) || collector.is_polled()) {
+            flags[i] |= logic_polled;
+        }
+    }
+
+    std::sort(inputs.begin(), inputs.end(), source_less);
+
+    // Edges from the logic setting each output to the logic reading it
+    struct Edge {
+        uint16_t from;
+        uint16_t to;
+    };
+
+    Scratch_vector<uint16_t> in_degree(count, 0);
+    std::size_t edge_count = 0;
+
+    for(const Entry& output : outputs) {
+        for(auto input = std::lower_bound(inputs.begin(), inputs.end(), output, source_less);
+                input != inputs.end() && input->source == output.source; ++input) {
+
+            if(input->logic != output.logic) {
+                in_degree[input->logic]++;
+                edge_count++;
+            }
+        }
+    }
+
+    Scratch_vector<Edge> edges;
+    edges.reserve(edge_count);
+
+    for(const Entry& output : outputs) {
+        for(auto input = std::lower_bound(inputs.begin(), inputs.end(), output, source_less);
+                input != inputs.end() && input->source == output.source; ++input) {
+
+            if(input->logic != output.logic) {
+                edges.push_back({output.logic, input->logic});
+            }
+        }
+    }
+
+    Scratch_vector<uint16_t> position(count, count);
+    Scratch_vector<Logic_interface*> ordered;
+    ordered.reserve(count);
+
+    for(uint16_t placed = 0; placed < count; placed++) {
+        uint16_t next = count;
+
+        for(uint16_t i = 0; i < count; i++) {
+            if(count == position[i]) {
+                if(0 == in_degree[i]) {
+                    next = i;
+                    break;
+                }
+                else if(count == next) {
+                    next = i;   // First unplaced, used if all are in a cycle
+                }
+            }
+        }
+
+        position[next] = placed;
+        ordered.push_back(logic_functions_[next]);
+
+        for(const Edge& edge : edges) {
+            if(edge.from == next && in_degree[edge.to]) {
+                in_degree[edge.to]--;
+            }
+        }
+    }
+
+    // Reorder in place, as the storage is held to the end of the program
+    std::copy(ordered.begin(), ordered.end(), logic_functions_.begin());
+
+#if MR_SIGNALS_LOOP_TIMING
+    Scratch_vector<Timing_slot> timing_slots(count);
+
+    for(uint16_t i = 0; i < count; i++) {
+        timing_slots[position[i]] = timing_slots_[i];
+    }
+
+    std::copy(timing_slots.begin(), timing_slots.end(), timing_slots_.begin());
+#endif
+
+    dirty_count_ = 0;
+    polled_count_ = 0;
+
+    for(uint16_t i = 0; i < count; i++) {
+        flags_[position[i]] = flags[i];
+        dirty_count_++;
+
+        if(flags[i] & logic_polled) {
+            polled_count_++;
+        }
+    }
+
+    for(const Entry& input : inputs) {
+        dependents_.push_back({input.source, position[input.logic]});
+    }
+
+    propagate_ = true;
+    set_listener(this);
+}
+
+void Logic_collection::changed(const void* source) {
+    auto dependent = std::lower_bound(dependents_.begin(), dependents_.end(), source,
+            [](const Dependent& entry, const void* key) {
+                return std::less<const void*>()(entry.source, key);
+            });
+
+    for(; dependent != dependents_.end() && dependent->source == source; ++dependent) {
+        mark_dirty(dependent->logic);
+    }
+}
+
+void Logic_collection::mark_dirty(uint16_t logic) {
+    if(!(flags_[logic] & logic_dirty)) {
+        flags_[logic] |= logic_dirty;
+        dirty_count_++;
     }
 }
 
@@ -8,6 +8,9 @@
 #ifndef SRC_BASE_LOGIC_INTERFACE_H_
 #define SRC_BASE_LOGIC_INTERFACE_H_
 
+#include <cstddef>
+#include "static_vector.h"
+
 
 namespace mr_signals {
 
@@ -23,6 +26,43 @@ namespace mr_signals {
  */
 
 class Logic_collection;
+class Sensor_interface;
+class Head_interface;
+
+
+/// Sensors read by a logic, held by the logic or by the class derived from it
+typedef Array_view<Sensor_interface*> Sensor_list;
+
+
+/**
+ * Storage for up to N sensors inside a logic object, for the Static_ logic
+ * variants.  Inherited ahead of the logic class so that it is constructed
+ * before the logic is given its Sensor_list.
+ */
+template <std::size_t N>
+struct Sensor_storage {
+    template <std::size_t M>
+    Sensor_storage(Sensor_interface* const (&sensors)[M]) : sensors_(sensors) {}
+
+    Static_vector<Sensor_interface*, N> sensors_;
+};
+
+
+/**
+ * Receives the sensors and heads that a logic reads (inputs) and sets
+ * (outputs), so that Logic_collection can evaluate the logic only when one of
+ * its inputs changes
+ */
+class Logic_dependencies {
+public:
+    virtual void input(const Sensor_interface& sensor) = 0;
+    virtual void input(const Head_interface& head) = 0;
+    virtual void output(const Sensor_interface& sensor) = 0;
+    virtual void output(const Head_interface& head) = 0;
+
+    virtual ~Logic_dependencies() = default;
+};
+
 
 class Logic_interface {
 public:
@@ -33,6 +73,20 @@ public:
 
     virtual void loop() = 0;
 
+    /**
+     * List every sensor and head that loop() reads or sets
+     * @return false if the logic cannot list them, in which case it is
+     *         evaluated on every loop
+     */
+    virtual bool list_dependencies(Logic_dependencies&) const { return false; }
+
+    /**
+     * Indicates whether the last loop() left its outputs as the logic
+     * requires.  If not (e.g. a head did not accept its new aspect), the logic
+     * is evaluated again on the next loop even if no input changes.
+     */
+    virtual bool is_settled() const { return true; }
+
     virtual ~Logic_interface () = default;
 
 };
@@ -7,9 +7,126 @@
 
 #include "../loop_funcs.h"
 
-Loop_interface::Loop_interface(Loop_collection &collection) {
+#ifndef ARDUINO
+#include "arduino_mock.h"   // millis(), micros() for unit tests not on Arduino
+#else
+#include "Arduino.h"
+#endif
+
+Loop_interface::Loop_interface(Loop_collection &collection) :
+    next_due_ms_(0), period_ms_(0), priority_(0), overruns_(0)
+{
+    collection.attach(this);
+}
+
+Loop_interface::Loop_interface(Loop_collection &collection, uint16_t period_ms, uint8_t priority) :
+    next_due_ms_(0), period_ms_(period_ms), priority_(priority), overruns_(0)
+{
     collection.attach(this);
 }
 
 
+Loop_collection::Loop_collection(const collec_size size, const uint16_t budget_us) :
+    Collection_base(size, "loop"), budget_us_(budget_us), budget_overruns_(0)
+{
+    rr_offset_.reserve(size);
+}
+
+/// Insert after the tasks of the same or higher priority so that each
+/// priority is contiguous and keeps its attach order
+void Loop_collection::attach(Loop_interface* obj)
+{
+    auto position = collected_objects_.begin();
+
+    while(position != collected_objects_.end() && (*position)->priority_ >= obj->priority_) {
+        ++position;
+    }
+
+#if MR_SIGNALS_LOOP_TIMING
+    timing_slots_.insert(timing_slots_.begin() + (position - collected_objects_.begin()),
+                         mr_signals::Loop_timing::add(obj, timing_label_));
+#endif
+
+    collected_objects_.insert(position, obj);
+    rr_offset_.assign(collected_objects_.size(), 0);
+}
+
+void Loop_collection::execute()
+{
+#if MR_SIGNALS_LOOP_TIMING
+    mr_signals::Loop_timing::pass();
+#endif
+
+    const uint32_t now_ms = millis();
+    const unsigned long start_us = micros();
+
+    for(collec_size i = 0; i < collected_objects_.size(); i++) {
+        if(0 == collected_objects_[i]->period_ms_) {
+#if MR_SIGNALS_LOOP_TIMING
+            mr_signals::Loop_timer timer(timing_slots_[i]);
+#endif
+            collected_objects_[i]->loop();
+        }
+    }
 
+    const collec_size count = collected_objects_.size();
+    bool ran_periodic = false;
+    bool out_of_budget = false;
+
+    for(collec_size first = 0, end = 0; first < count && !out_of_budget; first = end) {
+
+        // Tasks [first, end) share a priority
+        for(end = first + 1; end < count && collected_objects_[end]->priority_ == collected_objects_[first]->priority_; end++) {}
+
+        const collec_size group_size = end - first;
+        const collec_size start = rr_offset_[first];
+
+        for(collec_size i = 0; i < group_size; i++) {
+            collec_size index = first + (start + i) % group_size;
+            Loop_interface* obj = collected_objects_[index];
+
+            if(0 == obj->period_ms_) {
+                continue;
+            }
+
+            if(obj->next_due_ms_ && (int32_t)(now_ms - obj->next_due_ms_) < 0) {
+                continue;   // Not yet due
+            }
+
+            if(ran_periodic && budget_us_ && (micros() - start_us) >= budget_us_) {
+                out_of_budget = true;
+                break;
+            }
+
+            {
+#if MR_SIGNALS_LOOP_TIMING
+                mr_signals::Loop_timer timer(timing_slots_[index]);
+#endif
+                obj->loop();
+            }
+            ran_periodic = true;
+
+            // Start the next round-robin after this task
+            rr_offset_[first] = (index - first + 1) % group_size;
+
+            if(0 == obj->next_due_ms_) {
+                obj->next_due_ms_ = now_ms + obj->period_ms_;
+            }
+            else {
+                obj->next_due_ms_ += obj->period_ms_;
+
+                if((int32_t)(now_ms - obj->next_due_ms_) >= 0) {
+                    // A whole period was missed; don't try to catch up
+                    if(obj->overruns_ < UINT16_MAX) {
+                        obj->overruns_++;
+                    }
+                    obj->next_due_ms_ = now_ms + obj->period_ms_;
+                }
+            }
+        }
+    }
+
+    if(out_of_budget && budget_overruns_ < UINT16_MAX) {
+        budget_overruns_++;
+    }
+}
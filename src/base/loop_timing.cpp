@@ -0,0 +1,230 @@
+/*
+ * loop_timing.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "loop_timing.h"
+#include "mr_signals.h"
+
+#ifndef ARDUINO
+#include "arduino_mock.h"   // micros() for unit tests not on Arduino
+#endif
+
+namespace mr_signals {
+
+
+// Define static constant members for external use
+const uint8_t     Timing_stats::buckets;
+const Timing_slot Loop_timing::capacity;
+const Timing_slot Loop_timing::no_slot;
+
+Loop_timing::Entry Loop_timing::entries_[Loop_timing::capacity];
+Timing_slot Loop_timing::size_ = 0;
+uint16_t Loop_timing::untimed_ = 0;
+Timing_stats Loop_timing::period_;
+Timing_stats Loop_timing::jitter_;
+uint32_t Loop_timing::last_pass_us_ = 0;
+uint32_t Loop_timing::last_period_us_ = 0;
+uint8_t Loop_timing::passes_ = 0;
+
+
+namespace {
+
+void print_stats(Trace_output& out, const Timing_stats& stats)
+{
+    out << F(" n=") << stats.count() << F(" min=") << stats.min() << F(" mean=") << stats.mean()
+        << F(" max=") << stats.max() << F(" hist=");
+
+    for(uint8_t bucket = 0; bucket < Timing_stats::buckets; bucket++) {
+        out << stats.histogram(bucket) << (bucket + 1 < Timing_stats::buckets ? F(",") : F("\n"));
+    }
+}
+
+}
+
+
+void Timing_stats::add(const uint32_t us)
+{
+    if(0 == count_ || us < min_) {
+        min_ = us;
+    }
+
+    if(us > max_) {
+        max_ = us;
+    }
+
+    if(total_ + us < total_) {
+        total_ /= 2;
+        count_ /= 2;
+    }
+
+    total_ += us;
+    count_++;
+
+    uint16_t& bucket_count = histogram_[bucket(us)];
+    if(bucket_count < UINT16_MAX) {
+        bucket_count++;
+    }
+}
+
+void Timing_stats::reset()
+{
+    *this = Timing_stats();
+}
+
+uint8_t Timing_stats::bucket(uint32_t us)
+{
+    uint8_t bucket = 0;
+
+    while(us > 1 && bucket < buckets - 1) {
+        us >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+
+///////////////////////////////////////////////////
+
+
+Timing_slot Loop_timing::add(const void* object, const char* label, Timing_name name)
+{
+    if(size_ >= capacity) {
+        if(untimed_ < UINT16_MAX) {
+            untimed_++;
+        }
+
+        return no_slot;
+    }
+
+    entries_[size_].object = object;
+    entries_[size_].label = label;
+    entries_[size_].name = name;
+    entries_[size_].stats.reset();
+
+    return size_++;
+}
+
+void Loop_timing::record(const Timing_slot slot, const uint32_t us)
+{
+    if(slot < size_) {
+        entries_[slot].stats.add(us);
+    }
+}
+
+void Loop_timing::pass()
+{
+    const uint32_t now = now_us();
+
+    if(passes_) {
+        const uint32_t period = now - last_pass_us_;
+
+        period_.add(period);
+
+        if(passes_ > 1) {
+            jitter_.add(period > last_period_us_ ? period - last_period_us_ : last_period_us_ - period);
+        }
+        else {
+            passes_++;
+        }
+
+        last_period_us_ = period;
+    }
+    else {
+        passes_++;
+    }
+
+    last_pass_us_ = now;
+}
+
+const Loop_timing::Entry* Loop_timing::get(const Timing_slot slot)
+{
+    return slot < size_ ? &entries_[slot] : nullptr;
+}
+
+/// Insertion sort; the number of objects is small and this is not on the hot path
+Timing_slot Loop_timing::top(Timing_slot* slots, const Timing_slot max_slots)
+{
+    Timing_slot count = 0;
+
+    for(Timing_slot slot = 0; slot < size_; slot++) {
+        const uint32_t max = entries_[slot].stats.max();
+
+        Timing_slot position = count;
+        while(position > 0 && entries_[slots[position - 1]].stats.max() < max) {
+            position--;
+        }
+
+        if(position >= max_slots) {
+            continue;
+        }
+
+        Timing_slot last = (count < max_slots) ? count++ : max_slots - 1;
+        for(; last > position; last--) {
+            slots[last] = slots[last - 1];
+        }
+
+        slots[position] = slot;
+    }
+
+    return count;
+}
+
+void Loop_timing::report(Trace_output& out, const Timing_slot max_entries)
+{
+    out << F("Loop period us:");
+    print_stats(out, period_);
+
+    out << F("Loop jitter us:");
+    print_stats(out, jitter_);
+
+    Timing_slot slots[capacity];
+    Timing_slot count = top(slots, max_entries < capacity ? max_entries : capacity);
+
+    for(Timing_slot i = 0; i < count; i++) {
+        const Entry& entry = entries_[slots[i]];
+
+        const char* name = entry.name ? entry.name(entry.object) : nullptr;
+
+        out << entry.label << F(" #") << (unsigned)slots[i];
+
+        if(name && name[0]) {
+            out << F(" ") << name;
+        }
+
+        out << F(" us:");
+        print_stats(out, entry.stats);
+    }
+
+    if(untimed_) {
+        out << F("!!Not timed (MR_SIGNALS_LOOP_TIMING_ENTRIES full): ") << (unsigned)untimed_ << F(" objects\n");
+    }
+}
+
+void Loop_timing::reset()
+{
+    for(Timing_slot slot = 0; slot < size_; slot++) {
+        entries_[slot].stats.reset();
+    }
+
+    period_.reset();
+    jitter_.reset();
+    passes_ = 0;
+}
+
+void Loop_timing::clear()
+{
+    reset();
+    size_ = 0;
+    untimed_ = 0;
+}
+
+uint32_t Loop_timing::now_us()
+{
+    return micros();
+}
+
+
+}   // namespace mr_signals
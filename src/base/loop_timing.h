@@ -0,0 +1,170 @@
+/*
+ * loop_timing.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_LOOP_TIMING_H_
+#define SRC_BASE_LOOP_TIMING_H_
+
+#include <stdint.h>
+
+#include "../mr_signals_config.h"    // MR_SIGNALS_LOOP_TIMING
+#include "trace.h"                  // Trace_output
+
+namespace mr_signals {
+
+typedef uint8_t Timing_slot;
+
+/// Gives the name of a timed object for reports (e.g. the head a logic
+/// protects), or nullptr if it has none
+typedef const char* (*Timing_name)(const void* object);
+
+
+/**
+ * Running statistics of a duration in microseconds: count, min, max, mean
+ * and a log2 histogram
+ *
+ * Histogram bucket 0 counts durations below 2us, bucket b (1 to buckets-2)
+ * durations of 2^b to 2^(b+1)-1 us and the last bucket everything longer.
+ * Bucket counts saturate.  If the total overflows, the total and count are
+ * halved, which keeps the mean.
+ */
+class Timing_stats {
+public:
+
+    static const uint8_t buckets = 12;
+
+    constexpr Timing_stats() : count_(0), total_(0), min_(0), max_(0), histogram_{} {}
+
+    void add(const uint32_t us);
+
+    void reset();
+
+    uint32_t count() const { return count_; }
+    uint32_t min() const { return min_; }
+    uint32_t max() const { return max_; }
+    uint32_t mean() const { return count_ ? total_ / count_ : 0; }
+    uint16_t histogram(const uint8_t bucket) const { return bucket < buckets ? histogram_[bucket] : 0; }
+
+    /// Bucket that a duration is counted in
+    static uint8_t bucket(uint32_t us);
+
+private:
+    uint32_t count_;
+    uint32_t total_;
+    uint32_t min_;
+    uint32_t max_;
+    uint16_t histogram_[buckets];
+};
+
+
+/**
+ * Registry of the timed objects and of the period of the main loop
+ *
+ * Objects are added as they are attached to a collection (or by the LocoNet
+ * adapter for its phases) when MR_SIGNALS_LOOP_TIMING is 1 (set in
+ * mr_signals_config.h).  Objects beyond the capacity are not timed, but are
+ * counted and reported.  Timing each call costs two micros() reads and a few
+ * additions, so it can be left on in a layout.
+ *
+ * Example, from the sketch's loop()
+ *
+ * if(millis() - last_report > 10000) {
+ *     Loop_timing::report(Serial, 5);     // Slowest 5 objects
+ *     Loop_timing::reset();
+ *     last_report = millis();
+ * }
+ */
+class Loop_timing {
+public:
+
+    static const Timing_slot capacity = MR_SIGNALS_LOOP_TIMING_ENTRIES;
+    static const Timing_slot no_slot = 0xFF;
+
+    struct Entry {
+        const void* object = nullptr;
+        const char* label = nullptr;    /// Kind of object, e.g. "logic"
+        Timing_name name = nullptr;     /// Name of the object, if it has one
+        Timing_stats stats;
+    };
+
+    /**
+     * Add an object to time
+     * @param name  - Gives the object's name when reported; called then, as
+     *                the object may not be fully constructed when added
+     * @return The slot to record its times to, or no_slot if full
+     */
+    static Timing_slot add(const void* object, const char* label, Timing_name name = nullptr);
+
+    /// Record a duration; ignored for no_slot
+    static void record(const Timing_slot slot, const uint32_t us);
+
+    /// Record the start of a pass of the main loop, for its period and jitter
+    static void pass();
+
+    static const Entry* get(const Timing_slot slot);
+
+    /// Number of objects added
+    static Timing_slot size() { return size_; }
+
+    /// Number of objects not added as the capacity was used
+    static uint16_t untimed() { return untimed_; }
+
+    /// Time between passes of the main loop
+    static const Timing_stats& period() { return period_; }
+
+    /// Change in the period from one pass to the next
+    static const Timing_stats& jitter() { return jitter_; }
+
+    /**
+     * The slots of the objects with the longest maximum time, longest first
+     * @param slots     - Filled with up to max_slots slots
+     * @return The number of slots filled
+     */
+    static Timing_slot top(Timing_slot* slots, const Timing_slot max_slots);
+
+    /// Print the loop period, jitter, the max_entries slowest objects and the number not timed
+    static void report(Trace_output& out, const Timing_slot max_entries);
+
+    /// Clear all of the statistics, keeping the objects
+    static void reset();
+
+    /// Remove all of the objects (for tests)
+    static void clear();
+
+    /// micros() for Loop_timer
+    static uint32_t now_us();
+
+private:
+    static Entry entries_[capacity];
+    static Timing_slot size_;
+    static uint16_t untimed_;
+
+    static Timing_stats period_;
+    static Timing_stats jitter_;
+    static uint32_t last_pass_us_;
+    static uint32_t last_period_us_;
+    static uint8_t passes_;         // Up to 2, for the first period and jitter
+};
+
+
+/**
+ * Records the time from construction to destruction to a slot
+ */
+class Loop_timer {
+public:
+    explicit Loop_timer(const Timing_slot slot) : slot_(slot), start_us_(Loop_timing::now_us()) {}
+
+    ~Loop_timer() { Loop_timing::record(slot_, Loop_timing::now_us() - start_us_); }
+
+private:
+    Timing_slot slot_;
+    uint32_t start_us_;
+};
+
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_BASE_LOOP_TIMING_H_ */
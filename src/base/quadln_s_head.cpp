@@ -31,20 +31,22 @@ bool Quadln_s_head::request_outputs(const Head_aspect aspect)
     // Assume failure as the default
     bool result = false;
 
+    const Switch_priority priority = is_restricting() ? Switch_priority::urgent : Switch_priority::normal;
+
     switch (aspect) {
     case Head_aspect::green:
-        if (true == switch_1_.request_direction(Switch_direction::thrown)) {
-            result = switch_2_.request_direction(Switch_direction::closed);
+        if (true == switch_1_.request_direction(Switch_direction::thrown, priority)) {
+            result = switch_2_.request_direction(Switch_direction::closed, priority);
         }
         break;
 
     case Head_aspect::yellow:
-        result = switch_2_.request_direction(Switch_direction::thrown);
+        result = switch_2_.request_direction(Switch_direction::thrown, priority);
         break;
 
     case Head_aspect::red:
-        if (true == switch_1_.request_direction(Switch_direction::closed)) {
-            result = switch_2_.request_direction(Switch_direction::closed);
+        if (true == switch_1_.request_direction(Switch_direction::closed, priority)) {
+            result = switch_2_.request_direction(Switch_direction::closed, priority);
         }
         break;
 
@@ -0,0 +1,19 @@
+/*
+ * runtime_ms.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_RUNTIME_MS_H_
+#define SRC_BASE_RUNTIME_MS_H_
+
+#include <stdint.h>
+
+namespace mr_signals {
+
+/// Time since startup in milliseconds, as returned by millis()
+typedef uint32_t Runtime_ms;
+
+}   // namespace mr_signals
+
+#endif /* SRC_BASE_RUNTIME_MS_H_ */
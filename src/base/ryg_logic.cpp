@@ -8,6 +8,8 @@
 #include <ryg_logic.h>
 #include "mr_signals.h"
 #include "algorithm.h"
+#include "trace.h"
+#include "startup_arena.h"
 
 using namespace mr_signals;
 
@@ -23,7 +25,7 @@ Simple_ryg_logic::Simple_ryg_logic(Logic_collection& collection,
         std::initializer_list<Sensor_interface *> const & protected_sensors) :
         Logic_interface(collection),
         head_(head), protected_head_(&protected_head), protected_sensors_(
-                protected_sensors)
+                arena_copy(protected_sensors, Arena_use::logic_sensors)), owns_sensors_(true), pending_(false)
 {
 
 }
@@ -34,11 +36,30 @@ Simple_ryg_logic::Simple_ryg_logic(Logic_collection& collection,
         std::initializer_list<Sensor_interface *> const & protected_sensors) :
         Logic_interface(collection),
         head_(head), protected_head_(nullptr), protected_sensors_(
-                protected_sensors)
+                arena_copy(protected_sensors, Arena_use::logic_sensors)), owns_sensors_(true), pending_(false)
 {
 
 }
 
+// Protected sensors held by the derived class
+Simple_ryg_logic::Simple_ryg_logic(Logic_collection& collection,
+        Head_interface& head,
+        Head_interface* protected_head,
+        Sensor_list protected_sensors) :
+        Logic_interface(collection),
+        head_(head), protected_head_(protected_head), protected_sensors_(
+                protected_sensors), owns_sensors_(false), pending_(false)
+{
+
+}
+
+Simple_ryg_logic::~Simple_ryg_logic()
+{
+    if(owns_sensors_) {
+        arena_delete(protected_sensors_.begin(), protected_sensors_.size(), Arena_use::logic_sensors);
+    }
+}
+
 /**
  * Aspect logic for a 3 aspect (red, yellow & green) head that protects
  * sensors and may protect another head
@@ -57,6 +78,8 @@ void Simple_ryg_logic::loop()
 
     head_.loop();
 
+    pending_ = false;
+
     // Check that the state of all protected sensors are known
     if (std::none_of(protected_sensors_.begin(),
                     protected_sensors_.end(),
@@ -103,12 +126,33 @@ void Simple_ryg_logic::loop()
             Head_aspect orig_aspect = head_.get_aspect();
 
             if (head_.request_aspect(aspect) == true) {
-                Serial << head_.get_name() << F(" (") << orig_aspect << F(") new aspect : (") << aspect << F(")\n");
+                uint8_t aspects[2] = { (uint8_t)orig_aspect, (uint8_t)aspect };
+                trace_named(Trace_event::aspect_change, head_.get_name(), aspects, 2);
+            }
+            else if (!head_.is_held()) {
+                // Try again on the next loop; a held head is released
+                // (and so retried) by a change to the logic's inputs
+                pending_ = true;
             }
         }
     }
 }
 
+bool Simple_ryg_logic::list_dependencies(Logic_dependencies& dependencies) const
+{
+    for(Sensor_interface* sensor : protected_sensors_) {
+        dependencies.input(*sensor);
+    }
+
+    if(nullptr != protected_head_) {
+        dependencies.input(*protected_head_);
+    }
+
+    dependencies.output(head_);
+
+    return true;
+}
+
 
 
 Interlocked_ryg_logic::Interlocked_ryg_logic(Logic_collection& collection,
@@ -144,6 +188,18 @@ Interlocked_ryg_logic::Interlocked_ryg_logic(Logic_collection& collection,
 }
 
 
+Interlocked_ryg_logic::Interlocked_ryg_logic(Logic_collection& collection,
+        Head_interface& head,
+        Head_interface* protected_head,
+        Sensor_interface& lever,
+        Sensor_interface* automated_lever,
+        Sensor_list protected_sensors) :
+        Simple_ryg_logic(collection, head, protected_head, protected_sensors),
+        lever_(lever), automated_lever_(automated_lever)
+{
+}
+
+
 /**
  * Aspect logic for a Red/Yellow/Green head that is controlled by a lever
  * in an interlocking tower.
@@ -159,6 +215,8 @@ Interlocked_ryg_logic::Interlocked_ryg_logic(Logic_collection& collection,
  */
 void Interlocked_ryg_logic::loop()
 {
+    pending_ = false;
+
     if(!lever_.is_indeterminate()) {
         if(lever_.is_active()) {
             // Lever is reversed
@@ -182,7 +240,7 @@ void Interlocked_ryg_logic::loop()
                 if(false == is_automated ) {
 
                     if(false==head_.is_held()) {
-                        Serial << head_.get_name() << F(" held at red\n");
+                        trace_named(Trace_event::head_held, head_.get_name());
                     }
 
                     head_.set_held(true);
@@ -201,16 +259,30 @@ void Interlocked_ryg_logic::loop()
 
             if (Head_aspect::red != head_.get_aspect()) {
 
-                Serial << head_.get_name() << F(" lever normal; set to red\n");
+                trace_named(Trace_event::lever_normal, head_.get_name());
 
                 if(head_.request_aspect(Head_aspect::red)) {
-                    Serial << F("(Accepted)\n");
+                    trace(Trace_event::aspect_accepted);
+                }
+                else {
+                    pending_ = true;
                 }
             }
         }
     }
 }
 
+bool Interlocked_ryg_logic::list_dependencies(Logic_dependencies& dependencies) const
+{
+    dependencies.input(lever_);
+
+    if(nullptr != automated_lever_) {
+        dependencies.input(*automated_lever_);
+    }
+
+    return Simple_ryg_logic::list_dependencies(dependencies);
+}
+
 
 
 /**
@@ -0,0 +1,139 @@
+/*
+ * sensor_state_store.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "sensor_state_store.h"
+
+namespace mr_signals {
+
+
+// Define static constant members for external use
+const uint8_t     Sensor_set::word_bits;
+const uint16_t    Sensor_set::word_count;
+const Sensor_slot Sensor_state_store::capacity;
+const Sensor_slot Sensor_state_store::no_slot;
+
+
+Sensor_set::Sensor_set()
+{
+    for(uint16_t word = 0; word < word_count; word++) {
+        bits_[word] = 0;
+    }
+}
+
+void Sensor_set::add(const Sensor_slot slot)
+{
+    if(slot < Sensor_state_store::capacity) {
+        bits_[slot / word_bits] |= (Sensor_word)1 << (slot % word_bits);
+    }
+}
+
+bool Sensor_set::contains(const Sensor_slot slot) const
+{
+    if(slot < Sensor_state_store::capacity) {
+        return (bits_[slot / word_bits] >> (slot % word_bits)) & 1;
+    }
+
+    return false;
+}
+
+
+///////////////////////////////////////////////////
+
+
+Sensor_state_store::Sensor_state_store() : size_(0), indeterminate_count_(0)
+{
+    for(uint16_t word = 0; word < Sensor_set::word_count; word++) {
+        active_[word] = 0;
+        indeterminate_[word] = 0;
+    }
+}
+
+Sensor_slot Sensor_state_store::add()
+{
+    if(size_ >= capacity) {
+        return no_slot;
+    }
+
+    Sensor_slot slot = size_++;
+
+    indeterminate_[slot / Sensor_set::word_bits] |= mask(slot);
+    indeterminate_count_++;
+
+    return slot;
+}
+
+bool Sensor_state_store::set_state(const Sensor_slot slot, const bool state)
+{
+    if(slot >= size_) {
+        return false;
+    }
+
+    bool changed = false;
+
+    Sensor_word& active = active_[slot / Sensor_set::word_bits];
+    Sensor_word& indeterminate = indeterminate_[slot / Sensor_set::word_bits];
+
+    // Once set, the state is no longer indeterminate
+    if(indeterminate & mask(slot)) {
+        indeterminate &= ~mask(slot);
+        indeterminate_count_--;
+        changed = true;
+    }
+
+    if(state != (bool)(active & mask(slot))) {
+        active ^= mask(slot);
+        changed = true;
+    }
+
+    return changed;
+}
+
+bool Sensor_state_store::is_active(const Sensor_slot slot) const
+{
+    if(slot >= size_) {
+        return false;
+    }
+
+    return (active_[slot / Sensor_set::word_bits] & mask(slot)) ? true : false;
+}
+
+bool Sensor_state_store::is_indeterminate(const Sensor_slot slot) const
+{
+    if(slot >= size_) {
+        return true;
+    }
+
+    return (indeterminate_[slot / Sensor_set::word_bits] & mask(slot)) ? true : false;
+}
+
+bool Sensor_state_store::any_active(const Sensor_set& set) const
+{
+    const Sensor_word* bits = set.words();
+
+    for(uint16_t word = 0; word < Sensor_set::word_count; word++) {
+        if(active_[word] & bits[word]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Sensor_state_store::any_indeterminate(const Sensor_set& set) const
+{
+    const Sensor_word* bits = set.words();
+
+    for(uint16_t word = 0; word < Sensor_set::word_count; word++) {
+        if(indeterminate_[word] & bits[word]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+}   // namespace mr_signals
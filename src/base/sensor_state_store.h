@@ -0,0 +1,109 @@
+/*
+ * sensor_state_store.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_SENSOR_STATE_STORE_H_
+#define SRC_BASE_SENSOR_STATE_STORE_H_
+
+#include <stdint.h>
+
+#include "../mr_signals_config.h"  // MR_SIGNALS_SENSOR_STORE_CAPACITY
+
+namespace mr_signals {
+
+/// Native word of the bitsets (16 bits on AVR)
+typedef unsigned int Sensor_word;
+
+typedef uint16_t Sensor_slot;
+
+
+/**
+ * Set of slots in a Sensor_state_store, for bulk queries
+ */
+class Sensor_set {
+public:
+
+    static const uint8_t word_bits = sizeof(Sensor_word) * 8;
+    static const uint16_t word_count = (MR_SIGNALS_SENSOR_STORE_CAPACITY + word_bits - 1) / word_bits
+                                       + (MR_SIGNALS_SENSOR_STORE_CAPACITY ? 0 : 1);
+
+    Sensor_set();
+
+    /// Adds a slot; no effect for a slot beyond the capacity
+    void add(const Sensor_slot slot);
+
+    bool contains(const Sensor_slot slot) const;
+
+    const Sensor_word* words() const { return bits_; }
+
+private:
+    Sensor_word bits_[word_count];
+};
+
+
+/**
+ * Holds the active and indeterminate states of sensors as packed bitsets,
+ * indexed by a slot allocated to each sensor
+ *
+ * A running count of the indeterminate sensors makes "are all states known"
+ * a single comparison, and queries over a Sensor_set are done a word at a
+ * time.  The active bit of an indeterminate sensor is always clear.
+ */
+class Sensor_state_store {
+public:
+
+    static const Sensor_slot capacity = MR_SIGNALS_SENSOR_STORE_CAPACITY;
+    static const Sensor_slot no_slot = 0xFFFF;
+
+    Sensor_state_store();
+
+    /**
+     * Allocate the next slot, with the state indeterminate
+     * @return The slot, or no_slot if the store is full
+     */
+    Sensor_slot add();
+
+    /**
+     * Set the state of a slot
+     * @param slot  - Slot returned by add()
+     * @param state - true/false = active/inactive
+     * @return true if the state changed (including from indeterminate)
+     */
+    bool set_state(const Sensor_slot slot, const bool state);
+
+    bool is_active(const Sensor_slot slot) const;
+
+    bool is_indeterminate(const Sensor_slot slot) const;
+
+    /// Number of slots allocated
+    Sensor_slot size() const { return size_; }
+
+    /// Number of allocated slots whose state is not yet known
+    Sensor_slot indeterminate_count() const { return indeterminate_count_; }
+
+    /// true if any sensor in the set is active
+    bool any_active(const Sensor_set& set) const;
+
+    /// true if the state of any sensor in the set is not yet known
+    bool any_indeterminate(const Sensor_set& set) const;
+
+private:
+
+    static Sensor_word mask(const Sensor_slot slot) {
+        return (Sensor_word)1 << (slot % Sensor_set::word_bits);
+    }
+
+    Sensor_word active_[Sensor_set::word_count];
+    Sensor_word indeterminate_[Sensor_set::word_count];
+
+    Sensor_slot size_;
+    Sensor_slot indeterminate_count_;
+};
+
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_BASE_SENSOR_STATE_STORE_H_ */
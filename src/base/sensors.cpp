@@ -6,6 +6,7 @@
  */
 
 #include <sensor_interface.h>
+#include "change_listener.h"
 
 using namespace mr_signals;
 
@@ -43,6 +44,10 @@ bool Sensor_base::set_state(const bool state)
     // Once set, the state is no longer indeterminate
     indeterminate_ = sensor_inactive;
 
+    if(changed) {
+        Change_listener::notify(static_cast<const Sensor_interface*>(this));
+    }
+
     return changed;
 }
 
@@ -75,6 +80,11 @@ bool Inverted_sensor::is_indeterminate() const
     return sensor_.is_indeterminate();
 }
 
+const void* Inverted_sensor::change_source() const
+{
+    return sensor_.change_source();
+}
+
 
 
 
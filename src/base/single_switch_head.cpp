@@ -22,15 +22,17 @@ bool Single_switch_head::request_outputs(const Head_aspect aspect)
 {
     bool result = false;
 
+    const Switch_priority priority = is_restricting() ? Switch_priority::urgent : Switch_priority::normal;
+
     switch (aspect) {
     case Head_aspect::dark:          // Close (turn off) the switch for dark & red
     case Head_aspect::red:
-        result = switch_1_.request_direction(Switch_direction::closed);
+        result = switch_1_.request_direction(Switch_direction::closed, priority);
         break;
 
     case Head_aspect::yellow:        // Throw (turn on) the switch for other valid aspects
     case Head_aspect::green:
-        result = switch_1_.request_direction(Switch_direction::thrown);
+        result = switch_1_.request_direction(Switch_direction::thrown, priority);
         break;
 
     case Head_aspect::unknown:       // Take no action if the state is invalid or unknown
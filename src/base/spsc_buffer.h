@@ -0,0 +1,192 @@
+/*
+ * spsc_buffer.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_SPSC_BUFFER_H_
+#define SRC_BASE_SPSC_BUFFER_H_
+
+#include <cstddef>      // std::size_t
+#include <stdint.h>     // uint8_t
+
+#ifndef ARDUINO
+#include <atomic>       // Host builds run producer and consumer on separate threads
+#endif
+
+
+/**
+ * Index shared between the producer and consumer of an Spsc_buffer
+ *
+ * Each index is written by only one side.  A store_release() makes the
+ * element accesses before it visible before the new index value, and a
+ * load_acquire() keeps the element accesses after it from being moved
+ * ahead of the read.
+ *
+ * On AVR the index is a single byte, so loads and stores cannot tear even when
+ * interrupted; a compiler barrier provides the ordering (the core does not
+ * re-order memory accesses).  Host builds use std::atomic so that the
+ * ordering also holds across threads and can be checked with TSAN.
+ */
+class Spsc_index {
+public:
+    Spsc_index() : value_(0) {}
+
+#ifdef ARDUINO
+
+    uint8_t load_acquire() const {
+        uint8_t value = value_;
+        __asm__ __volatile__("" ::: "memory");
+        return value;
+    }
+
+    void store_release(const uint8_t value) {
+        __asm__ __volatile__("" ::: "memory");
+        value_ = value;
+    }
+
+    /// Read by the side that owns (writes) the index; no ordering needed
+    uint8_t load_owned() const {
+        return value_;
+    }
+
+private:
+    volatile uint8_t value_;
+
+#else
+
+    uint8_t load_acquire() const {
+        return value_.load(std::memory_order_acquire);
+    }
+
+    void store_release(const uint8_t value) {
+        value_.store(value, std::memory_order_release);
+    }
+
+    /// Read by the side that owns (writes) the index; no ordering needed
+    uint8_t load_owned() const {
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint8_t> value_;
+
+#endif
+};
+
+
+/**
+ * Lock-free single producer, single consumer FIFO
+ *
+ * For passing events from an interrupt handler (or the LocoNet receive path)
+ * to loop() without disabling interrupts.  Exactly one context may call
+ * push() and exactly one (other) context may call pop(); unlike
+ * Circular_buffer there is no shared element count.
+ *
+ * The head and tail indexes run freely over 0..255 and are masked to index
+ * the storage, so the element count is always tail - head (mod 256).  This
+ * limits the capacity to 128 elements.  The count of dropped elements is held
+ * in an Spsc_index as well, so it can be read by the consumer; it saturates
+ * at 255.
+ *
+ * Example
+ *
+ * Spsc_buffer<uint16_t, 32> pin_events;
+ *
+ * ISR(PCINT0_vect) { pin_events.push(PINB); }      // Producer
+ *
+ * void loop() {                                    // Consumer
+ *     uint16_t event;
+ *     while(pin_events.pop(event)) { ... }
+ * }
+ *
+ * @param T Element type (copied in and out by value)
+ * @param N Capacity in elements; must be a power of two from 2 to 128
+ */
+template <class T, std::size_t N>
+class Spsc_buffer {
+
+    static_assert(N >= 2 && N <= 128, "Spsc_buffer capacity must be from 2 to 128");
+    static_assert((N & (N - 1)) == 0, "Spsc_buffer capacity must be a power of two");
+
+public:
+    Spsc_buffer() {}
+
+    /**
+     * Producer only: add an element
+     *
+     * @return true if the element was added, false if the buffer was full (the
+     *         element is dropped and counted in overflows())
+     */
+    bool push(const T& element) {
+        uint8_t tail = tail_.load_owned();
+
+        if(static_cast<uint8_t>(tail - head_.load_acquire()) >= N) {
+            uint8_t overflows = overflows_.load_owned();
+
+            if(overflows < 0xFF) {      // Saturate
+                overflows_.store_release(overflows + 1);
+            }
+            return false;
+        }
+
+        buffer_[tail & index_mask_] = element;
+        tail_.store_release(tail + 1);
+
+        return true;
+    }
+
+    /**
+     * Consumer only: remove the oldest element
+     *
+     * @return true if an element was removed, false if the buffer was empty
+     */
+    bool pop(T& element) {
+        uint8_t head = head_.load_owned();
+
+        if(head == tail_.load_acquire()) {
+            return false;
+        }
+
+        element = buffer_[head & index_mask_];
+        head_.store_release(head + 1);
+
+        return true;
+    }
+
+    /**
+     * Number of elements held.  Exact when called by either side with the
+     * other idle; otherwise a snapshot that may already be out of date.
+     */
+    std::size_t size() const {
+        return static_cast<uint8_t>(tail_.load_acquire() - head_.load_acquire());
+    }
+
+    bool empty() const {
+        return (0 == size());
+    }
+
+    static constexpr std::size_t max_size() {
+        return(N);
+    }
+
+    /// Count of elements dropped because the buffer was full (saturates at 255);
+    /// may be read by either side
+    uint8_t overflows() const {
+        return overflows_.load_acquire();
+    }
+
+
+private:
+    static const uint8_t index_mask_ = N - 1;
+
+    T buffer_[N];
+
+    Spsc_index head_;           // Written by the consumer; next element to remove
+    Spsc_index tail_;           // Written by the producer; next element to insert
+
+    Spsc_index overflows_;      // Written by the producer; elements dropped
+};
+
+
+#endif /* SRC_BASE_SPSC_BUFFER_H_ */
@@ -0,0 +1,194 @@
+/*
+ * startup_arena.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "startup_arena.h"
+#include "mr_signals.h"
+
+namespace mr_signals {
+
+
+uint8_t* Startup_arena::buffer_ = nullptr;
+std::size_t Startup_arena::size_ = 0;
+const uint8_t* Startup_arena::ended_buffer_ = nullptr;
+std::size_t Startup_arena::ended_size_ = 0;
+std::size_t Startup_arena::used_ = 0;
+std::size_t Startup_arena::padding_ = 0;
+bool Startup_arena::sealed_ = false;
+
+Startup_arena::Usage Startup_arena::usage_[(uint8_t)Arena_use::max_arena_use] = {};
+uint16_t Startup_arena::overflows_ = 0;
+uint32_t Startup_arena::overflow_bytes_ = 0;
+uint16_t Startup_arena::late_allocations_ = 0;
+uint16_t Startup_arena::late_releases_ = 0;
+
+uint8_t Startup_arena::empty_ = 0;
+
+
+void Startup_arena::begin(uint8_t* buffer, std::size_t size)
+{
+    buffer_ = buffer;
+    size_ = size;
+    used_ = 0;
+    padding_ = 0;
+    sealed_ = false;
+
+    for(Usage& usage : usage_) {
+        usage = Usage();
+    }
+
+    overflows_ = 0;
+    overflow_bytes_ = 0;
+    late_allocations_ = 0;
+    late_releases_ = 0;
+}
+
+void Startup_arena::end()
+{
+    // Kept for the rest of the program (and not cleared by begin()), so that
+    // storage released after the buffer is not taken as the heap's
+    if(nullptr != buffer_) {
+        ended_buffer_ = buffer_;
+        ended_size_ = size_;
+    }
+
+    begin(nullptr, 0);
+}
+
+void* Startup_arena::allocate(std::size_t bytes, std::size_t alignment, Arena_use use)
+{
+    Usage& usage = usage_[(uint8_t)use];
+
+    usage.allocations++;
+
+    if(0 == bytes) {
+        return &empty_;
+    }
+
+    if(sealed_) {
+        late_allocations_++;
+
+        uint8_t payload[3] = { (uint8_t)use, (uint8_t)bytes, (uint8_t)(bytes >> 8) };
+        trace(Trace_event::arena_late_alloc, payload, sizeof(payload));
+    }
+    else if(nullptr != buffer_) {
+        const std::size_t align_mask = alignment - 1;
+        const std::size_t pad = (alignment - ((uintptr_t)(buffer_ + used_) & align_mask)) & align_mask;
+
+        if(pad + bytes <= size_ - used_) {
+            padding_ += pad;
+            used_ += pad;
+
+            void* storage = buffer_ + used_;
+            used_ += bytes;
+            usage.arena_bytes += bytes;
+
+            return storage;
+        }
+
+        overflows_++;
+        overflow_bytes_ += bytes;
+    }
+
+    usage.heap_bytes += bytes;
+
+    return ::operator new(bytes);
+}
+
+void Startup_arena::release(void* storage, std::size_t bytes, Arena_use use)
+{
+    if(0 == bytes || nullptr == storage) {
+        return;
+    }
+
+    Usage& usage = usage_[(uint8_t)use];
+
+    if(contains(storage, buffer_, size_)) {
+        usage.arena_bytes -= bytes;
+
+        if(static_cast<uint8_t*>(storage) + bytes == buffer_ + used_) {
+            used_ -= bytes;     // Last drawn, so drawn again next
+        }
+        else {
+            usage.released_bytes += bytes;
+        }
+    }
+    else if(contains(storage, ended_buffer_, ended_size_)) {
+        late_releases_++;   // Drawn before end(); nothing to free
+    }
+    else {
+        // Counts are cleared by end(), so may not include storage drawn before it
+        usage.heap_bytes -= (usage.heap_bytes < bytes) ? usage.heap_bytes : bytes;
+        ::operator delete(storage);
+    }
+}
+
+void Startup_arena::seal()
+{
+    sealed_ = true;
+}
+
+bool Startup_arena::contains(const void* storage, const uint8_t* buffer, std::size_t size)
+{
+    const uintptr_t address = (uintptr_t)storage;
+
+    return nullptr != buffer && address >= (uintptr_t)buffer && address < (uintptr_t)(buffer + size);
+}
+
+void Startup_arena::print_use(Trace_output& out, Arena_use use)
+{
+    switch(use) {
+    case Arena_use::collections:
+        out << F("collections");
+        break;
+    case Arena_use::logic:
+        out << F("logic");
+        break;
+    case Arena_use::logic_sensors:
+        out << F("logic sensors");
+        break;
+    case Arena_use::loconet:
+        out << F("loconet");
+        break;
+    case Arena_use::loop_timing:
+        out << F("loop timing");
+        break;
+    default:
+        out << F("?");
+        break;
+    }
+}
+
+void Startup_arena::report(Trace_output& out)
+{
+    out << F("Startup arena bytes: size=") << (uint32_t)size_ << F(" used=") << (uint32_t)used_
+        << F(" free=") << (uint32_t)(size_ - used_) << F(" padding=") << (uint32_t)padding_
+        << (sealed_ ? F(" sealed\n") : F("\n"));
+
+    for(uint8_t use = 0; use < (uint8_t)Arena_use::max_arena_use; use++) {
+        const Usage& usage = usage_[use];
+
+        out << F(" ");
+        print_use(out, (Arena_use)use);
+        out << F(": arena=") << usage.arena_bytes << F(" released=") << usage.released_bytes
+            << F(" heap=") << usage.heap_bytes << F(" allocations=") << (uint32_t)usage.allocations << F("\n");
+    }
+
+    if(overflows_) {
+        out << F("!!Arena full: ") << (uint32_t)overflows_ << F(" allocations (") << overflow_bytes_
+            << F(" bytes) from the heap\n");
+    }
+
+    if(late_allocations_) {
+        out << F("!!Allocations after seal: ") << (uint32_t)late_allocations_ << F("\n");
+    }
+
+    if(late_releases_) {
+        out << F("!!Releases after end: ") << (uint32_t)late_releases_ << F("\n");
+    }
+}
+
+
+}   // namespace mr_signals
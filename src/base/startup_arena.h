@@ -0,0 +1,280 @@
+/*
+ * startup_arena.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_STARTUP_ARENA_H_
+#define SRC_BASE_STARTUP_ARENA_H_
+
+#include <stdint.h>
+#include <cstddef>      // std::size_t
+#include <new>          // Placement new
+#include <vector>
+#include <initializer_list>
+
+#include "trace.h"          // Trace_output
+#include "static_vector.h"  // Array_view
+
+namespace mr_signals {
+
+
+/// Subsystem that storage is drawn for, as broken down by Startup_arena::report()
+enum class Arena_use : uint8_t
+{
+    collections = 0,    /// Setup and loop collections
+    logic,              /// Logic_collection, including its change propagation index
+    logic_sensors,      /// Sensor lists and tumbledowns of the logic classes
+    loconet,            /// LocoNet adapter's sensor list
+    loop_timing,        /// Timing slots of the collections (MR_SIGNALS_LOOP_TIMING)
+    max_arena_use
+};
+
+
+/**
+ * Bump arena that the library's long lived storage (the collections, the
+ * logic's sensor lists and the adapter's sensors) is drawn from while the
+ * layout is constructed and set up
+ *
+ * Drawing all of it from one buffer sized by the sketch, instead of each
+ * container reserving (and, if its size guess is wrong, reallocating) on the
+ * heap, leaves the heap unfragmented and shows exactly where the RAM goes.
+ * Storage released to the arena (e.g. when a vector outgrows its reserve) is
+ * only reused if it was the last drawn, so is reported as released.
+ *
+ * Storage is drawn from the heap instead before an arena is given, when the
+ * arena is full and once it is sealed; each of these is counted.  Sealing at
+ * the end of setup() makes any later allocation an error: it is counted,
+ * reported and traced (Trace_event::arena_late_alloc).
+ *
+ * The buffer must be declared in the same file as, and ahead of, every object
+ * that draws from it.  Objects in different files are constructed and
+ * destroyed in an unspecified order, so one in another file could be
+ * destroyed after the buffer.  The range of the last buffer is kept after
+ * end() for this: a release into it is counted by late_releases() and
+ * otherwise ignored, rather than freed as heap storage.
+ *
+ * Example
+ *
+ * Startup_arena_buffer<1024> arena;     // Before the collections and logic
+ * Logic_collection logic_collection(20);
+ * ...
+ * void setup() {
+ *     ...
+ *     Startup_arena::seal();
+ *     Startup_arena::report(Serial);
+ * }
+ */
+class Startup_arena {
+public:
+
+    /// Storage drawn for one Arena_use, in bytes
+    struct Usage {
+        uint32_t arena_bytes;       /// Held in the arena
+        uint32_t released_bytes;    /// Released to the arena but not reusable
+        uint32_t heap_bytes;        /// Held on the heap
+        uint16_t allocations;       /// Allocations made, from the arena or the heap
+    };
+
+    /**
+     * Draw storage from a buffer until end(), counting from zero; it must
+     * outlive everything drawn from it
+     */
+    static void begin(uint8_t* buffer, std::size_t size);
+
+    /**
+     * Stop drawing from the buffer and clear the counts (for tests, once
+     * everything drawn is released).  Releases into the buffer after this
+     * are counted by late_releases()
+     */
+    static void end();
+
+    /// Storage aligned to alignment (a power of 2)
+    static void* allocate(std::size_t bytes, std::size_t alignment, Arena_use use);
+
+    /// Return storage from allocate(), of the bytes it was drawn with
+    static void release(void* storage, std::size_t bytes, Arena_use use);
+
+    /// Draw from the heap from now on, reporting each allocation as an error
+    static void seal();
+
+    static bool is_sealed() { return sealed_; }
+
+    static std::size_t capacity() { return size_; }
+
+    /// Bytes of the arena drawn, including released and alignment padding bytes
+    static std::size_t used() { return used_; }
+
+    /// Bytes of the arena skipped to align storage
+    static std::size_t padding() { return padding_; }
+
+    static const Usage& usage(Arena_use use) { return usage_[(uint8_t)use]; }
+
+    /// Allocations drawn from the heap as the arena was full, and their bytes
+    static uint16_t overflows() { return overflows_; }
+    static uint32_t overflow_bytes() { return overflow_bytes_; }
+
+    /// Allocations made after seal()
+    static uint16_t late_allocations() { return late_allocations_; }
+
+    /// Releases into the last buffer after end()
+    static uint16_t late_releases() { return late_releases_; }
+
+    /// Print the size, the use of each subsystem and any overflow or late allocations
+    static void report(Trace_output& out);
+
+    static void print_use(Trace_output& out, Arena_use use);
+
+private:
+
+    static bool contains(const void* storage, const uint8_t* buffer, std::size_t size);
+
+    static uint8_t* buffer_;
+    static std::size_t size_;
+    static const uint8_t* ended_buffer_;    // Last buffer given to end(); kept for late releases
+    static std::size_t ended_size_;
+    static std::size_t used_;
+    static std::size_t padding_;
+    static bool sealed_;
+
+    static Usage usage_[(uint8_t)Arena_use::max_arena_use];
+    static uint16_t overflows_;
+    static uint32_t overflow_bytes_;
+    static uint16_t late_allocations_;
+    static uint16_t late_releases_;
+
+    static uint8_t empty_;      // Storage of zero byte allocations
+};
+
+
+/**
+ * Buffer of N bytes that Startup_arena draws from while it exists
+ *
+ * Declare it in the sketch ahead of the objects that draw from it; objects
+ * in a file are constructed in the order they are declared.
+ */
+template <std::size_t N>
+class Startup_arena_buffer {
+public:
+    Startup_arena_buffer() { Startup_arena::begin(buffer_, N); }
+    ~Startup_arena_buffer() { Startup_arena::end(); }
+
+    Startup_arena_buffer(const Startup_arena_buffer&) = delete;
+    Startup_arena_buffer& operator=(const Startup_arena_buffer&) = delete;
+
+private:
+    uint8_t buffer_[N];
+};
+
+
+/**
+ * Standard allocator drawing from Startup_arena for a subsystem, for the
+ * library's containers (see Arena_vector)
+ *
+ * All of the members of a C++03 allocator are given, for the STL ports used
+ * on AVR.
+ *
+ * @param G Granule: each block is aligned to and sized in multiples of G
+ *          bytes (a power of 2), so that blocks of mixed types drawn in turn
+ *          and released in reverse order leave no alignment padding between
+ *          them and rewind the arena fully
+ */
+template <class T, Arena_use U, std::size_t G = 1>
+class Arena_allocator {
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <class O>
+    struct rebind {
+        typedef Arena_allocator<O, U, G> other;
+    };
+
+    Arena_allocator() {}
+
+    template <class O>
+    Arena_allocator(const Arena_allocator<O, U, G>&) {}
+
+    T* allocate(std::size_t count, const void* = nullptr) {
+        return static_cast<T*>(Startup_arena::allocate(bytes(count), alignof(T) > G ? alignof(T) : G, U));
+    }
+
+    void deallocate(T* storage, std::size_t count) {
+        Startup_arena::release(storage, bytes(count), U);
+    }
+
+    std::size_t max_size() const { return SIZE_MAX / sizeof(T); }
+
+    T* address(T& element) const { return &element; }
+    const T* address(const T& element) const { return &element; }
+
+    void construct(T* storage, const T& element) { new (storage) T(element); }
+    void destroy(T* storage) { storage->~T(); }
+
+    template <class O>
+    bool operator==(const Arena_allocator<O, U, G>&) const { return true; }
+
+    template <class O>
+    bool operator!=(const Arena_allocator<O, U, G>&) const { return false; }
+
+private:
+    static std::size_t bytes(std::size_t count) { return (count * sizeof(T) + G - 1) & ~(G - 1); }
+};
+
+
+/// Vector drawing from Startup_arena for a subsystem
+template <class T, Arena_use U>
+using Arena_vector = std::vector<T, Arena_allocator<T, U>>;
+
+
+/// Default construct count elements drawn from Startup_arena
+template <class T>
+T* arena_new(std::size_t count, Arena_use use)
+{
+    T* elements = static_cast<T*>(Startup_arena::allocate(count * sizeof(T), alignof(T), use));
+
+    for(std::size_t i = 0; i < count; i++) {
+        new (&elements[i]) T();
+    }
+
+    return elements;
+}
+
+/// Destroy and release elements from arena_new()
+template <class T>
+void arena_delete(T* elements, std::size_t count, Arena_use use)
+{
+    for(std::size_t i = 0; i < count; i++) {
+        elements[i].~T();
+    }
+
+    Startup_arena::release(elements, count * sizeof(T), use);
+}
+
+/**
+ * Copy a list to storage drawn from Startup_arena
+ * @return A view of the copy, released with arena_delete(view.begin(), view.size(), use)
+ */
+template <class T>
+Array_view<T> arena_copy(std::initializer_list<T> elements, Arena_use use)
+{
+    T* data = arena_new<T>(elements.size(), use);
+    std::size_t size = 0;
+
+    for(const T& element : elements) {
+        data[size++] = element;
+    }
+
+    return Array_view<T>(data, size);
+}
+
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_BASE_STARTUP_ARENA_H_ */
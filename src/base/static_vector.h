@@ -0,0 +1,121 @@
+/*
+ * static_vector.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_STATIC_VECTOR_H_
+#define SRC_BASE_STATIC_VECTOR_H_
+
+#include <cstddef>      // std::size_t
+#include <stdint.h>     // uint8_t
+
+
+namespace mr_signals {
+
+
+/**
+ * Non-owning view of a run of elements held elsewhere, e.g. in a
+ * Static_vector, an array or the heap
+ *
+ * Lets a class work on a list whose storage is chosen by the code that
+ * constructs it (see Static_vector), without being a template itself.
+ */
+template <class T>
+class Array_view {
+public:
+    Array_view() : data_(nullptr), size_(0) {}
+    Array_view(T* data, std::size_t size) : data_(data), size_(size) {}
+
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return 0 == size_; }
+
+    T& operator[](std::size_t index) const { return data_[index]; }
+    T& front() const { return data_[0]; }
+    T& back() const { return data_[size_ - 1]; }
+
+private:
+    T* data_;
+    std::size_t size_;
+};
+
+
+
+/**
+ * Vector of at most N elements with its storage embedded in the object
+ *
+ * For lists whose length is known when the program is written, such as the
+ * sensors protected by a logic, so that they need no heap (and no allocator
+ * overhead or fragmentation on AVR) and sit next to the object that uses
+ * them.  Construction from an array (including a braced list of a known
+ * length) checks the length against N at compile time.
+ *
+ * Example
+ *
+ * Static_vector<Sensor_interface*, 3> sensors({&sensor_1, &sensor_2});
+ *
+ * @param T Element type; must be default constructible
+ * @param N Capacity in elements, at most 255
+ */
+template <class T, std::size_t N>
+class Static_vector {
+
+    static_assert(N >= 1 && N <= 255, "Static_vector capacity must be from 1 to 255");
+
+public:
+    Static_vector() : size_(0) {}
+
+    template <std::size_t M>
+    Static_vector(const T (&elements)[M]) : size_(0) {
+        static_assert(M <= N, "More elements than the Static_vector capacity");
+
+        for(const T& element : elements) {
+            elements_[size_++] = element;
+        }
+    }
+
+    /// @return false if the vector is full
+    bool push_back(const T& element) {
+        if(size_ >= N) {
+            return false;
+        }
+
+        elements_[size_++] = element;
+        return true;
+    }
+
+    void clear() { size_ = 0; }
+
+    T* begin() { return elements_; }
+    T* end() { return elements_ + size_; }
+    const T* begin() const { return elements_; }
+    const T* end() const { return elements_ + size_; }
+
+    T* data() { return elements_; }
+    const T* data() const { return elements_; }
+
+    std::size_t size() const { return size_; }
+    static constexpr std::size_t capacity() { return N; }
+    bool empty() const { return 0 == size_; }
+
+    T& operator[](std::size_t index) { return elements_[index]; }
+    const T& operator[](std::size_t index) const { return elements_[index]; }
+
+    T& front() { return elements_[0]; }
+    T& back() { return elements_[size_ - 1]; }
+
+    Array_view<T> view() { return Array_view<T>(elements_, size_); }
+
+private:
+    T elements_[N];
+    uint8_t size_;
+};
+
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_BASE_STATIC_VECTOR_H_ */
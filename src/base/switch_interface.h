@@ -19,6 +19,13 @@ enum class Switch_direction : uint8_t {
     unknown      /// The state of the switch is unknown
 };
 
+/// How urgently a switch request should be sent relative to others on the
+/// same bus.  Buses without any ordering may ignore it.
+enum class Switch_priority : uint8_t {
+    normal,     /// Initial state, follow-ups and refreshes
+    urgent      /// e.g. a head changing to a more restrictive aspect
+};
+
 /**
  * Abstract interface to address DCC (or similar) switches to be used
  * by classes that manipulate the state of physical switches.
@@ -36,7 +43,7 @@ enum class Switch_direction : uint8_t {
  */
 class Switch_interface {
 public:
-    virtual bool request_direction(const Switch_direction)=0;
+    virtual bool request_direction(const Switch_direction, const Switch_priority = Switch_priority::normal)=0;
     virtual void loop()=0;
     virtual ~Switch_interface() = default;
 
@@ -49,14 +56,15 @@ public:
 
 
     Test_switch(int num = -1) :
-        direction_(Switch_direction::unknown), num_(num), loop_cnt_(0), lock_(false)
+        direction_(Switch_direction::unknown), last_priority_(Switch_priority::normal), num_(num), loop_cnt_(0), lock_(false)
     {
     }
 
     /// In this test implementation, the request to change direction is always
     /// successful.  Tests for
-    bool request_direction(const Switch_direction direction) override
+    bool request_direction(const Switch_direction direction, const Switch_priority priority = Switch_priority::normal) override
     {
+        last_priority_ = priority;
 
         if(lock_) {
             return false;
@@ -75,6 +83,9 @@ public:
     /// Let tests access the switch's direction
     Switch_direction  get_direction() const { return direction_; }
 
+    /// Let tests access the priority of the last direction request
+    Switch_priority get_last_priority() const { return last_priority_; }
+
     /// Let tests access the number of times .loop() has been called
     int get_loop_cnt() const { return loop_cnt_; }
 
@@ -84,6 +95,7 @@ public:
 protected:
 
     Switch_direction direction_;    /// Direction of the switch
+    Switch_priority last_priority_; /// Priority of the last direction request
     int num_;                       /// Switch number for test convenience
     int loop_cnt_;
     bool lock_;
@@ -0,0 +1,141 @@
+/*
+ * timer_service.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "timer_service.h"
+
+namespace mr_signals {
+
+
+Timer_interface::~Timer_interface()
+{
+    if(service_) {
+        service_->cancel(*this);
+    }
+}
+
+
+Timer_service::Timer_service() : current_tick_(0), count_(0)
+{
+    for(uint8_t slot = 0; slot < slot_count; slot++) {
+        slots_[slot] = nullptr;
+    }
+}
+
+
+Timer_service::~Timer_service()
+{
+    for(uint8_t slot = 0; slot < slot_count; slot++) {
+
+        while(slots_[slot]) {
+            Timer_interface* timer = slots_[slot];
+
+            slots_[slot] = timer->next_;
+
+            timer->next_ = nullptr;
+            timer->service_ = nullptr;
+        }
+    }
+}
+
+
+void Timer_service::schedule(Timer_interface& timer, const Runtime_ms expiry_ms)
+{
+    if(timer.service_) {
+        timer.service_->cancel(timer);
+    }
+
+    timer.expiry_ms_ = expiry_ms;
+
+    // First tick that starts at or after the expiry, so that the timer has
+    // expired whenever its slot is serviced for that tick
+    Runtime_ms tick = expiry_ms / tick_ms + ((expiry_ms % tick_ms) ? 1 : 0);
+
+    if((int32_t)(tick - current_tick_) <= 0) {
+        tick = current_tick_ + 1;
+    }
+
+    link(timer, tick);
+}
+
+
+void Timer_service::cancel(Timer_interface& timer)
+{
+    if(this != timer.service_) {
+        return;
+    }
+
+    for(Timer_interface** link = &slots_[timer.slot_]; *link; link = &(*link)->next_) {
+
+        if(&timer == *link) {
+            *link = timer.next_;
+            break;
+        }
+    }
+
+    timer.next_ = nullptr;
+    timer.service_ = nullptr;
+    count_--;
+}
+
+
+void Timer_service::service(const Runtime_ms curr_time)
+{
+    Runtime_ms now_tick = curr_time / tick_ms;
+
+    if((int32_t)(now_tick - current_tick_) <= 0) {
+        return;     // Still within the last serviced tick
+    }
+
+    // After a long gap, every slot is visited once
+    if(now_tick - current_tick_ > slot_count) {
+        current_tick_ = now_tick - slot_count;
+    }
+
+    while(current_tick_ != now_tick) {
+
+        current_tick_++;
+
+        Timer_interface** slot = &slots_[current_tick_ & (slot_count - 1)];
+        Timer_interface** link = slot;
+
+        while(*link) {
+
+            Timer_interface* timer = *link;
+
+            if((int32_t)(curr_time - timer->expiry_ms_) >= 0) {
+
+                *link = timer->next_;
+
+                timer->next_ = nullptr;
+                timer->service_ = nullptr;
+                count_--;
+
+                timer->on_timer(curr_time);
+
+                // The callback may have changed the slot; start again
+                link = slot;
+            }
+            else {
+                // Due in a later revolution of the wheel
+                link = &timer->next_;
+            }
+        }
+    }
+}
+
+
+void Timer_service::link(Timer_interface& timer, const Runtime_ms tick)
+{
+    timer.slot_ = tick & (slot_count - 1);
+    timer.next_ = slots_[timer.slot_];
+    timer.service_ = this;
+
+    slots_[timer.slot_] = &timer;
+    count_++;
+}
+
+
+} // namespace mr_signals
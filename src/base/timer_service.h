@@ -0,0 +1,137 @@
+/*
+ * timer_service.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_TIMER_SERVICE_H_
+#define SRC_BASE_TIMER_SERVICE_H_
+
+#include <stdint.h>
+
+#include "../mr_signals_config.h"  // MR_SIGNALS_TIMER_WHEEL_SLOTS
+#include "runtime_ms.h"
+
+namespace mr_signals {
+
+class Timer_service;
+
+
+/**
+ * Interface for objects that schedule a callback with a Timer_service
+ *
+ * Each object holds the links for one pending timer, so scheduling does not
+ * allocate.  Scheduling an object that is already pending moves its timer,
+ * and destroying it cancels any pending timer.
+ */
+class Timer_interface {
+public:
+    Timer_interface() : expiry_ms_(0), next_(nullptr), service_(nullptr), slot_(0) {}
+
+    virtual ~Timer_interface();
+
+    /**
+     * Called by Timer_service::service() once the scheduled time has passed
+     * @param curr_time - Time passed to service()
+     */
+    virtual void on_timer(const Runtime_ms curr_time) = 0;
+
+    bool is_scheduled() const { return nullptr != service_; }
+
+private:
+    friend class Timer_service;
+
+    Runtime_ms expiry_ms_;          // Time the timer is due
+    Timer_interface* next_;         // Next timer in the same wheel slot
+    Timer_service* service_;        // Service the timer is pending in; nullptr if none
+    uint8_t slot_;                  // Wheel slot holding the timer
+
+    // Not copyable; the wheel holds a pointer to this object
+    Timer_interface(const Timer_interface&) = delete;
+    Timer_interface& operator=(const Timer_interface&) = delete;
+};
+
+
+/**
+ * Hashed timer wheel that calls back Timer_interface objects once their
+ * scheduled time has passed
+ *
+ * Replaces each object testing its own deadline on every loop.  service() is
+ * called from the loop with the current time; unless a slot boundary (every
+ * MR_SIGNALS_TIMER_TICK_MS) has been crossed it returns after one comparison.
+ * Each crossed slot holds the timers due in it, plus any due a whole number of
+ * wheel revolutions later, which are left in place.
+ *
+ * Timers are kept in a singly linked list per slot, so cancel() walks the
+ * slot; this is short for the on->off delays that the wheel is used for.
+ *
+ * Example
+ *
+ * class Follow_up : public Timer_interface {
+ *     void on_timer(const Runtime_ms) override { ... }
+ * };
+ *
+ * timer_service.schedule(follow_up, get_time_ms() + 60);
+ * ...
+ * loop() {
+ *     timer_service.service(get_time_ms());
+ * }
+ */
+class Timer_service {
+public:
+
+    static const uint8_t slot_count = MR_SIGNALS_TIMER_WHEEL_SLOTS;
+    static const Runtime_ms tick_ms = MR_SIGNALS_TIMER_TICK_MS;
+
+    static_assert(slot_count >= 2 && 0 == (slot_count & (slot_count - 1)),
+                  "MR_SIGNALS_TIMER_WHEEL_SLOTS must be a power of two, at least 2");
+
+    static_assert(tick_ms, "MR_SIGNALS_TIMER_TICK_MS must not be 0");
+
+    Timer_service();
+
+    /// Timers still pending are left unscheduled
+    ~Timer_service();
+
+    /**
+     * Schedule a timer, replacing any time it is already pending for
+     *
+     * A time that has already passed fires on the next slot boundary.
+     *
+     * @param timer     - Object to call back
+     * @param expiry_ms - Time from which the timer is due
+     */
+    void schedule(Timer_interface& timer, const Runtime_ms expiry_ms);
+
+    /**
+     * Cancel a pending timer; no effect if it is not pending in this service
+     */
+    void cancel(Timer_interface& timer);
+
+    /**
+     * Call the timers that have expired by the given time
+     *
+     * A callback may schedule or cancel timers, including its own.
+     *
+     * @param curr_time - The current time; must not go backwards
+     */
+    void service(const Runtime_ms curr_time);
+
+    /// Number of pending timers
+    uint16_t count() const { return count_; }
+
+private:
+
+    void link(Timer_interface& timer, const Runtime_ms tick);
+
+    Timer_interface* slots_[slot_count];
+
+    Runtime_ms current_tick_;       // Last tick whose slot has been serviced
+    uint16_t count_;
+};
+
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_BASE_TIMER_SERVICE_H_ */
@@ -0,0 +1,431 @@
+/*
+ * trace.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <string.h>
+
+#include "trace.h"
+#include "head_interface.h"
+#include "startup_arena.h"
+#include "mr_signals.h"
+
+#ifndef ARDUINO
+#include "arduino_mock.h"   // millis() for unit tests not on Arduino
+#endif
+
+namespace mr_signals {
+
+
+// Define static constant members for external use
+const uint8_t     Trace_record::payload_size;
+const uint8_t     Trace_record::dump_size;
+const uint8_t     Trace_decoder::max_payload;
+const std::size_t Trace_ring::capacity;
+
+Trace_ring* Trace_ring::active_ = nullptr;
+bool Trace_ring::serial_fallback_ = false;
+
+
+namespace {
+
+const uint8_t ln_opc_long_ack = 0xB4;       // OPC_LONG_ACK (LocoNet.h)
+
+const uint16_t ln_interrogation_first = 1017;   // Switch addresses used for
+const uint16_t ln_interrogation_last = 1020;    // sensor interrogation
+
+/// Print an unsigned value in decimal, zero padded to min_digits
+void print_decimal(Trace_output& out, uint32_t value, const uint8_t min_digits)
+{
+    char text[11];
+    uint8_t pos = sizeof(text) - 1;
+
+    text[pos] = '\0';
+
+    do {
+        text[--pos] = '0' + (value % 10);
+        value /= 10;
+    } while((value || (sizeof(text) - 1 - pos) < min_digits) && pos > 0);
+
+    out << &text[pos];
+}
+
+/// Print a byte as two upper case hex digits and a space
+void print_hex(Trace_output& out, const uint8_t value)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    char text[4] = { digits[value >> 4], digits[value & 0x0F], ' ', '\0' };
+
+    out << text;
+}
+
+void print_name(Trace_output& out, const uint8_t* name, const uint8_t size)
+{
+    char text[Trace_decoder::max_payload + 1];
+
+    memcpy(text, name, size);
+    text[size] = '\0';
+
+    out << text;
+}
+
+void print_state(Trace_output& out, const uint8_t state)
+{
+    out << (state ? F("Active") : F("Inactive"));
+}
+
+uint16_t get_le16(const uint8_t* bytes)
+{
+    return bytes[0] | ((uint16_t)bytes[1] << 8);
+}
+
+}
+
+
+///////////////////////////////////////////////////
+
+
+Trace_decoder::Trace_decoder() : time_ms_(0), event_(Trace_event::continuation), size_(0), received_(0)
+{
+}
+
+bool Trace_decoder::decode(const Trace_record& record, Trace_output& out)
+{
+    if(Trace_event::continuation == record.event) {
+        if(Trace_event::continuation == event_) {
+            return false;       // The start of the event was not received
+        }
+    }
+    else {
+        time_ms_ = record.time_ms;
+        event_ = record.event;
+        size_ = (record.size < max_payload) ? record.size : max_payload;
+        received_ = 0;
+    }
+
+    uint8_t length = size_ - received_;
+    if(length > Trace_record::payload_size) {
+        length = Trace_record::payload_size;
+    }
+
+    memcpy(&payload_[received_], record.payload, length);
+    received_ += length;
+
+    if(received_ < size_) {
+        return false;
+    }
+
+    format(out, time_ms_, event_, payload_, size_);
+    event_ = Trace_event::continuation;
+
+    return true;
+}
+
+/**
+ * Produces the same text as the Serial printing that each event replaced,
+ * including the lack of line ends within a received message's processing
+ */
+void Trace_decoder::format(Trace_output& out, const uint32_t time_ms, const Trace_event event,
+                           const uint8_t* payload, const uint8_t size)
+{
+    switch(event) {
+    case Trace_event::ln_rx:
+    case Trace_event::ln_tx:
+        print_decimal(out, time_ms, 8);
+        out << (Trace_event::ln_rx == event ? F(":LN RX ") : F(":LN TX "));
+
+        for(uint8_t i = 0; i < size; i++) {
+            print_hex(out, payload[i]);
+        }
+
+        if(Trace_event::ln_tx == event) {
+            out << F("cs ");    // Checksum not traced; align with the received messages
+        }
+
+        if(size && ln_opc_long_ack == payload[0]) {
+            out << F(" LONG_ACK!");
+        }
+        break;
+
+    case Trace_event::ln_tx_backoff:
+        out << F("-TX backoff\n");
+        break;
+
+    case Trace_event::ln_tx_error:
+        out << F("-TX error\n");
+        break;
+
+    case Trace_event::line_end:
+        out << F("\n");
+        break;
+
+    case Trace_event::sensor_report:
+        if(size >= 3) {
+            out << F("Sensor: ");
+            print_decimal(out, get_le16(payload), 1);
+            out << F(" - ");
+            print_state(out, payload[2]);
+        }
+        break;
+
+    case Trace_event::switch_request:
+        if(size >= 4) {
+            uint16_t address = get_le16(payload);
+
+            if(address >= ln_interrogation_first && address <= ln_interrogation_last) {
+                out << F("Sensor Interrogation");
+            }
+            else {
+                out << F("Switch: ");
+                print_decimal(out, address, 1);
+                out << F(" - ") << (payload[3] ? F("Closed") : F("Thrown"));
+            }
+
+            out << F(" (Output ") << (payload[2] ? F("On") : F("Off")) << F(")");
+        }
+        break;
+
+    case Trace_event::sensor_set:
+        if(size >= 1) {
+            out << F("\nSet Sensor ");
+            print_name(out, payload + 1, size - 1);
+            out << F(" -> ");
+            print_state(out, payload[0]);
+        }
+        break;
+
+    case Trace_event::aspect_change:
+        if(size >= 2) {
+            print_name(out, payload + 2, size - 2);
+            out << F(" (") << (Head_aspect)payload[0] << F(") new aspect : (") << (Head_aspect)payload[1] << F(")\n");
+        }
+        break;
+
+    case Trace_event::head_held:
+        print_name(out, payload, size);
+        out << F(" held at red\n");
+        break;
+
+    case Trace_event::lever_normal:
+        print_name(out, payload, size);
+        out << F(" lever normal; set to red\n");
+        break;
+
+    case Trace_event::aspect_accepted:
+        out << F("(Accepted)\n");
+        break;
+
+    case Trace_event::apb_state:
+        if(size >= 1) {
+            switch((Trace_apb_state)payload[0]) {
+            case Trace_apb_state::all_clear:
+                out << F("No sensors active, clear all tumbledowns\n");
+                break;
+            case Trace_apb_state::up_active:
+                out << F("Up tumbledowns are active\n");
+                break;
+            case Trace_apb_state::up_inactive_last_occupied:
+                out << F("Up tumbledowns are inactive, sensor[n-1] active, set down tumbledowns\n");
+                break;
+            case Trace_apb_state::down_active:
+                out << F("Down tumbledowns are active\n");
+                break;
+            case Trace_apb_state::down_inactive_first_occupied:
+                out << F("Down tumbledowns are inactive, sensor[0] active, set up tumbledowns\n");
+                break;
+            }
+        }
+        break;
+
+    case Trace_event::ln_rx_near_full:
+        if(size >= 2) {
+            out << F("!!LN RX buffer near full (");
+            print_decimal(out, get_le16(payload), 1);
+            out << F(" bytes)\n");
+        }
+        break;
+
+    case Trace_event::arena_late_alloc:
+        if(size >= 3) {
+            out << F("!!Allocation after setup: ");
+            Startup_arena::print_use(out, (Arena_use)payload[0]);
+            out << F(" ");
+            print_decimal(out, get_le16(payload + 1), 1);
+            out << F(" bytes\n");
+        }
+        break;
+
+    case Trace_event::ln_tx_buffer_size:
+        if(size >= 4) {
+            out << F("!!LN TX buffer size ");
+            print_decimal(out, get_le16(payload), 1);
+            out << F(" not usable; using MRRWA_LN_TX_BUFFER_CAPACITY (");
+            print_decimal(out, get_le16(payload + 2), 1);
+            out << F(" bytes)\n");
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void Trace_decoder::from_dump(const uint8_t* bytes, Trace_record& record)
+{
+    record.time_ms = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+                     ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    record.event = (Trace_event)bytes[4];
+    record.size = bytes[5];
+    memcpy(record.payload, &bytes[6], Trace_record::payload_size);
+}
+
+
+///////////////////////////////////////////////////
+
+
+Trace_ring::Trace_ring() : dropped_(0)
+{
+}
+
+Trace_ring::~Trace_ring()
+{
+    if(this == active_) {
+        active_ = nullptr;
+    }
+}
+
+void Trace_ring::set_active(Trace_ring* ring)
+{
+    active_ = ring;
+}
+
+Trace_ring* Trace_ring::get_active()
+{
+    return active_;
+}
+
+void Trace_ring::set_serial_fallback(bool enable)
+{
+    serial_fallback_ = enable;
+}
+
+bool Trace_ring::get_serial_fallback()
+{
+    return serial_fallback_;
+}
+
+bool Trace_ring::write(const Trace_event event, const uint8_t* payload, uint8_t size)
+{
+    if(size > Trace_decoder::max_payload) {
+        size = Trace_decoder::max_payload;
+    }
+
+    const uint8_t record_count = (size > Trace_record::payload_size) ?
+                                 (size + Trace_record::payload_size - 1) / Trace_record::payload_size : 1;
+
+    Trace_record records[Trace_decoder::max_payload / Trace_record::payload_size];
+
+    const uint32_t time_ms = millis();
+
+    for(uint8_t i = 0; i < record_count; i++) {
+        uint8_t offset = i * Trace_record::payload_size;
+        uint8_t length = size - offset;
+
+        if(length > Trace_record::payload_size) {
+            length = Trace_record::payload_size;
+        }
+
+        records[i].time_ms = time_ms;
+        records[i].event = (0 == i) ? event : Trace_event::continuation;
+        records[i].size = size;
+        memset(records[i].payload, 0, Trace_record::payload_size);
+        if(length) {
+            memcpy(records[i].payload, payload + offset, length);
+        }
+    }
+
+    if(!records_.enqueue(records, record_count)) {
+        if(dropped_ < UINT16_MAX) {
+            dropped_++;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+std::size_t Trace_ring::drain(Trace_output& out, std::size_t max_events)
+{
+    std::size_t events = 0;
+    Trace_record record;
+
+    while(events < max_events && records_.dequeue(record)) {
+        if(decoder_.decode(record, out)) {
+            events++;
+        }
+    }
+
+    return events;
+}
+
+std::size_t Trace_ring::dump(Trace_output& out, std::size_t max_records)
+{
+    std::size_t count = 0;
+    Trace_record record;
+    uint8_t bytes[Trace_record::dump_size];
+
+    while(count < max_records && records_.dequeue(record)) {
+        bytes[0] = record.time_ms;
+        bytes[1] = record.time_ms >> 8;
+        bytes[2] = record.time_ms >> 16;
+        bytes[3] = record.time_ms >> 24;
+        bytes[4] = (uint8_t)record.event;
+        bytes[5] = record.size;
+        memcpy(&bytes[6], record.payload, Trace_record::payload_size);
+
+#ifdef ARDUINO
+        out.write(bytes, Trace_record::dump_size);
+#else
+        out.write((const char*)bytes, Trace_record::dump_size);
+#endif
+        count++;
+    }
+
+    return count;
+}
+
+
+///////////////////////////////////////////////////
+
+
+void trace(const Trace_event event, const uint8_t* payload, const uint8_t size)
+{
+    Trace_ring* ring = Trace_ring::get_active();
+
+    if(ring) {
+        ring->write(event, payload, size);
+    }
+    else if(Trace_ring::get_serial_fallback()) {
+        Trace_decoder::format(Serial, millis(), event, payload, size);
+    }
+}
+
+void trace_named(const Trace_event event, const char* name, const uint8_t* codes, const uint8_t code_count)
+{
+    uint8_t payload[Trace_decoder::max_payload];
+    uint8_t size = 0;
+
+    for(; size < code_count && size < Trace_decoder::max_payload; size++) {
+        payload[size] = codes[size];
+    }
+
+    for(; name && *name && size < Trace_decoder::max_payload; size++) {
+        payload[size] = *name++;
+    }
+
+    trace(event, payload, size);
+}
+
+
+}   // namespace mr_signals
@@ -0,0 +1,203 @@
+/*
+ * trace.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_BASE_TRACE_H_
+#define SRC_BASE_TRACE_H_
+
+#include <stdint.h>
+#include <cstddef>      // std::size_t
+
+#include "../mr_signals_config.h"  // MR_SIGNALS_TRACE_RECORDS
+#include "circular_buffer.h"
+
+#ifdef ARDUINO
+class Print;
+#else
+#include <iosfwd>
+#endif
+
+namespace mr_signals {
+
+/// Stream that trace events are formatted or dumped to (Serial on Arduino)
+#ifdef ARDUINO
+typedef Print Trace_output;
+#else
+typedef std::ostream Trace_output;
+#endif
+
+
+/// Event id of a trace record.  Values are part of the dump format.
+enum class Trace_event : uint8_t
+{
+    continuation = 0,   /// Further payload of the preceding event
+    ln_rx,              /// LocoNet message received: message bytes
+    ln_tx,              /// LocoNet message sent: message bytes less the checksum
+    ln_tx_backoff,      /// The last message sent backed off and will be retried
+    ln_tx_error,        /// The last message sent failed
+    line_end,           /// End of the processing of a message
+    sensor_report,      /// Sensor message: address (LE16), state
+    switch_request,     /// Switch request: address (LE16), output, direction
+    sensor_set,         /// Attached sensor changed: state, name
+    aspect_change,      /// Logic changed a head: old aspect, new aspect, name
+    head_held,          /// Interlocked head held at red: name
+    lever_normal,       /// Interlocked head set to red by its lever: name
+    aspect_accepted,    /// The preceding aspect request was accepted
+    apb_state,          /// Full_apb state: Trace_apb_state
+    ln_rx_near_full,    /// LocoNet receive buffer nearly full: bytes (LE16)
+    arena_late_alloc,   /// Allocation after Startup_arena::seal(): Arena_use, bytes (LE16)
+    ln_tx_buffer_size,  /// LocoNet tx buffer size not usable, capacity used: requested (LE16), capacity (LE16)
+    max_trace_event
+};
+
+/// Payload of Trace_event::apb_state
+enum class Trace_apb_state : uint8_t
+{
+    all_clear,
+    up_active,
+    up_inactive_last_occupied,
+    down_active,
+    down_inactive_first_occupied
+};
+
+
+/**
+ * Fixed size trace record
+ *
+ * Events with more payload than one record holds continue into following
+ * records with the event Trace_event::continuation.  As dumped by
+ * Trace_ring::dump(), each record is 16 bytes: time_ms (little endian),
+ * event, size and the payload.
+ */
+struct Trace_record {
+    static const uint8_t payload_size = 10;
+    static const uint8_t dump_size = 16;
+
+    uint32_t time_ms;               /// millis() when the event was traced
+    Trace_event event;
+    uint8_t size;                   /// Payload bytes of the whole event
+    uint8_t payload[payload_size];
+};
+
+
+/**
+ * Formats trace events into the text that was previously printed directly
+ * to Serial by the code that traces them
+ *
+ * Records are passed in the order they were traced; an event is formatted
+ * once all of its records have been received.
+ */
+class Trace_decoder {
+public:
+
+    /// Largest event payload; longer payloads are truncated when traced
+    static const uint8_t max_payload = 3 * Trace_record::payload_size;
+
+    Trace_decoder();
+
+    /**
+     * Accept the next record and format the event once it is complete
+     * @return true if an event was formatted to out
+     */
+    bool decode(const Trace_record& record, Trace_output& out);
+
+    /// Format one complete event
+    static void format(Trace_output& out, const uint32_t time_ms, const Trace_event event,
+                       const uint8_t* payload, const uint8_t size);
+
+    /// Decode a record from its dump_size bytes as written by Trace_ring::dump()
+    static void from_dump(const uint8_t* bytes, Trace_record& record);
+
+private:
+    uint32_t time_ms_;
+    Trace_event event_;
+    uint8_t size_;          // Payload bytes of the event being assembled
+    uint8_t received_;      // Payload bytes received so far
+    uint8_t payload_[max_payload];
+};
+
+
+/**
+ * RAM ring of trace records, written from the hot path and formatted or
+ * dumped later by a consumer (e.g. from the sketch's loop() when idle)
+ *
+ * trace() writes to the active ring, set with set_active().  With no active
+ * ring, events are dropped unless set_serial_fallback(true) has been called,
+ * in which case they are formatted to Serial as they are traced (as before
+ * the ring existed, at the cost of printing on the hot path).  Events that do
+ * not fit are dropped and counted; a ring does not overwrite records that
+ * have not been consumed.
+ *
+ * Example
+ *
+ * Trace_ring trace_ring;
+ *
+ * setup()  { Trace_ring::set_active(&trace_ring); }
+ * loop()   { ...; trace_ring.drain(Serial, 4); }
+ */
+class Trace_ring {
+public:
+
+    static const std::size_t capacity = MR_SIGNALS_TRACE_RECORDS;
+
+    Trace_ring();
+    ~Trace_ring();
+
+    /// Set the ring trace() writes to; nullptr drops events (see set_serial_fallback())
+    static void set_active(Trace_ring* ring);
+    static Trace_ring* get_active();
+
+    /// With no active ring, format events to Serial as they are traced instead of dropping them
+    static void set_serial_fallback(bool enable);
+    static bool get_serial_fallback();
+
+    /**
+     * Record an event, stamped with millis()
+     * @return false if the event did not fit and was dropped
+     */
+    bool write(const Trace_event event, const uint8_t* payload, uint8_t size);
+
+    /**
+     * Format up to max_events events to out, removing them from the ring
+     * @return The number of events formatted
+     */
+    std::size_t drain(Trace_output& out, std::size_t max_events = SIZE_MAX);
+
+    /**
+     * Write up to max_records records to out as binary (see Trace_record),
+     * removing them from the ring.  For decoding on a host with
+     * tools/trace_decode.
+     * @return The number of records written
+     */
+    std::size_t dump(Trace_output& out, std::size_t max_records = SIZE_MAX);
+
+    /// Number of records held
+    std::size_t size() const { return records_.size(); }
+
+    /// Number of events dropped as the ring was full
+    uint16_t dropped() const { return dropped_; }
+
+private:
+    Circular_buffer<Trace_record, capacity> records_;
+    Trace_decoder decoder_;
+    uint16_t dropped_;
+
+    static Trace_ring* active_;
+    static bool serial_fallback_;
+};
+
+
+/// Record an event to the active Trace_ring; with none, drop it or format it to Serial
+void trace(const Trace_event event, const uint8_t* payload = nullptr, const uint8_t size = 0);
+
+/// Record an event whose payload is a short code followed by a name
+void trace_named(const Trace_event event, const char* name, const uint8_t* codes = nullptr,
+                 const uint8_t code_count = 0);
+
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_BASE_TRACE_H_ */
@@ -43,6 +43,9 @@ public:
         }
     }
 
+    /// Changes with the head's aspect
+    const void* change_source() const override { return &head_; }
+
 private:
     Head_interface& head_;
 };
@@ -69,6 +72,9 @@ public:
         return false;
     }
 
+    /// Changes with the head's aspect
+    const void* change_source() const override { return &head_; }
+
 
 private:
     const Head_interface& head_;
@@ -134,6 +140,14 @@ public:
         }
     }
 
+    bool list_dependencies(Logic_dependencies& dependencies) const override {
+        dependencies.input(*sensor_1);
+        dependencies.input(*sensor_2);
+        dependencies.output(lock_first);
+        dependencies.output(lock_second);
+        return true;
+    }
+
     Sensor_base lock_first;
     Sensor_base lock_second;
 };
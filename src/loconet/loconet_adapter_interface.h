@@ -10,13 +10,17 @@
 
 #include <stdint.h>
 
+#include "../base/switch_interface.h"     // Switch_priority
+#include "../base/runtime_ms.h"
+#include "../base/timer_service.h"
+#include "../base/sensor_state_store.h"
+
 namespace mr_signals {
 
 class Loconet_sensor;   // Forward declaration for use in Loconet_adapter_interface
 
 
 typedef uint16_t Loconet_address;
-typedef uint32_t Runtime_ms;
 
 /**
  *  Interface class that defines all of the methods necessary for a
@@ -72,6 +76,16 @@ public:
      */
     virtual void set_retransmit() = 0;
 
+    /**
+     * Tells the manager that a message (new or retransmitted) has just been
+     * passed to LocoNet, whether or not it was sent successfully.  A failure
+     * is reported separately with set_retransmit().
+     *
+     * Lets managers that adapt their rate count actual traffic rather than
+     * transmit opportunities.
+     */
+    virtual void set_transmitted(const Runtime_ms) = 0;
+
     /**
      * Allows a delay to be added before the next transmission (e.g. adds
      * the passed delay to the time before is_tx_allowed() will next
@@ -118,10 +132,12 @@ public:
      * @param address The address to send the switch command
      * @param thrown thrown (true) or closed (false) state to send
      * @param on on/off argument for OpcSwReq
+     * @param priority urgent requests may be sent ahead of normal ones
      * @return true if the command was successfully sent / queued
      *          false if the command was not sent and should be retried if needed
      */
-    virtual bool send_opc_sw_req(Loconet_address address, bool thrown, bool on) = 0;
+    virtual bool send_opc_sw_req(Loconet_address address, bool thrown, bool on,
+                                 Switch_priority priority = Switch_priority::normal) = 0;
 
     /**
      * Allow other objects to send the Global Power On message (typically to
@@ -150,6 +166,20 @@ public:
      */
     virtual Runtime_ms get_time_ms() const = 0;
 
+    /**
+     * Provides a timer service, in the same time base, that is serviced by
+     * the adapter's loop
+     * @return The timer service, or nullptr if the adapter has none (elements
+     * then poll their deadlines in their own loop())
+     */
+    virtual Timer_service* get_timer_service() { return nullptr; }
+
+    /**
+     * Provides the store that attached Loconet sensors keep their state in
+     * @return The store, or nullptr if sensors should hold their own state
+     */
+    virtual Sensor_state_store* get_sensor_state_store() { return nullptr; }
+
 };
 
 
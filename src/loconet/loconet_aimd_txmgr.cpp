@@ -0,0 +1,144 @@
+/*
+ * loconet_aimd_txmgr.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "loconet_aimd_txmgr.h"
+
+namespace mr_signals {
+
+
+// Define static constant members for external use
+const Runtime_ms Loconet_aimd_txmgr::min_tx_delay_default      = 10;   // ms
+const Runtime_ms Loconet_aimd_txmgr::max_tx_delay_default      = 200;  // ms
+const uint8_t    Loconet_aimd_txmgr::window_default            = 2;    // messages
+const uint8_t    Loconet_aimd_txmgr::rate_step_default         = 1;    // messages per second
+const uint8_t    Loconet_aimd_txmgr::retransmit_limit_default  = 3;
+
+
+
+Loconet_aimd_txmgr::Loconet_aimd_txmgr( Runtime_ms min_tx_delay,
+                                        Runtime_ms max_tx_delay,
+                                        uint8_t window,
+                                        uint8_t rate_step,
+                                        uint8_t retransmit_limit) :
+
+                                        next_tx_time_(0), last_tx_time_(0), tx_delay_(max_tx_delay),
+                                        rate_(0), min_rate_(0), max_rate_(0),
+                                        slow_start_(true), retransmit_flag_(false),
+                                        retransmission_count_(0), clean_count_(0),
+                                        window_(window ? window : 1),
+                                        rate_step_(rate_step ? rate_step : 1),
+                                        retransmit_limit_(retransmit_limit)
+{
+    max_rate_ = 1000 / (min_tx_delay ? min_tx_delay : 1);
+    min_rate_ = 1000 / (max_tx_delay ? max_tx_delay : 1);
+
+    if(0 == min_rate_) {
+        min_rate_ = 1;
+    }
+
+    if(max_rate_ < min_rate_) {
+        max_rate_ = min_rate_;
+    }
+
+    set_rate(min_rate_);
+}
+
+
+bool Loconet_aimd_txmgr::is_tx_allowed(const Runtime_ms current_time_ms)
+{
+    return (current_time_ms >= next_tx_time_);
+}
+
+
+bool Loconet_aimd_txmgr::is_retransmission()
+{
+    if(retransmit_flag_) {
+        retransmit_flag_ = false;
+
+        // Count and limit the number of sequential retransmission indications
+
+        if(retransmission_count_ < retransmit_limit_) {
+            retransmission_count_++;
+            return true;
+        }
+    }
+
+    retransmission_count_ = 0;
+    return false;
+}
+
+
+void Loconet_aimd_txmgr::set_retransmit()
+{
+    retransmit_flag_ = true;
+
+    // Multiplicative decrease; any rate increase now comes additively
+    slow_start_ = false;
+    clean_count_ = 0;
+
+    set_rate(rate_ / 2);
+
+    next_tx_time_ = last_tx_time_ + tx_delay_;
+}
+
+
+void Loconet_aimd_txmgr::set_transmitted(const Runtime_ms current_time_ms)
+{
+    last_tx_time_ = current_time_ms;
+
+    if(++clean_count_ >= window_) {
+        clean_count_ = 0;
+
+        if(slow_start_) {
+            set_rate(rate_ * 2);
+
+            if(rate_ >= max_rate_) {
+                slow_start_ = false;
+            }
+        }
+        else {
+            set_rate(rate_ + rate_step_);
+        }
+    }
+
+    next_tx_time_ = last_tx_time_ + tx_delay_;
+}
+
+
+void Loconet_aimd_txmgr::add_tx_delay(const Runtime_ms delay)
+{
+    next_tx_time_ += delay;
+}
+
+
+void Loconet_aimd_txmgr::set_slow_duration(const Runtime_ms)
+{
+    slow_start_ = true;
+    clean_count_ = 0;
+
+    set_rate(min_rate_);
+}
+
+
+/**
+ * Sets the rate, limited to the configured range, and the corresponding
+ * inter-message delay
+ */
+void Loconet_aimd_txmgr::set_rate(uint16_t rate)
+{
+    if(rate < min_rate_) {
+        rate = min_rate_;
+    }
+    else if(rate > max_rate_) {
+        rate = max_rate_;
+    }
+
+    rate_ = rate;
+    tx_delay_ = 1000 / rate_;
+}
+
+
+} // namespace mr_signals
@@ -0,0 +1,135 @@
+/*
+ * loconet_aimd_txmgr.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_LOCONET_LOCONET_AIMD_TXMGR_H_
+#define SRC_LOCONET_LOCONET_AIMD_TXMGR_H_
+
+#include <stdint.h>
+
+#include "loconet_adapter_interface.h"
+
+namespace mr_signals {
+
+
+/**
+ * LocoNet Transmission Manager that adapts its transmit rate to the command
+ * station (additive increase, multiplicative decrease)
+ *
+ * The rate is held in messages per second, between the rates given by the
+ * slowest and fastest inter-message delays.
+ *
+ * 1. Slow start: transmission starts at the slowest rate, which doubles after
+ *    every window of messages sent without a retransmit request (i.e. no
+ *    LONG_ACK or transmission error).  Slow start ends when the fastest rate
+ *    is reached or on the first retransmit request, so its length depends on
+ *    the traffic the command station has accepted rather than on a timer.
+ * 2. Congestion avoidance: the rate increases by rate_step after every clean
+ *    window of messages.
+ * 3. On a retransmit request the rate is halved, and the next message is
+ *    spaced by the new (longer) delay.
+ * 4. As with Loconet_txmgr, the number of sequential retransmits is limited.
+ *
+ * Messages are spaced from the time they were transmitted (set_transmitted()),
+ * so idle time does not build up a burst of transmit opportunities.
+ *
+ * Expected calling strategy is as for Loconet_txmgr, with a call to
+ * set_transmitted() after each message is passed to LocoNet.
+ */
+
+class Loconet_aimd_txmgr : public Loconet_txmgr_interface
+{
+
+public:
+
+    static const Runtime_ms min_tx_delay_default;      // ms
+    static const Runtime_ms max_tx_delay_default;      // ms
+    static const uint8_t    window_default;            // messages
+    static const uint8_t    rate_step_default;         // messages per second
+    static const uint8_t    retransmit_limit_default;
+
+    /**
+     * Constructor for the transmission manager
+     *
+     * @param min_tx_delay      -   Shortest inter-message delay (ms), setting the fastest rate
+     * @param max_tx_delay      -   Longest inter-message delay (ms); the rate on startup
+     *                              and the slowest that backing off reaches
+     * @param window            -   Number of messages without a retransmit before the rate is increased
+     * @param rate_step         -   Additive rate increase (messages per second) after slow start
+     * @param retransmit_limit  -   Maximum number of retransmissions for a single message
+     */
+    Loconet_aimd_txmgr( Runtime_ms min_tx_delay     = min_tx_delay_default,
+                        Runtime_ms max_tx_delay     = max_tx_delay_default,
+                        uint8_t window              = window_default,
+                        uint8_t rate_step           = rate_step_default,
+                        uint8_t retransmit_limit    = retransmit_limit_default);
+
+    /**
+     * @return true if the delay since the last transmission has elapsed
+     */
+    bool is_tx_allowed(const Runtime_ms curr_time) override;
+
+    /**
+     * @return true - retransmit last message (up to retransmit_limit times in a row)
+     *         false - send next message
+     */
+    bool is_retransmission() override;
+
+    /**
+     * Flags a retransmission and halves the rate
+     */
+    void set_retransmit() override;
+
+    /**
+     * Spaces the next transmission from this one, and counts the message
+     * towards the next rate increase
+     */
+    void set_transmitted(const Runtime_ms curr_time) override;
+
+    void add_tx_delay(const Runtime_ms delay) override;
+
+    /**
+     * Restarts slow start from the slowest rate (e.g. when the command
+     * station may have been reset).  The time is not used.
+     */
+    void set_slow_duration(const Runtime_ms curr_time) override;
+
+    /// Current transmit rate in messages per second
+    uint16_t get_rate() const { return rate_; }
+
+    /// Current inter-message delay in ms
+    Runtime_ms get_tx_delay() const { return tx_delay_; }
+
+    bool is_slow_start() const { return slow_start_; }
+
+
+protected:
+
+    void set_rate(uint16_t rate);
+
+    Runtime_ms next_tx_time_;           // The next time stamp to transmit at
+    Runtime_ms last_tx_time_;           // Time of the last transmission
+    Runtime_ms tx_delay_;               // Current inter-message delay (1000 / rate_)
+
+    uint16_t rate_;                     // Current rate in messages per second
+    uint16_t min_rate_;                 // Rate with max_tx_delay
+    uint16_t max_rate_;                 // Rate with min_tx_delay
+
+    bool slow_start_;                   // Rate doubles each window while set
+    bool retransmit_flag_;              // Flag to indicate that a retransmission is required
+    uint8_t retransmission_count_;      // Count of sequential retransmission indications
+    uint8_t clean_count_;               // Messages since the last rate change or retransmit
+
+    uint8_t window_;
+    uint8_t rate_step_;
+    uint8_t retransmit_limit_;
+};
+
+
+}
+
+
+
+#endif /* SRC_LOCONET_LOCONET_AIMD_TXMGR_H_ */
@@ -0,0 +1,253 @@
+/*
+ * loconet_capture.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <string.h>
+
+#include "loconet_capture.h"
+#include "mr_signals.h"
+
+#ifndef ARDUINO
+#include "arduino_mock.h"   // millis() for unit tests not on Arduino
+#endif
+
+namespace mr_signals {
+
+
+// Define static constant members for external use
+const std::size_t Loconet_capture::capacity;
+const uint8_t     Loconet_capture::header_size;
+const uint8_t     Loconet_capture::version;
+const uint8_t     Loconet_capture::max_message_size;
+const uint8_t     Loconet_capture::max_record_size;
+
+Loconet_capture* Loconet_capture::active_ = nullptr;
+
+
+namespace {
+
+const uint8_t header[Loconet_capture::header_size] = { 'L', 'N', 'C', Loconet_capture::version };
+
+const uint32_t max_delta_ms = 0x7FFFFFFF;   // Keeps the shifted time in 32 bits
+
+void write_bytes(Trace_output& out, const uint8_t* bytes, std::size_t count)
+{
+#ifdef ARDUINO
+    out.write(bytes, count);
+#else
+    out.write((const char*)bytes, count);
+#endif
+}
+
+}
+
+
+Loconet_capture::Loconet_capture() : last_time_ms_(millis()), dropped_(0), header_written_(false)
+{
+}
+
+Loconet_capture::~Loconet_capture()
+{
+    if(this == active_) {
+        active_ = nullptr;
+    }
+}
+
+void Loconet_capture::set_active(Loconet_capture* capture)
+{
+    active_ = capture;
+}
+
+Loconet_capture* Loconet_capture::get_active()
+{
+    return active_;
+}
+
+uint8_t Loconet_capture::message_size(const uint8_t* message)
+{
+    if(!(message[0] & 0x80)) {
+        return 0;       // Not an opcode
+    }
+
+    uint8_t size = ((message[0] & 0x60) == 0x60) ? message[1] : ((message[0] & 0x60) >> 4) + 2;
+
+    return (size >= 2 && size <= max_message_size) ? size : 0;
+}
+
+bool Loconet_capture::record(const Loconet_capture_direction direction, const uint8_t* message)
+{
+    const uint8_t size = message_size(message);
+
+    if(0 == size) {
+        return false;
+    }
+
+    const uint32_t time_ms = millis();
+    uint32_t delta_ms = time_ms - last_time_ms_;
+
+    if(delta_ms > max_delta_ms) {
+        delta_ms = max_delta_ms;
+    }
+
+    uint8_t bytes[max_record_size];
+    uint8_t length = 0;
+    uint32_t value = (delta_ms << 1) | (uint8_t)direction;
+
+    while(value >= 0x80) {
+        bytes[length++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    bytes[length++] = (uint8_t)value;
+
+    memcpy(&bytes[length], message, size);
+
+    if(Loconet_capture_direction::tx == direction) {
+        uint8_t checksum = 0xFF;
+
+        for(uint8_t i = 0; i < size - 1; i++) {
+            checksum ^= message[i];
+        }
+        bytes[length + size - 1] = checksum;
+    }
+
+    length += size;
+
+    if(!bytes_.enqueue(bytes, length)) {
+        if(dropped_ < UINT16_MAX) {
+            dropped_++;
+        }
+        return false;
+    }
+
+    last_time_ms_ = time_ms;
+
+    return true;
+}
+
+std::size_t Loconet_capture::head_record_size() const
+{
+    std::size_t length = 0;
+
+    while(length < bytes_.size() && (bytes_.at(length) & 0x80)) {
+        length++;
+    }
+    length++;   // Last byte of the time
+
+    uint8_t message[2] = { bytes_.at(length), 0 };
+
+    if(length + 1 < bytes_.size()) {
+        message[1] = bytes_.at(length + 1);
+    }
+
+    return length + message_size(message);
+}
+
+std::size_t Loconet_capture::dump(Trace_output& out, std::size_t max_bytes)
+{
+    std::size_t written = 0;
+
+    if(!header_written_) {
+        if(max_bytes < header_size) {
+            return 0;
+        }
+
+        write_bytes(out, header, header_size);
+        written = header_size;
+        header_written_ = true;
+    }
+
+    // Records are only enqueued whole, so the ring always starts with a record
+    uint8_t bytes[max_record_size];
+
+    while(bytes_.size()) {
+        std::size_t length = head_record_size();
+
+        if(written + length > max_bytes) {
+            break;
+        }
+
+        bytes_.dequeue(bytes, length);
+        write_bytes(out, bytes, length);
+        written += length;
+    }
+
+    return written;
+}
+
+
+///////////////////////////////////////////////////
+
+
+Loconet_capture_reader::Loconet_capture_reader(const uint8_t* bytes, std::size_t size) :
+        bytes_(bytes), size_(size), position_(0), time_ms_(0), error_(false)
+{
+    rewind();
+}
+
+void Loconet_capture_reader::rewind()
+{
+    time_ms_ = 0;
+    error_ = (size_ < Loconet_capture::header_size || 0 != memcmp(bytes_, header, Loconet_capture::header_size));
+    position_ = Loconet_capture::header_size;
+}
+
+bool Loconet_capture_reader::next(Loconet_capture_entry& entry)
+{
+    if(error_ || position_ >= size_) {
+        return false;
+    }
+
+    uint32_t value = 0;
+    uint8_t shift = 0;
+
+    for(;;) {
+        if(position_ >= size_ || shift > 28) {
+            error_ = true;
+            return false;
+        }
+
+        uint8_t byte = bytes_[position_++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+
+        if(!(byte & 0x80)) {
+            break;
+        }
+    }
+
+    uint8_t size = (position_ + 1 < size_) ? Loconet_capture::message_size(&bytes_[position_]) : 0;
+
+    if(0 == size || position_ + size > size_) {
+        error_ = true;
+        return false;
+    }
+
+    time_ms_ += value >> 1;
+
+    entry.time_ms = time_ms_;
+    entry.direction = (Loconet_capture_direction)(value & 1);
+    entry.size = size;
+    memcpy(entry.message, &bytes_[position_], size);
+
+    position_ += size;
+
+    return true;
+}
+
+
+///////////////////////////////////////////////////
+
+
+void capture_loconet(const Loconet_capture_direction direction, const uint8_t* message)
+{
+    Loconet_capture* capture = Loconet_capture::get_active();
+
+    if(capture) {
+        capture->record(direction, message);
+    }
+}
+
+
+}   // namespace mr_signals
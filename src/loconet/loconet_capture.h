@@ -0,0 +1,155 @@
+/*
+ * loconet_capture.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_LOCONET_LOCONET_CAPTURE_H_
+#define SRC_LOCONET_LOCONET_CAPTURE_H_
+
+#include <stdint.h>
+#include <cstddef>      // std::size_t
+
+#include "../base/circular_buffer.h"
+#include "../mr_signals_config.h"  // MR_SIGNALS_CAPTURE_BYTES
+#include "../base/trace.h"      // Trace_output
+
+namespace mr_signals {
+
+
+/// Direction of a captured LocoNet message
+enum class Loconet_capture_direction : uint8_t
+{
+    rx = 0,     /// Received by the adapter
+    tx = 1      /// Sent by the adapter
+};
+
+
+/**
+ * Compact binary capture of the LocoNet messages received and sent by the
+ * adapter, for replaying real bus traffic on a host
+ *
+ * A capture starts with the 4 byte header "LNC" and the format version (1),
+ * followed by one record per message:
+ *
+ *  - Time since the previous record (or since the capture was started) in
+ *    ms, shifted left one bit with the direction in bit 0, as a base 128
+ *    varint (least significant 7 bits first, bit 7 set on all but the last
+ *    byte).  Messages less than 64ms apart take a single byte.
+ *  - The message bytes, including the checksum.  Their number follows from
+ *    the opcode as for getLnMsgSize().
+ *
+ * Records are written to a RAM ring by record(), normally through
+ * capture_loconet() from the adapter, and written out with dump() when the
+ * sketch is idle.  Messages that do not fit are dropped and counted, and the
+ * time until the next record includes them.
+ *
+ * Example
+ *
+ * Loconet_capture ln_capture;
+ *
+ * setup()  { Loconet_capture::set_active(&ln_capture); }
+ * loop()   { ...; ln_capture.dump(Serial, 32); }
+ */
+class Loconet_capture {
+public:
+
+    static const std::size_t capacity = MR_SIGNALS_CAPTURE_BYTES;
+    static const uint8_t header_size = 4;
+    static const uint8_t version = 1;
+    static const uint8_t max_message_size = 16;     // sizeof(lnMsg)
+    static const uint8_t max_record_size = 5 + max_message_size;
+
+    /// Start a capture at millis()
+    Loconet_capture();
+    ~Loconet_capture();
+
+    /// Set the capture that capture_loconet() writes to; nullptr to stop capturing
+    static void set_active(Loconet_capture* capture);
+    static Loconet_capture* get_active();
+
+    /**
+     * Record a message at millis().  The checksum of a sent message is
+     * calculated as the adapter queues messages without it.
+     * @return false if the message did not fit and was dropped
+     */
+    bool record(const Loconet_capture_direction direction, const uint8_t* message);
+
+    /**
+     * Write up to max_bytes of the capture to out, removing them from the
+     * ring.  The header is written before the first record.  Only whole
+     * records are written.
+     * @return The number of bytes written
+     */
+    std::size_t dump(Trace_output& out, std::size_t max_bytes = SIZE_MAX);
+
+    /// Bytes held
+    std::size_t size() const { return bytes_.size(); }
+
+    /// Number of messages dropped as the ring was full
+    uint16_t dropped() const { return dropped_; }
+
+    /// Size of a LocoNet message from its opcode and size byte (0 if invalid)
+    static uint8_t message_size(const uint8_t* message);
+
+private:
+
+    /// Size of the record at the head of the ring
+    std::size_t head_record_size() const;
+
+    Circular_buffer<uint8_t, capacity> bytes_;
+    uint32_t last_time_ms_;     // Time of the last record
+    uint16_t dropped_;
+    bool header_written_;
+
+    static Loconet_capture* active_;
+};
+
+
+/// A message read from a capture
+struct Loconet_capture_entry {
+    uint32_t time_ms;           /// Time since the capture was started
+    Loconet_capture_direction direction;
+    uint8_t size;
+    uint8_t message[Loconet_capture::max_message_size];
+};
+
+
+/**
+ * Reads the messages of a capture written by Loconet_capture::dump()
+ */
+class Loconet_capture_reader {
+public:
+
+    /// Read the capture held in bytes; the bytes must outlive the reader
+    Loconet_capture_reader(const uint8_t* bytes, std::size_t size);
+
+    /**
+     * Read the next message
+     * @return false at the end of the capture, or if it is not valid
+     */
+    bool next(Loconet_capture_entry& entry);
+
+    /// Start again from the first message
+    void rewind();
+
+    /// true if the header was wrong or a record was truncated or invalid
+    bool error() const { return error_; }
+
+private:
+    const uint8_t* bytes_;
+    std::size_t size_;
+    std::size_t position_;
+    uint32_t time_ms_;
+    bool error_;
+};
+
+
+/// Record a message to the active Loconet_capture, if any
+void capture_loconet(const Loconet_capture_direction direction, const uint8_t* message);
+
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_LOCONET_LOCONET_CAPTURE_H_ */
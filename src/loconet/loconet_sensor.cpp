@@ -6,6 +6,7 @@
  */
 #include <string.h>
 #include "loconet_sensor.h"
+#include "../base/change_listener.h"
 
 namespace mr_signals {
 
@@ -22,7 +23,15 @@ namespace mr_signals {
  */
 Loconet_sensor::Loconet_sensor(const char *name, const Loconet_address address, Loconet_adapter_interface& ln_adapter) :
         address_(address)
+#if MR_SIGNALS_SENSOR_STORE
+        , state_store_(ln_adapter.get_sensor_state_store()), slot_(Sensor_state_store::no_slot)
+#endif
 {
+#if MR_SIGNALS_SENSOR_STORE
+    if(state_store_) {
+        slot_ = state_store_->add();
+    }
+#endif
 
     // Ensure this sensor is observing the Loconet adapter
     ln_adapter.attach_sensor(this);
@@ -50,13 +59,50 @@ bool Loconet_sensor::notify(const Loconet_address address, const bool state)
     bool this_sensor = false;
 
     if(address == address_) {
-        set_state(state);       // Sensor_base::set_state()
+        set_state(state);       // Store or Sensor_base::set_state()
         this_sensor = true;
     }
 
     return this_sensor;
 }
 
+bool Loconet_sensor::is_active()
+{
+#if MR_SIGNALS_SENSOR_STORE
+    if(Sensor_state_store::no_slot != slot_) {
+        return state_store_->is_active(slot_);
+    }
+#endif
+
+    return Sensor_base::is_active();
+}
+
+bool Loconet_sensor::is_indeterminate() const
+{
+#if MR_SIGNALS_SENSOR_STORE
+    if(Sensor_state_store::no_slot != slot_) {
+        return state_store_->is_indeterminate(slot_);
+    }
+#endif
+
+    return Sensor_base::is_indeterminate();
+}
+
+bool Loconet_sensor::set_state(const bool state)
+{
+#if MR_SIGNALS_SENSOR_STORE
+    if(Sensor_state_store::no_slot != slot_) {
+        if(state_store_->set_state(slot_, state)) {
+            Change_listener::notify(static_cast<const Sensor_interface*>(this));
+            return true;
+        }
+        return false;
+    }
+#endif
+
+    return Sensor_base::set_state(state);
+}
+
 Loconet_address Loconet_sensor::get_address() const
 {
     return address_;
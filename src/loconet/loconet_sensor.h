@@ -10,6 +10,7 @@
 #define SRC_LOCONET_LOCONET_SENSOR_H_
 
 #include "sensor_interface.h"
+#include "../base/sensor_state_store.h"
 #include "loconet_adapter_interface.h"
 
 namespace mr_signals {
@@ -27,6 +28,13 @@ namespace mr_signals {
  * This is done in the constructor to ensure that any declared sensor
  * is always subscribed to updates from the loconet adapter
  *
+ * With MR_SIGNALS_SENSOR_STORE, if the adapter keeps a Sensor_state_store
+ * (get_sensor_state_store()), the sensor is allocated a slot in it and its
+ * state is held there instead of in Sensor_base, so that the adapter can check
+ * or query the states of all its sensors a word at a time.  Each sensor refers
+ * to the store of its own adapter.  If the store is full the sensor holds its
+ * own state.
+ *
  */
 class Loconet_sensor : public Sensor_base {
 public:
@@ -36,6 +44,24 @@ public:
     /// Notifies the sensor that its state has been changed
     bool notify(const Loconet_address address, const bool state);
 
+    bool is_active() override;
+
+    bool is_indeterminate() const override;
+
+    /**
+     * Sets the state of the sensor, in the state store if it has a slot
+     * \param state - true/false = active/inactive
+     * \return true if the sensor's state changed
+     */
+    bool set_state(const bool state) override;
+
+    /// Slot of the sensor in the state store, or Sensor_state_store::no_slot
+#if MR_SIGNALS_SENSOR_STORE
+    Sensor_slot get_slot() const { return slot_; }
+#else
+    Sensor_slot get_slot() const { return Sensor_state_store::no_slot; }
+#endif
+
     /// Get the address assigned at constructor for this sensor
     Loconet_address get_address() const;
 
@@ -50,6 +76,14 @@ private:
 
     /// Loconet address of the sensor
     Loconet_address address_;
+
+#if MR_SIGNALS_SENSOR_STORE
+    /// Store of the adapter holding the state of the sensor, nullptr if none
+    Sensor_state_store* state_store_;
+
+    /// Slot in state_store_ holding the state of the sensor
+    Sensor_slot slot_;
+#endif
 };
 
 
@@ -21,7 +21,7 @@ Loconet_switch::Loconet_switch(const Loconet_address address, Loconet_adapter_in
     ln_adapter_ = ln_adapter;
 }
 
-bool Loconet_switch::request_direction(const Switch_direction direction) {
+bool Loconet_switch::request_direction(const Switch_direction direction, const Switch_priority priority) {
 
 
     // Store switch direction
@@ -30,11 +30,22 @@ bool Loconet_switch::request_direction(const Switch_direction direction) {
     // Send switch request with argument 'on'
     bool result = ln_adapter_ -> send_opc_sw_req(   address_,
                                                     Switch_direction::thrown == current_direction_ ? true : false,
-                                                    true);
+                                                    true,
+                                                    priority);
 
     if(result) {
-        // If the 'on' command is successfully stored, determine when to request the 'off' command
-        send_off_time_ms_ = ln_adapter_->get_time_ms() + on_off_delay_timer_ms_;
+        // If the 'on' command is successfully stored, schedule the 'off' command
+        // (replacing any 'off' still pending for a previous direction)
+        Runtime_ms off_time_ms = ln_adapter_->get_time_ms() + on_off_delay_timer_ms_;
+        Timer_service* timer_service = ln_adapter_->get_timer_service();
+
+        if(timer_service) {
+            timer_service->schedule(*this, off_time_ms);
+        }
+        else {
+            // No timer service; loop() polls for the time to send
+            send_off_time_ms_ = off_time_ms;
+        }
     }
 
     return(result);
@@ -45,27 +56,35 @@ bool Loconet_switch::request_direction(const Switch_direction direction) {
  */
 void Loconet_switch::loop() {
 
+    // Only used when the adapter has no timer service
     if(send_off_time_ms_) {
 
         if(ln_adapter_->get_time_ms() >= send_off_time_ms_) {
 
-            // Time to send, check that our switch direction makes sense
-            if( (Switch_direction::closed == current_direction_) ||
-                (Switch_direction::thrown == current_direction_))
-            {
-                // Ignore the return code; if this fails, just give up and leave the physical
-                // switch in an indeterminate state
-                (void)  ln_adapter_ -> send_opc_sw_req( address_,
-                                                        Switch_direction::thrown == current_direction_ ? true : false,
-                                                        false);
-            }
-
             // Clear flag
             send_off_time_ms_ = 0;
+
+            on_timer(ln_adapter_->get_time_ms());
         }
     }
 }
 
+/**
+ * Timer scheduled by request_direction() to send the 'off' command
+ */
+void Loconet_switch::on_timer(const Runtime_ms) {
+
+    // Time to send, check that our switch direction makes sense
+    if( (Switch_direction::closed == current_direction_) ||
+        (Switch_direction::thrown == current_direction_))
+    {
+        // Ignore the return code; if this fails, just give up and leave the physical
+        // switch in an indeterminate state
+        (void)  ln_adapter_ -> send_opc_sw_req( address_,
+                                                Switch_direction::thrown == current_direction_ ? true : false,
+                                                false);
+    }
+}
 
 
 } // namespace mr_signals
@@ -29,10 +29,15 @@ namespace mr_signals {
  * LocoNet switch commands (OPC_SW_REQ) are sent with an on and off argument.
  * The command is first sent with the on argument, and then followed by the
  * same command with 'off' approximately 60ms later.  The second 'off'
- * command is sent automatically in the loop() function so that the
- * caller only uses the request_direction() API
+ * command is sent automatically from a timer scheduled with the adapter's
+ * Timer_service, so that the caller only uses the request_direction() API.
+ * If the adapter has no Timer_service, the loop() function polls for the
+ * time to send the 'off' command instead.
+ *
+ * The 'on' command is sent with the priority passed to request_direction();
+ * the 'off' command is always sent with normal priority.
  */
-class Loconet_switch : public Switch_interface {
+class Loconet_switch : public Switch_interface, Timer_interface {
 
 public:
     /**
@@ -45,16 +50,24 @@ public:
     /**
      * Requests the direction of the switch be set
      * @param direction thrown or closed
+     * @param priority urgent if the command should be sent ahead of others
      * @return true if the command was successfully enqueued, false if not
      * (caller should retry)
      */
-    bool request_direction(const Switch_direction direction) override;
+    bool request_direction(const Switch_direction direction,
+                           const Switch_priority priority = Switch_priority::normal) override;
 
     /**
-     * Periodic processing loop of the switch
+     * Periodic processing loop of the switch; sends the 'off' command if the
+     * adapter has no timer service (otherwise on_timer() sends it)
      */
     void loop() override;
 
+    /**
+     * Sends the 'off' command for the current direction
+     */
+    void on_timer(const Runtime_ms curr_time) override;
+
 private:
     /// static global for the class; each instance refers to the same
     static Loconet_adapter_interface* ln_adapter_;
@@ -63,8 +76,8 @@ private:
     Loconet_address address_;
 
     /// Time at which this switch will send the 'off' state corresponding
-    /// to the on that was previously sent
-    /// 0 means there is no penindg off to send
+    /// to the on that was previously sent, when the adapter has no timer service
+    /// 0 means there is no pending off to send
     Runtime_ms send_off_time_ms_;
 
     /// Current direction of the switch (used for sending
@@ -0,0 +1,139 @@
+/*
+ * loconet_token_bucket_txmgr.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "loconet_token_bucket_txmgr.h"
+
+namespace mr_signals {
+
+
+// Define static constant members for external use
+const Runtime_ms Loconet_token_bucket_txmgr::tx_interval_default       = 20;       // ms
+const uint8_t    Loconet_token_bucket_txmgr::burst_depth_default       = 8;        // messages
+const Runtime_ms Loconet_token_bucket_txmgr::slow_tx_delay_default     = 200;      // ms
+const Runtime_ms Loconet_token_bucket_txmgr::slow_tx_duration_default  = 20000;    // ms
+const uint8_t    Loconet_token_bucket_txmgr::retransmit_limit_default  = 3;
+
+
+
+Loconet_token_bucket_txmgr::Loconet_token_bucket_txmgr( Runtime_ms tx_interval,
+                                                        uint8_t burst_depth,
+                                                        Runtime_ms slow_tx_delay,
+                                                        Runtime_ms slow_duration,
+                                                        uint8_t retransmit_limit) :
+
+                                tokens_(burst_depth ? burst_depth : 1), refill_time_(0),
+                                hold_until_(0), last_tx_time_(0),
+                                retransmit_flag_(false), retransmission_count_(0),
+
+                                tx_interval_(tx_interval ? tx_interval : 1),
+                                burst_depth_(burst_depth ? burst_depth : 1),
+                                slow_tx_delay_(slow_tx_delay ? slow_tx_delay : 1),
+                                slow_tx_duration_(slow_duration),
+                                retransmit_limit_(retransmit_limit),
+                                slow_duration_end_(0)
+{
+
+}
+
+
+bool Loconet_token_bucket_txmgr::is_tx_allowed(const Runtime_ms current_time_ms)
+{
+    refill(current_time_ms);
+
+    return (tokens_ > 0 && current_time_ms >= hold_until_);
+}
+
+
+bool Loconet_token_bucket_txmgr::is_retransmission()
+{
+    if(retransmit_flag_) {
+        retransmit_flag_ = false;
+
+        // Count and limit the number of sequential retransmission indications
+
+        if(retransmission_count_ < retransmit_limit_) {
+            retransmission_count_++;
+            return true;
+        }
+    }
+
+    retransmission_count_ = 0;
+    return false;
+}
+
+
+void Loconet_token_bucket_txmgr::set_retransmit()
+{
+    retransmit_flag_ = true;
+
+    add_tx_delay(slow_tx_delay_);
+
+    // One token for the retransmission at the end of the delay; no burst follows it.
+    // It is gained at the interval refill() uses then, which is slower while slow
+    Runtime_ms interval = (hold_until_ < slow_duration_end_) ? slow_tx_delay_ : tx_interval_;
+
+    tokens_ = 0;
+    refill_time_ = (hold_until_ > interval) ? (hold_until_ - interval) : 0;
+}
+
+
+void Loconet_token_bucket_txmgr::set_transmitted(const Runtime_ms current_time_ms)
+{
+    refill(current_time_ms);
+
+    if(tokens_) {
+        tokens_--;
+    }
+
+    last_tx_time_ = current_time_ms;
+}
+
+
+void Loconet_token_bucket_txmgr::add_tx_delay(const Runtime_ms delay)
+{
+    hold_until_ = ((hold_until_ > last_tx_time_) ? hold_until_ : last_tx_time_) + delay;
+}
+
+
+void Loconet_token_bucket_txmgr::set_slow_duration(const Runtime_ms curr_time)
+{
+    slow_duration_end_ = curr_time + slow_tx_duration_;
+}
+
+
+/**
+ * Adds the tokens gained since the last refill.  During the slow period the
+ * bucket holds one token, gained every slow_tx_delay_.
+ */
+void Loconet_token_bucket_txmgr::refill(const Runtime_ms current_time_ms)
+{
+    bool slow = (current_time_ms < slow_duration_end_);
+
+    Runtime_ms interval = slow ? slow_tx_delay_ : tx_interval_;
+    uint8_t depth = slow ? 1 : burst_depth_;
+
+    if(current_time_ms >= refill_time_) {
+
+        Runtime_ms gained = (current_time_ms - refill_time_) / interval;
+
+        if(tokens_ + gained >= depth) {
+            // Full; tokens are not gained while the bucket is full
+            tokens_ = depth;
+            refill_time_ = current_time_ms;
+        }
+        else {
+            tokens_ += gained;
+            refill_time_ += gained * interval;
+        }
+    }
+
+    if(tokens_ > depth) {
+        tokens_ = depth;
+    }
+}
+
+
+} // namespace mr_signals
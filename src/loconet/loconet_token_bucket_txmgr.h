@@ -0,0 +1,126 @@
+/*
+ * loconet_token_bucket_txmgr.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_LOCONET_LOCONET_TOKEN_BUCKET_TXMGR_H_
+#define SRC_LOCONET_LOCONET_TOKEN_BUCKET_TXMGR_H_
+
+#include <stdint.h>
+
+#include "loconet_adapter_interface.h"
+
+namespace mr_signals {
+
+
+/**
+ * LocoNet Transmission Manager that allows short bursts of messages
+ * back-to-back while limiting the long-run rate (token bucket)
+ *
+ * The bucket holds up to burst_depth tokens and gains one every tx_interval
+ * ms.  Each transmitted message takes a token, so after an idle period up
+ * to burst_depth messages are sent without delay, and sustained traffic is
+ * sent at one message per tx_interval.
+ *
+ * As with Loconet_txmgr:
+ *
+ * 1. For a period after set_slow_duration(), messages are sent one at a time
+ *    (a bucket of one token) with the slow delay between them
+ * 2. If a retransmit is requested, the number of sequential retransmits is
+ *    limited to avoid an infinite loop
+ * 3. If a retransmit is requested, the slow delay is added before the next
+ *    message, and the bucket is emptied so no burst follows it
+ *
+ * Expected calling strategy is as for Loconet_txmgr, with a call to
+ * set_transmitted() after each message is passed to LocoNet (the token is
+ * taken then, so loops with nothing to send do not use tokens).
+ */
+
+class Loconet_token_bucket_txmgr : public Loconet_txmgr_interface
+{
+
+public:
+
+    static const Runtime_ms tx_interval_default;       // ms
+    static const uint8_t    burst_depth_default;       // messages
+    static const Runtime_ms slow_tx_delay_default;     // ms
+    static const Runtime_ms slow_tx_duration_default;  // ms
+    static const uint8_t    retransmit_limit_default;
+
+    /**
+     * Constructor for the transmission manager
+     *
+     * @param tx_interval       -   Time to gain a token (ms); the sustained inter-message delay
+     * @param burst_depth       -   Maximum number of tokens; messages sent back-to-back after idle
+     * @param slow_tx_delay     -   Inter-message delay while transmitting slowly, and the
+     *                              delay added for a retransmission (ms)
+     * @param slow_duration     -   Period (from set_slow_duration()) of slow transmission (ms)
+     * @param retransmit_limit  -   Maximum number of retransmissions for a single message
+     */
+    Loconet_token_bucket_txmgr( Runtime_ms tx_interval   = tx_interval_default,
+                                uint8_t burst_depth         = burst_depth_default,
+                                Runtime_ms slow_tx_delay    = slow_tx_delay_default,
+                                Runtime_ms slow_duration    = slow_tx_duration_default,
+                                uint8_t retransmit_limit    = retransmit_limit_default);
+
+    /**
+     * @return true if a token is available and no delay is pending
+     */
+    bool is_tx_allowed(const Runtime_ms curr_time) override;
+
+    /**
+     * @return true - retransmit last message (up to retransmit_limit times in a row)
+     *         false - send next message
+     */
+    bool is_retransmission() override;
+
+    /**
+     * Flags a retransmission, delays the next message by the slow delay and
+     * empties the bucket
+     */
+    void set_retransmit() override;
+
+    /**
+     * Takes a token for the transmitted message
+     */
+    void set_transmitted(const Runtime_ms curr_time) override;
+
+    /**
+     * Adds a delay before the next transmission, from the last transmission
+     * or any delay already pending
+     */
+    void add_tx_delay(const Runtime_ms delay) override;
+
+    void set_slow_duration(const Runtime_ms curr_time) override;
+
+    /// Number of messages that may currently be sent back-to-back
+    uint8_t get_tokens() const { return tokens_; }
+
+
+protected:
+
+    void refill(const Runtime_ms curr_time);
+
+    uint8_t tokens_;                    // Tokens in the bucket
+    Runtime_ms refill_time_;            // Time the last token was gained (or the bucket was full)
+    Runtime_ms hold_until_;             // No transmission before this time
+    Runtime_ms last_tx_time_;           // Time of the last transmission
+
+    bool retransmit_flag_;              // Flag to indicate that a retransmission is required
+    uint8_t retransmission_count_;      // Count of sequential retransmission indications
+
+    Runtime_ms tx_interval_;
+    uint8_t burst_depth_;
+    Runtime_ms slow_tx_delay_;
+    Runtime_ms slow_tx_duration_;
+    uint8_t retransmit_limit_;
+    Runtime_ms slow_duration_end_;
+};
+
+
+}
+
+
+
+#endif /* SRC_LOCONET_LOCONET_TOKEN_BUCKET_TXMGR_H_ */
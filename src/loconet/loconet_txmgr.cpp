@@ -86,6 +86,11 @@ void Loconet_txmgr::set_retransmit()
 }
 
 
+void Loconet_txmgr::set_transmitted(const Runtime_ms)
+{
+}
+
+
 void Loconet_txmgr::add_tx_delay(const Runtime_ms delay)
 {
     next_tx_time_ += delay;
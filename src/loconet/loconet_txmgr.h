@@ -101,6 +101,11 @@ public:
      */
     void set_retransmit() override;
 
+    /**
+     * Not used; the delays of this manager are fixed
+     */
+    void set_transmitted(const Runtime_ms) override;
+
     /**
      * Allows a delay to be added before the next transmission (e.g. adds
      * the passed delay to the time before is_tx_allowed() will next
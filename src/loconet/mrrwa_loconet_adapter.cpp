@@ -10,6 +10,8 @@
 #include "loconet_txmgr.h"
 
 #include "mr_signals.h"
+#include "../base/trace.h"
+#include "loconet_capture.h"
 
 #include <algorithm>
 
@@ -49,12 +51,9 @@ void set_mrrwa_loconet_adapter(mr_signals::Mrrwa_loconet_adapter * const adapter
 // for all Sensor messages
 void notifySensor(uint16_t Address, uint8_t State)
 {
+    uint8_t report[3] = { (uint8_t)Address, (uint8_t)(Address >> 8), (uint8_t)(State ? 1 : 0) };
 
-#ifdef ARDUINO
-    Serial << F("Sensor: ") << Address << F(" - ") << (State ? F("Active") : F("Inactive"));
-#else
-    Serial << F("Sensor: ") << std::dec << Address << F(" - ") << (State ? F("Active") : F("Inactive"));
-#endif
+    mr_signals::trace(mr_signals::Trace_event::sensor_report, report, sizeof(report));
 
     if(nullptr!= loconet_adapter) {
         loconet_adapter->notify_sensors((mr_signals::Loconet_address)Address, State ? true : false);
@@ -64,14 +63,10 @@ void notifySensor(uint16_t Address, uint8_t State)
 void notifySwitchRequest(uint16_t Address, uint8_t output, uint8_t direction) {
 #ifdef ARDUINO
 
-    if(Address >= 1017 && Address <=1020) {
-        Serial << F("Sensor Interrogation");
-    }
-    else {
-        Serial << F("Switch: ") << Address << F(" - ") << (direction ? F("Closed") : F("Thrown"));
-    }
+    uint8_t request[4] = { (uint8_t)Address, (uint8_t)(Address >> 8),
+                           (uint8_t)(output ? 1 : 0), (uint8_t)(direction ? 1 : 0) };
 
-    Serial << F(" (Output ") << (output ? F("On") : F("Off")) << F(")");
+    mr_signals::trace(mr_signals::Trace_event::switch_request, request, sizeof(request));
 
 #else
 
@@ -94,7 +89,10 @@ Mrrwa_loconet_adapter::Mrrwa_loconet_adapter(Setup_collection& setup_collection,
                                             Loconet_txmgr_interface& tx_mgr) :
         Setup_interface(setup_collection), Loop_interface(loop_collection),
         sensor_init_size_(num_sensors), send_gp_on_time_ms_(0), next_tx_window_time_(0),msg_tx_window_count_(0),
-        tx_errors_(0), long_acks_(0), loconet_(loconet),tx_mgr_(tx_mgr),
+        tx_done_valid_(false), tx_deferred_(false),
+        urgent_burst_count_(0), tx_errors_(0), config_errors_(0), fast_retry_count_(0), fast_retry_time_(0),
+        long_acks_(0), rx_backlog_(0), rx_backlog_high_watermark_(0), rx_near_full_count_(0),
+        loconet_(loconet),tx_mgr_(tx_mgr),
         tx_pin_(tx_pin), any_sensor_indeterminate_(true)
 {
 
@@ -102,13 +100,31 @@ Mrrwa_loconet_adapter::Mrrwa_loconet_adapter(Setup_collection& setup_collection,
         sensors_.reserve(num_sensors);
     }
 
-    tx_buffer_.initialize(tx_buffer_size);
+    if(!tx_buffer_.initialize(tx_buffer_size)) {
+        config_errors_++;
+
+        const std::size_t capacity = tx_buffer_.max_size();
+        const uint16_t requested = (tx_buffer_size > UINT16_MAX) ? UINT16_MAX : tx_buffer_size;
+        uint8_t sizes[4] = { (uint8_t)requested, (uint8_t)(requested >> 8),
+                             (uint8_t)capacity, (uint8_t)(capacity >> 8) };
+        trace(Trace_event::ln_tx_buffer_size, sizes, sizeof(sizes));
+    }
+
+    for(uint16_t& count : tx_status_counts_) {
+        count = 0;
+    }
 
     // Register the adapter with the pointer used by the MRRWA callbacks
     ::set_mrrwa_loconet_adapter(this);
 
     send_gp_on_time_ms_ = get_time_ms() + POWER_ON_DELAY_MS;
 
+#if MR_SIGNALS_LOOP_TIMING
+    timers_timing_ = Loop_timing::add(&timer_service_, "ln timers");
+    rx_timing_ = Loop_timing::add(this, "ln rx");
+    tx_timing_ = Loop_timing::add(&tx_buffer_, "ln tx");
+    power_on_timing_ = Loop_timing::add(&send_gp_on_time_ms_, "ln power on");
+#endif
 }
 
 void Mrrwa_loconet_adapter::setup()
@@ -118,22 +134,60 @@ void Mrrwa_loconet_adapter::setup()
 
 void Mrrwa_loconet_adapter::loop()
 {
-    receive_loop();
+    // First, so that messages queued by the timers can be sent in this loop
+    {
+#if MR_SIGNALS_LOOP_TIMING
+        Loop_timer timer(timers_timing_);
+#endif
+        timer_service_.service(get_time_ms());
+    }
+
+    {
+#if MR_SIGNALS_LOOP_TIMING
+        Loop_timer timer(rx_timing_);
+#endif
+        receive_loop();
+    }
 
-    transmit_loop();
+    {
+#if MR_SIGNALS_LOOP_TIMING
+        Loop_timer timer(tx_timing_);
+#endif
+        transmit_loop();
+    }
 
+#if MR_SIGNALS_LOOP_TIMING
+    Loop_timer timer(power_on_timing_);
+#endif
     send_global_power_on_loop();
 }
 
 
+/**
+ * Sensors are kept sorted by address so that notify_sensors() can binary
+ * search them.  Sensors with the same address stay in the order attached.
+ */
 void Mrrwa_loconet_adapter::attach_sensor(Loconet_sensor* sensor)
 {
-    sensors_.push_back(sensor);
+    auto position = std::upper_bound(sensors_.begin(),
+        sensors_.end(),
+        sensor->get_address(),
+        [](Loconet_address address, const Loconet_sensor * attached) {
+            return address < attached->get_address();
+        });
+
+    sensors_.insert(position, sensor);
 }
 
 
 bool Mrrwa_loconet_adapter::any_sensor_indeterminate()  {
 
+#if MR_SIGNALS_SENSOR_STORE
+    // All sensors have a slot in the store unless it overflowed
+    if(sensor_states_.size() == sensors_.size()) {
+        return (0 != sensor_states_.indeterminate_count());
+    }
+#endif
 
     if(any_sensor_indeterminate_){
         for (auto sensor : sensors_) {
@@ -147,7 +201,8 @@ bool Mrrwa_loconet_adapter::any_sensor_indeterminate()  {
     return(any_sensor_indeterminate_);
 }
 
-bool Mrrwa_loconet_adapter::send_opc_sw_req(Loconet_address address, bool thrown,bool on)
+bool Mrrwa_loconet_adapter::send_opc_sw_req(Loconet_address address, bool thrown, bool on,
+                                            Switch_priority priority)
 {
     lnMsg SendPacket ;
 
@@ -160,7 +215,17 @@ bool Mrrwa_loconet_adapter::send_opc_sw_req(Loconet_address address, bool thrown
     SendPacket.data[ 1 ] = (address-1) & 0x7F ;
     SendPacket.data[ 2 ] = sw2 ;
 
-    return(tx_buffer_.queue_loconet_msg(SendPacket));
+    // Update superseded requests in both lanes, so that neither sends a
+    // stale direction after this request
+    bool coalesced_urgent = urgent_tx_buffer_.coalesce_sw_req(SendPacket);
+    bool coalesced_bulk = tx_buffer_.coalesce_sw_req(SendPacket);
+
+    if(coalesced_urgent || (coalesced_bulk && Switch_priority::urgent != priority)) {
+        tx_telemetry_.record_coalesced();
+        return(true);
+    }
+
+    return(queue_loconet_msg(SendPacket, priority));
 }
 
 
@@ -179,7 +244,74 @@ bool Mrrwa_loconet_adapter::insert_ln_tx_delay(uint8_t delay_ms) {
     SendPacket.data[ 0 ] = OPC_IDLE ;
     SendPacket.data[ 1 ] = delay_ms ;
 
-    return(tx_buffer_.queue_loconet_msg(SendPacket));
+    return(queue_loconet_msg(SendPacket));
+}
+
+/**
+ * Queue a message for transmission in a lane, recording the attempt in tx_telemetry_
+ */
+bool Mrrwa_loconet_adapter::queue_loconet_msg(lnMsg& msg, Switch_priority lane)
+{
+    bool queued = false;
+
+    if(Switch_priority::urgent == lane) {
+        queued = urgent_tx_buffer_.queue_loconet_msg(msg);
+        tx_telemetry_.record_queue(queued, urgent_tx_buffer_.size(), get_time_ms(), lane);
+    }
+    else {
+        queued = tx_buffer_.queue_loconet_msg(msg);
+        tx_telemetry_.record_queue(queued, tx_buffer_.size(), get_time_ms(), lane);
+    }
+
+    return(queued);
+}
+
+/**
+ * Dequeue the next message to transmit
+ *
+ * The urgent lane has strict priority over the bulk lane, except that once
+ * MRRWA_LN_TX_URGENT_BURST urgent messages have been sent in a row while bulk
+ * messages are waiting, the next bulk message is sent.
+ *
+ * @return true if a message was dequeued
+ */
+bool Mrrwa_loconet_adapter::dequeue_loconet_msg(lnMsg& msg)
+{
+    bool return_value = false;
+
+    const uint16_t urgent_flushes = urgent_tx_buffer_.flush_count();
+    const uint16_t bulk_flushes = tx_buffer_.flush_count();
+
+    bool bulk_starved = urgent_burst_count_ >= MRRWA_LN_TX_URGENT_BURST && tx_buffer_.msg_count();
+
+    if(!bulk_starved && urgent_tx_buffer_.dequeue_loconet_msg(msg)) {
+
+        tx_telemetry_.record_dequeue(Switch_priority::urgent);
+
+        if(tx_buffer_.msg_count()) {
+            urgent_burst_count_++;
+        }
+
+        return_value = true;
+    }
+    else if(tx_buffer_.dequeue_loconet_msg(msg)) {
+
+        tx_telemetry_.record_dequeue(Switch_priority::normal);
+
+        urgent_burst_count_ = 0;
+        return_value = true;
+    }
+
+    // A lane emptied as corrupted no longer holds the messages timed in the telemetry
+    if(urgent_tx_buffer_.flush_count() != urgent_flushes) {
+        tx_telemetry_.record_flush(Switch_priority::urgent);
+    }
+
+    if(tx_buffer_.flush_count() != bulk_flushes) {
+        tx_telemetry_.record_flush(Switch_priority::normal);
+    }
+
+    return(return_value);
 }
 
 
@@ -203,20 +335,18 @@ size_t Mrrwa_loconet_adapter::sensor_init_size()
 
 void Mrrwa_loconet_adapter::notify_sensors(Loconet_address address, bool state) const
 {
-
-    std::find_if(sensors_.begin(),
+    // sensors_ is sorted by address (see attach_sensor())
+    auto position = std::lower_bound(sensors_.begin(),
         sensors_.end(),
-        [address, state](Loconet_sensor * sensor) {
-
-        if (sensor->notify(address, state)) {
-            Serial << F("\nSet Sensor ") << sensor->get_name() << " -> " << (state ? F("Active") : F("Inactive"));
-
-            return true;    // Found the sensor, stop the find_if() loop
-        }
-        else {
-            return false;   // Continue the find_if() loop
-        }
-    });
+        address,
+        [](const Loconet_sensor * sensor, Loconet_address address) {
+            return sensor->get_address() < address;
+        });
+
+    if(position != sensors_.end() && (*position)->notify(address, state)) {
+        uint8_t state_code = state ? 1 : 0;
+        trace_named(Trace_event::sensor_set, (*position)->get_name(), &state_code, 1);
+    }
 }
 
 void Mrrwa_loconet_adapter::print_lnMsg(lnMsg *ln_packet, const char *prefix, bool print_checksum)
@@ -265,19 +395,70 @@ void Mrrwa_loconet_adapter::print_lnMsg(lnMsg *ln_packet, const char *prefix, bo
 
 
 
+/**
+ * Process received packets until the receive buffer is empty, or
+ * MRRWA_LN_RX_MAX_PACKETS packets or MRRWA_LN_RX_BUDGET_US have been used
+ *
+ * The MRRWA library does not expose the occupancy of its receive buffer, so
+ * the bytes received since it was last found empty are used as an upper
+ * bound, and a nearly full buffer is counted and traced each time this
+ * reaches MRRWA_LN_RX_NEAR_FULL.
+ */
 void Mrrwa_loconet_adapter::receive_loop()
 {
-    lnMsg        *ln_packet;
+    const unsigned long start_us = micros();
+
+    for(uint8_t packets = 0; packets < MRRWA_LN_RX_MAX_PACKETS; packets++) {
+
+        if(packets && MRRWA_LN_RX_BUDGET_US && (micros() - start_us) >= MRRWA_LN_RX_BUDGET_US) {
+            break;
+        }
+
+        lnMsg *ln_packet = loconet_.receive();
+
+        if(nullptr == ln_packet) {
+            rx_backlog_ = 0;        // Caught up
+            break;
+        }
+
+        uint8_t msg_size = getLnMsgSize(ln_packet);
 
+        bool was_near_full = (rx_backlog_ >= MRRWA_LN_RX_NEAR_FULL);
 
-    ln_packet = loconet_.receive();
+        if(rx_backlog_ <= UINT16_MAX - msg_size) {
+            rx_backlog_ += msg_size;
+        }
+
+        if(rx_backlog_ > rx_backlog_high_watermark_) {
+            rx_backlog_high_watermark_ = rx_backlog_;
+        }
 
-    if(nullptr != ln_packet) {
+        if(!was_near_full && rx_backlog_ >= MRRWA_LN_RX_NEAR_FULL) {
+            if(rx_near_full_count_ < UINT16_MAX) {
+                rx_near_full_count_++;
+            }
+
+            uint8_t backlog[2] = { (uint8_t)rx_backlog_, (uint8_t)(rx_backlog_ >> 8) };
+            trace(Trace_event::ln_rx_near_full, backlog, sizeof(backlog));
+        }
 
-        print_lnMsg(ln_packet,"LN RX",true);
+        trace(Trace_event::ln_rx, ln_packet->data, msg_size);
+        capture_loconet(Loconet_capture_direction::rx, ln_packet->data);
 
         if(OPC_LONG_ACK == ln_packet->data[0]) {
             long_acks_++;
+
+            if(fast_retry_count_ && tx_done_valid_ && !tx_deferred_) {
+                // ln_msg_ was dequeued before the LONG_ACK arrived and has not been
+                // sent; retransmit the rejected message first, then send ln_msg_
+                lnMsg next_msg = ln_msg_;
+                ln_msg_ = tx_done_msg_;
+                tx_done_msg_ = next_msg;
+
+                fast_retry_count_ = 0;
+                tx_deferred_ = true;
+            }
+
 //            retransmit_ = 1;
 //            next_tx_time_ms_ += 100;
             tx_mgr_.set_retransmit();
@@ -285,7 +466,7 @@ void Mrrwa_loconet_adapter::receive_loop()
 
         loconet_.processSwitchSensorMessage(ln_packet);
 
-        Serial << endl;  // Clean up formatting
+        trace(Trace_event::line_end);   // Clean up formatting
     }
 }
 
@@ -293,28 +474,65 @@ void Mrrwa_loconet_adapter::transmit_loop()
 {
     bool transmit_msg = false;
 
-    if(tx_mgr_.is_tx_allowed(get_time_ms())) {
+    if(fast_retry_count_) {
+        // ln_msg_ was not sent due to a transient bus condition; retry it
+        // outside of the transmission manager's inter-message delay
+        transmit_msg = (get_time_ms() >= fast_retry_time_);
+    }
+    else if(tx_mgr_.is_tx_allowed(get_time_ms())) {
 
 
         if(tx_mgr_.is_retransmission()) {
             // ln_msg_ is already loaded with the last transmitted message
             transmit_msg = true;
         }
-        else if(tx_buffer_.dequeue_loconet_msg(ln_msg_)) {
+        else if(tx_deferred_) {
+            // Dequeued before a retransmission that was sent ahead of it
+            ln_msg_ = tx_done_msg_;
+            tx_deferred_ = false;
             transmit_msg = true;
         }
+        else if(dequeue_loconet_msg(ln_msg_)) {
+            transmit_msg = true;
+        }
+    }
+
+    if(transmit_msg) {
+
+        trace(Trace_event::ln_tx, ln_msg_.data, getLnMsgSize(&ln_msg_) - 1);    // Less the checksum
+
+        LN_STATUS status = loconet_.send(&ln_msg_);
+
+        if(status <= LN_RETRY_ERROR && tx_status_counts_[status] < UINT16_MAX) {
+            tx_status_counts_[status]++;
+        }
+
+        bool backoff = (LN_CD_BACKOFF == status || LN_PRIO_BACKOFF == status || LN_NETWORK_BUSY == status);
 
-        if(transmit_msg) {
+        if(backoff && fast_retry_count_ < MRRWA_LN_TX_FAST_RETRY_LIMIT) {
+            fast_retry_count_++;
+            fast_retry_time_ = get_time_ms() + MRRWA_LN_TX_FAST_RETRY_MS;
+            trace(Trace_event::ln_tx_backoff);
+        }
+        else {
+            fast_retry_count_ = 0;
 
-            print_lnMsg(&ln_msg_,"LN TX",false);
+            tx_mgr_.set_transmitted(get_time_ms());
 
-            if(LN_DONE != loconet_.send(&ln_msg_)) {
+            if(LN_DONE != status) {
                 tx_errors_++;
                 tx_mgr_.set_retransmit();
-                Serial << "-TX error" << endl;
+                trace(Trace_event::ln_tx_error);
             }
             else {
-                Serial << endl;
+                if(!tx_deferred_) {
+                    tx_done_msg_ = ln_msg_;
+                    tx_done_valid_ = true;
+                }
+
+                tx_telemetry_.record_transmit(get_time_ms());
+                capture_loconet(Loconet_capture_direction::tx, ln_msg_.data);
+                trace(Trace_event::line_end);
             }
 
             msg_tx_window_count_++;
@@ -368,104 +586,194 @@ void Mrrwa_loconet_adapter::print_sensors() const
 ///////////////////////////////////////////////////
 
 
-bool Mrrwa_loconet_tx_buffer::initialize(std::size_t buffer_size)
+Mrrwa_loconet_tx_telemetry::Mrrwa_loconet_tx_telemetry() :
+        sending_(false), sending_timed_(false), sending_time_(0)
 {
-    return(loconet_tx_buffer_.initialize(buffer_size));
+    reset();
 }
 
+void Mrrwa_loconet_tx_telemetry::reset()
+{
+    for(uint8_t bin = 0; bin < histogram_bins; bin++) {
+        occupancy_histogram_[bin] = 0;
+        latency_histogram_[bin] = 0;
+    }
+
+    queued_ = 0;
+    rejected_ = 0;
+    coalesced_ = 0;
+    transmitted_ = 0;
+    timed_ = 0;
 
-/**
- * Queues a LocoNet message for transmission onto LocoNet
- * *
- * First the length of the message is extracted from it using the MRWWA's getLnMsgSize function
- *
- * Then sanity checks on the size of the message are performed.  It is critical that the
- * loop_transmit() function can extract exactly as many bytes are queued in this function
- * to retain coherency as the LocoNet messages are encoded in the raw without any
- * container to allow a recovery from invalid data being encoded.  The loop_transmit function
- * can ignore invalid data, but it has to extract exactly the right number of bytes.
- *
- * The sanity checks include:
- *      Message not too big (larger than lnMsg)
- *      Message is at least 2 bytes long (minimum LN message)
- *
- * After the validity checks, it is checked that the message will fit into
- * loconet_tx_buffer_.
- *
- * If all checks pass, the LocoNet message is added to the loconet_tx_buffer_.
- *
- *
- * @param msg  LN Message to queue
- * @return  true if the message was queued, false otherwise
- */
+    latency_total_ = 0;
+    latency_min_ = UINT16_MAX;
+    latency_max_ = 0;
+}
 
-bool Mrrwa_loconet_tx_buffer::queue_loconet_msg(lnMsg& msg)
+void Mrrwa_loconet_tx_telemetry::record_queue(bool queued, std::size_t occupancy, Runtime_ms time_ms,
+                                              Switch_priority lane)
 {
-    bool return_value = false;
-    uint8_t msg_len = getLnMsgSize(&msg);
+    if(queued) {
+        queued_++;
+
+#if MRRWA_LN_TX_LATENCY_TRACKING
+        Lane_times& times = lane_times(lane);
 
-    // Messages longer than 2 bytes are encoded without the checksum
-    // The checksum is retained for 2 byte messages as 2 bytes are
-    // extracted for all messages as much longer messages encode
-    // their length in the second byte
-    if(msg_len > 2) {
-        msg_len--;
+        // Once a message is untimed, those behind it are too, to stay in step
+        if(times.untimed || !times.times.enqueue(static_cast<uint16_t>(time_ms))) {
+            if(times.untimed < UINT16_MAX) {
+                times.untimed++;
+            }
+        }
+#endif
     }
+    else {
+        rejected_++;
+    }
+
+    count_in_bin(occupancy_histogram_, occupancy);
 
-    if( msg_len <= sizeof(lnMsg) &&                     // Not too big
-        msg_len >= 2 &&                                 // Not too small
-        msg_len <= loconet_tx_buffer_.get_free()) {     // Can fit into the buffer
+    (void) time_ms;     // Unused without latency tracking
+    (void) lane;
+}
 
+void Mrrwa_loconet_tx_telemetry::record_dequeue(Switch_priority lane)
+{
+    sending_ = true;
+    sending_timed_ = false;
 
-        for(uint8_t i=0;i<msg_len;i++) {
-            (void) loconet_tx_buffer_.enqueue(msg.data[i]);    // Assume can enqueue if the get_free() above is large enough
-        }
+#if MRRWA_LN_TX_LATENCY_TRACKING
+    Lane_times& times = lane_times(lane);
 
-        return_value = true;
+    if(times.times.dequeue(sending_time_)) {
+        sending_timed_ = true;
+    }
+    else if(times.untimed) {
+        times.untimed--;
+    }
+#else
+    (void) lane;
+#endif
+}
+
+void Mrrwa_loconet_tx_telemetry::record_transmit(Runtime_ms time_ms)
+{
+    if(!sending_) {
+        return;     // A retransmission of a message already counted
     }
 
-    return (return_value);
+    sending_ = false;
+    transmitted_++;
+
+    if(sending_timed_) {
+        // Unsigned 16 bit subtraction handles the timestamp wrapping
+        record_latency(static_cast<uint16_t>(time_ms) - sending_time_);
+    }
 }
 
-/**
- * Dequeues a message to transmit
- *
- * If the transmit buffer is not empty, read the next Loconet message from it
- * The buffer is a stream of bytes; the length of each message is encoded in the
- * Loconet message itself.  This function is extremely dependent on valid
- * LocoNet messages being encoded into the buffer in queue_loconet_msg() to
- * ensure the correct length can be read out.
- *
- * @param msg - Loconet message to populate with the next in the queue
- * @return true if a message was dequeued, false if not
- */
+void Mrrwa_loconet_tx_telemetry::record_coalesced()
+{
+    coalesced_++;
+}
 
-bool Mrrwa_loconet_tx_buffer::dequeue_loconet_msg(lnMsg& msg)
+void Mrrwa_loconet_tx_telemetry::record_flush(Switch_priority lane)
 {
-    bool return_value = false;
+#if MRRWA_LN_TX_LATENCY_TRACKING
+    Lane_times& times = lane_times(lane);
 
-    // Check if anything is in the buffer
-    if(loconet_tx_buffer_.get_free() < loconet_tx_buffer_.max_size()) {
+    times.times.consume(times.times.size());
+    times.untimed = 0;
+#else
+    (void) lane;
+#endif
+}
 
-        // Pull the first two bytes; LN messages are always 2 or more bytes, and the command and
-        // length are encoded in these first two messages
-        loconet_tx_buffer_.dequeue(msg.data[0]);
-        loconet_tx_buffer_.dequeue(msg.data[1]);
+void Mrrwa_loconet_tx_telemetry::record_latency(uint16_t latency)
+{
+    timed_++;
+    latency_total_ += latency;
 
-        // Read any remaining message (if longer than 2 bytes) from the queue
-        // however for any messages > 2, do not read the checksum as it is
-        // not encoded
-        uint8_t msg_len = getLnMsgSize(&msg);
+    if(latency < latency_min_) {
+        latency_min_ = latency;
+    }
 
-        for(uint8_t i=2; i<msg_len-1;i++) {
-            loconet_tx_buffer_.dequeue(msg.data[i]);
-        }
-        return_value = true;
+    if(latency > latency_max_) {
+        latency_max_ = latency;
     }
 
-    return (return_value);
+    count_in_bin(latency_histogram_, latency);
+}
+
+uint16_t Mrrwa_loconet_tx_telemetry::occupancy_histogram(uint8_t bin) const
+{
+    return (bin < histogram_bins) ? occupancy_histogram_[bin] : 0;
+}
+
+uint16_t Mrrwa_loconet_tx_telemetry::latency_histogram(uint8_t bin) const
+{
+    return (bin < histogram_bins) ? latency_histogram_[bin] : 0;
+}
+
+Runtime_ms Mrrwa_loconet_tx_telemetry::latency_min() const
+{
+    return timed_ ? latency_min_ : 0;
+}
+
+Runtime_ms Mrrwa_loconet_tx_telemetry::latency_max() const
+{
+    return latency_max_;
+}
+
+Runtime_ms Mrrwa_loconet_tx_telemetry::latency_mean() const
+{
+    return timed_ ? (latency_total_ / timed_) : 0;
 }
 
+uint16_t Mrrwa_loconet_tx_telemetry::bin_lower_bound(uint8_t bin)
+{
+    return (bin == 0) ? 0 : (1U << (bin - 1));
+}
+
+uint8_t Mrrwa_loconet_tx_telemetry::bin_of(uint32_t value)
+{
+    uint8_t bin = 0;
+
+    while(value && bin < histogram_bins - 1) {
+        value >>= 1;
+        bin++;
+    }
+
+    return bin;
+}
+
+void Mrrwa_loconet_tx_telemetry::count_in_bin(uint16_t* histogram, uint32_t value)
+{
+    uint16_t& count = histogram[bin_of(value)];
+
+    if(count < UINT16_MAX) {
+        count++;
+    }
+}
+
+void Mrrwa_loconet_tx_telemetry::print() const
+{
+    Serial << F("LN TX queued: ") << queued_ << F(" rejected: ") << rejected_
+           << F(" coalesced: ") << coalesced_ << F(" transmitted: ") << transmitted_
+           << F(" (timed: ") << timed_ << F(")") << endl;
+
+    Serial << F("LN TX queue time (ms) min: ") << latency_min() << F(" max: ") << latency_max()
+           << F(" mean: ") << latency_mean() << endl;
+
+    Serial << F("Bin from   occupancy(B)   queue time(ms)") << endl;
+
+    for(uint8_t bin = 0; bin < histogram_bins; bin++) {
+        if(occupancy_histogram_[bin] || latency_histogram_[bin]) {
+            Serial << bin_lower_bound(bin) << F(":  ") << occupancy_histogram_[bin] << F("  ") << latency_histogram_[bin] << endl;
+        }
+    }
+}
+
+
 
 }   // namespace mr_signals
 
@@ -8,12 +8,14 @@
 #ifndef SRC_LOCONET_MRRWA_LOCONET_ADAPTER_H_
 #define SRC_LOCONET_MRRWA_LOCONET_ADAPTER_H_
 
-#include <vector>
+#include "../mr_signals_config.h"  // MRRWA_LN_TX_BUFFER_CAPACITY
 #include "loconet_adapter_interface.h"
 #include "setup_funcs.h"
 #include "loop_funcs.h"
 #include "loconet_sensor.h"
 #include "../base/circular_buffer.h"
+#include "../base/startup_arena.h"
+#include "mrrwa_loconet_tx_buffer.h"
 
 #ifdef ARDUINO
 
@@ -28,6 +30,43 @@
 
 #define POWER_ON_DELAY_MS 200   // Declare in public API to use in unit testing
 
+// Number of consecutive urgent messages sent while bulk messages are waiting
+// before one bulk message is sent, so that the bulk lane cannot be starved
+#ifndef MRRWA_LN_TX_URGENT_BURST
+#define MRRWA_LN_TX_URGENT_BURST 8
+#endif
+
+// Delay (ms) before retrying a message that LocoNet did not send because of a
+// transient bus condition (carrier detect or priority backoff, network busy)
+#ifndef MRRWA_LN_TX_FAST_RETRY_MS
+#define MRRWA_LN_TX_FAST_RETRY_MS 2
+#endif
+
+// Number of fast retries of one message before it is treated as a transmit
+// error (and retransmitted after the transmission manager's delay)
+#ifndef MRRWA_LN_TX_FAST_RETRY_LIMIT
+#define MRRWA_LN_TX_FAST_RETRY_LIMIT 20
+#endif
+
+// Most received packets processed by each loop().  A global power on makes
+// every detector report at once; draining several packets per loop keeps the
+// MRRWA receive buffer from overflowing while the rest of the sketch runs.
+#ifndef MRRWA_LN_RX_MAX_PACKETS
+#define MRRWA_LN_RX_MAX_PACKETS 8
+#endif
+
+// Most time (us) spent receiving in each loop(); at least one packet is always
+// processed.  Define as 0 to only limit the number of packets.
+#ifndef MRRWA_LN_RX_BUDGET_US
+#define MRRWA_LN_RX_BUDGET_US 2000
+#endif
+
+// Bytes received since the receive buffer was last found empty at which it is
+// reported as nearly full.  The MRRWA buffer (LN_BUF_SIZE) is 160 bytes.
+#ifndef MRRWA_LN_RX_NEAR_FULL
+#define MRRWA_LN_RX_NEAR_FULL 120
+#endif
+
 
 
 namespace mr_signals {
@@ -36,37 +75,142 @@ namespace mr_signals {
 
 
 /**
- * Handles the management of the LocoNet Transmit buffer for Mrrwa_loconet_adapter
+ * Records statistics on the use of the LocoNet transmit queue so that its
+ * size can be chosen from data, and a backlog seen while running
+ *
+ * - Occupancy (bytes) of the queue after each queue attempt, as a histogram
+ * - Number of messages queued, and rejected because the queue was full
+ * - Number of switch requests that replaced a superseded queued request
+ * - Time (ms) from queuing each message to its first successful send, as a
+ *   histogram and min/max/mean
  *
- * This class is private to Mrrwa_loconet_adapter and should not be accessed
- * directly at any time.
+ * Histograms use log2 bins: bin 0 counts the value 0, bin n (n>0) counts
+ * values from 2^(n-1) to 2^n - 1, and the last bin also counts everything
+ * larger.  Counts stop at their maximum rather than wrapping.
  *
+ * Queue times are only measured with MRRWA_LN_TX_LATENCY_TRACKING.  They are
+ * held as 16 bit timestamps for the oldest MRRWA_LN_TX_LATENCY_MESSAGES
+ * messages of each lane, so waits of more than 65 seconds are misreported and
+ * messages queued behind a full set of timestamps are sent untimed.  The time
+ * includes fast retries and retransmissions after a failed send.  The other
+ * statistics cover both lanes together.
  */
-class Mrrwa_loconet_tx_buffer
+class Mrrwa_loconet_tx_telemetry
 {
 public:
 
-    bool initialize(std::size_t buffer_size);
+    static const uint8_t histogram_bins = 16;
 
+    Mrrwa_loconet_tx_telemetry();
 
     /**
-     * Queue a lnMsg (Loconet message) for transmission onto LocoNet
+     * Record an attempt to queue a message
      *
-     * @param msg - The Loconet message to queue
-     * @return true if enqueued, false otherwise
+     * @param queued    - true if the message was queued, false if it was rejected
+     * @param occupancy - Number of bytes in the lane after the attempt
+     * @param time_ms   - Time of the attempt
+     * @param lane      - Lane the message was queued to
      */
-    bool queue_loconet_msg(lnMsg& msg);
+    void record_queue(bool queued, std::size_t occupancy, Runtime_ms time_ms,
+                      Switch_priority lane = Switch_priority::normal);
 
     /**
-     *  Dequeue a queued lnMsg (Loconet message)
+     * Record that the oldest message in a lane has been dequeued for transmission
      *
-     * @param msg - The dequeued message
-     * @return true if a message was dequed, false if not
+     * @param lane - Lane the message was dequeued from
      */
-    bool dequeue_loconet_msg(lnMsg& msg);
+    void record_dequeue(Switch_priority lane = Switch_priority::normal);
+
+    /**
+     * Record that a send completed (LN_DONE).  The first completed send of the
+     * last dequeued message counts it as transmitted; the sends of later
+     * retransmissions are not counted again.
+     *
+     * @param time_ms - Time of the send
+     */
+    void record_transmit(Runtime_ms time_ms);
+
+    /// Record that a switch request replaced a queued request instead of being queued
+    void record_coalesced();
+
+    /**
+     * Record that a lane was emptied without its messages being transmitted
+     * (it was found corrupted), discarding their queue times
+     *
+     * @param lane - Lane that was emptied
+     */
+    void record_flush(Switch_priority lane = Switch_priority::normal);
+
+    /// Clear all statistics except the timestamps of messages still queued or being sent
+    void reset();
+
+    uint32_t queued_count() const { return queued_; }
+    uint32_t rejected_count() const { return rejected_; }
+    uint32_t coalesced_count() const { return coalesced_; }
+    uint32_t transmitted_count() const { return transmitted_; }
+
+    /// Transmitted messages whose time in the queue was measured
+    uint32_t timed_count() const { return timed_; }
 
+    /// Count of queue attempts that left the given occupancy bin
+    uint16_t occupancy_histogram(uint8_t bin) const;
 
-    Circular_buffer loconet_tx_buffer_;
+    /// Count of transmitted messages whose time in the queue fell in the given bin
+    uint16_t latency_histogram(uint8_t bin) const;
+
+    Runtime_ms latency_min() const;
+    Runtime_ms latency_max() const;
+    Runtime_ms latency_mean() const;
+
+    /// Value range of a histogram bin (inclusive); the last bin is open ended
+    static uint16_t bin_lower_bound(uint8_t bin);
+
+    /// Bin that a value is counted in
+    static uint8_t bin_of(uint32_t value);
+
+    /**
+     * Prints the statistics using the Serial stream from mr_signals.h
+     */
+    void print() const;
+
+private:
+
+    static void count_in_bin(uint16_t* histogram, uint32_t value);
+
+    void record_latency(uint16_t latency);
+
+    uint16_t occupancy_histogram_[histogram_bins];
+    uint16_t latency_histogram_[histogram_bins];
+
+    uint32_t queued_;
+    uint32_t rejected_;
+    uint32_t coalesced_;
+    uint32_t transmitted_;
+    uint32_t timed_;                // Transmitted messages with a measured time in the queue
+
+    uint32_t latency_total_;
+    uint16_t latency_min_;
+    uint16_t latency_max_;
+
+    bool sending_;                  // The last dequeued message has not yet been sent
+    bool sending_timed_;            // ... and has a queue time in sending_time_
+    uint16_t sending_time_;
+
+#if MRRWA_LN_TX_LATENCY_TRACKING
+    /// Queue times of a lane's messages, in step with the messages in the lane
+    struct Lane_times {
+        Circular_buffer<uint16_t, MRRWA_LN_TX_LATENCY_MESSAGES> times;     // Oldest messages
+        uint16_t untimed;           // Messages queued behind those, not timed
+
+        Lane_times() : untimed(0) {}
+    };
+
+    Lane_times lane_times_[2];      // Bulk lane, then urgent
+
+    Lane_times& lane_times(Switch_priority lane) {
+        return lane_times_[(Switch_priority::urgent == lane) ? 1 : 0];
+    }
+#endif
 };
 
 
@@ -81,6 +225,24 @@ public:
  * of Loconet Sensor objects which observe the subject.  The adapter converts
  * received LocoNet sensor messages into sensor states.
  *
+ * Messages to transmit are queued in two lanes: urgent (switch requests that
+ * make a head more restrictive) and bulk (everything else, e.g. initial
+ * states and 'off' follow-ups).  The urgent lane is always served first,
+ * except that after MRRWA_LN_TX_URGENT_BURST consecutive urgent messages one
+ * waiting bulk message is sent.
+ *
+ * A switch request that supersedes a queued request for the same address
+ * (and on/off flag) replaces it in place rather than being queued; see
+ * Mrrwa_loconet_tx_buffer::coalesce_sw_req().
+ *
+ * The retry of a message that LocoNet did not send depends on the LN_STATUS
+ * returned.  Carrier detect and priority backoffs and a busy network are
+ * normal bus conditions: the message is retried after MRRWA_LN_TX_FAST_RETRY_MS,
+ * without the transmission manager's delay and without counting towards its
+ * retransmit limit.  Collisions and other errors (and a bus that stays busy
+ * for MRRWA_LN_TX_FAST_RETRY_LIMIT retries) are passed to the transmission
+ * manager with set_retransmit(), as is a LONG_ACK.
+ *
  */
 
 class Mrrwa_loconet_adapter : public Loconet_adapter_interface, Setup_interface, Loop_interface
@@ -108,7 +270,12 @@ public:
      *                          otherwise the system could enter an unrecoverable state.
      *                          For each double output head, assume 4x3-byte messages
      *                          A value of many hundreds is recommended.  The buffer high watermark
-     *                          can be accessed by get_buffer_high_watermark and printed periodically.
+     *                          can be accessed by get_buffer_high_watermark and printed periodically,
+     *                          and an occupancy histogram by get_tx_telemetry().
+     *                          The buffer is statically allocated with MRRWA_LN_TX_BUFFER_CAPACITY
+     *                          bytes (mr_signals_config.h); larger values are limited to this,
+     *                          traced and counted by get_config_error_count().  This sets the
+     *                          bulk lane; the urgent lane has MRRWA_LN_TX_URGENT_BUFFER_CAPACITY bytes.
      */
     Mrrwa_loconet_adapter(Setup_collection&, Loop_collection&,
                           LocoNetClass& loconet, int tx_pin, size_t num_sensors, size_t tx_buffer_size,
@@ -137,6 +304,9 @@ public:
      * so normally is not called directly.  It is provided for alternative
      * implementations to use if desired.
      *
+     * The sensor is inserted in address order, so attaching n sensors takes
+     * O(n^2) moves at startup in exchange for an O(log n) notify_sensors().
+     *
      * @param sensor  Sensor which wishes to observe the adapter
      */
     void attach_sensor(Loconet_sensor* sensor) override;
@@ -144,12 +314,19 @@ public:
     /**
      * Requests that a Switch Request Loconet message be queued
      *
+     * If a request for the same address and on/off flag is already queued,
+     * it is updated to this request's direction instead.  An urgent request
+     * that only supersedes a bulk request updates it and is also queued in
+     * the urgent lane.
+     *
      * @param address   Address of the switch
      * @param thrown    true = thrown, false = closed
      * @param on        on/off of the Loconet protocol
+     * @param priority  urgent requests are queued in the urgent lane
      * @return          true if the request was queued, false if not
      */
-    bool send_opc_sw_req(Loconet_address address, bool thrown,bool on) override;
+    bool send_opc_sw_req(Loconet_address address, bool thrown, bool on,
+                         Switch_priority priority = Switch_priority::normal) override;
 
     /**
      * Requests that a General Power On LocoNet message be sent
@@ -190,8 +367,27 @@ public:
 
     size_t sensor_init_size();
 
+    /**
+     * Determine whether the state of any attached sensor is not yet known
+     *
+     * When all the sensors hold their state in the adapter's Sensor_state_store
+     * this is a single comparison; otherwise the sensors are checked until one
+     * is found that is indeterminate.
+     *
+     * @return true if any sensor is indeterminate
+     */
     bool any_sensor_indeterminate();
 
+#if MR_SIGNALS_SENSOR_STORE
+    /**
+     * Get the store that attached sensors keep their state in, e.g. for bulk
+     * queries with a Sensor_set of their slots
+     */
+    Sensor_state_store* get_sensor_state_store() override {
+        return &sensor_states_;
+    }
+#endif
+
      /**
      * Get an indication of time elapsed since system startup in units of
      * milliseconds
@@ -202,6 +398,14 @@ public:
      */
      Runtime_ms get_time_ms() const override;
 
+     /**
+      * Get the timer service that the adapter services at the start of
+      * each loop(), using get_time_ms()
+      */
+     Timer_service* get_timer_service() override {
+         return &timer_service_;
+     }
+
 //    void queue_loconet_msg(lnMsg *msg);
 
     //void PrintSensors();
@@ -213,6 +417,10 @@ public:
      * Primary use is to be called when a sensor message is received from
      * LocoNet
      *
+     * The sensor is found by a binary search of the attached sensors.  If
+     * several sensors have the same address, only the first attached is
+     * notified.
+     *
      * Function is const as it does not affect the contents of the adapter
      * object (only the attached sensor objects).  This also allows it to be
      * called from a constant pointer in notifySensor(), e.g.
@@ -226,21 +434,62 @@ public:
 
 
     /**
-     * Retrieve the transmit buffer high water mark
+     * Retrieve the transmit buffer (bulk lane) high water mark
      * @return The maximum occupancy of the transmit buffer
      */
     std::size_t get_buffer_high_watermark() {
-        return tx_buffer_.loconet_tx_buffer_.high_watermark();
+        return tx_buffer_.high_watermark();
+    }
+
+    /**
+     * Retrieve the urgent lane transmit buffer high water mark
+     * @return The maximum occupancy of the urgent lane
+     */
+    std::size_t get_urgent_buffer_high_watermark() {
+        return urgent_tx_buffer_.high_watermark();
     }
 
     /**
-     * Retrieve the internal transmit error count
+     * Retrieve the transmit queue statistics
+     * @return Reference to the statistics, valid for the life of the adapter
+     */
+    const Mrrwa_loconet_tx_telemetry& get_tx_telemetry() const {
+        return tx_telemetry_;
+    }
+
+    /**
+     * Retrieve the internal transmit error count; sends that were retried
+     * after the transmission manager's delay (not the fast retries of backoffs)
      * @return The tx error count
      */
     uint16_t get_tx_error_count() {
         return tx_errors_;
     }
 
+    /**
+     * Retrieve the number of constructor arguments that could not be used as
+     * given, e.g. a tx_buffer_size larger than MRRWA_LN_TX_BUFFER_CAPACITY
+     * @return The configuration error count; 0 if the adapter is as configured
+     */
+    uint8_t get_config_error_count() const {
+        return config_errors_;
+    }
+
+    /// Number of bytes the bulk lane may queue, as limited by MRRWA_LN_TX_BUFFER_CAPACITY
+    std::size_t get_buffer_size() const {
+        return tx_buffer_.max_size();
+    }
+
+    /**
+     * Retrieve the number of sends that returned a given status, including
+     * LN_DONE and each fast retry
+     * @param status - Status returned by LocoNetClass::send()
+     * @return The count for the status (0 for an unknown status)
+     */
+    uint16_t get_tx_status_count(LN_STATUS status) const {
+        return (status <= LN_RETRY_ERROR) ? tx_status_counts_[status] : 0;
+    }
+
     /**
      * Retrieve the internal count of OPC_LONG_ACKs (error from command station in response to switch request) received
      * @return The long ack count
@@ -249,6 +498,20 @@ public:
         return long_acks_;
     }
 
+    /**
+     * Retrieve the number of times the receive buffer was nearly full: the
+     * bytes received since it was last found empty reached
+     * MRRWA_LN_RX_NEAR_FULL (an upper bound on its occupancy)
+     */
+    uint16_t get_rx_near_full_count() const {
+        return rx_near_full_count_;
+    }
+
+    /// Retrieve the most bytes received between finding the receive buffer empty
+    uint16_t get_rx_backlog_high_watermark() const {
+        return rx_backlog_high_watermark_;
+    }
+
 
     /**
      * Prints the current state of the attached sensors using
@@ -262,6 +525,9 @@ public:
      *  (e.g. "LN RX" or "LN TX") using the Serial output stream from mr_signals.h
      *  A timestamp in milliseconds is prepended to the trace.
      *
+     *  Prints immediately; the adapter's own receive and transmit paths
+     *  record messages with trace() instead (see base/trace.h).
+     *
      * @param packet - Pointer to a lnMsg to print
      * @param prefix - String prefix to print
      * @param print_checksum - Indicates whether or not to print the last
@@ -281,14 +547,30 @@ private:
     void transmit_loop();
     void send_global_power_on_loop();
 
+    bool queue_loconet_msg(lnMsg& msg, Switch_priority lane = Switch_priority::normal);
+
+    bool dequeue_loconet_msg(lnMsg& msg);
+
 
 
-    /// Sensors that are notified
+#if MR_SIGNALS_SENSOR_STORE
+    /// States of the attached sensors, by slot
+    Sensor_state_store sensor_states_;
+#endif
+
+    /// Sensors that are notified, sorted by address
     /// Observer pattern; the adapter class is the subject, each sensor is an observer
-    std::vector<Loconet_sensor*> sensors_;
+    Arena_vector<Loconet_sensor*, Arena_use::loconet> sensors_;
 
     lnMsg ln_msg_;             // The last LN message transmitted
 
+    /// The last message sent with LN_DONE, that a LONG_ACK received while the next
+    /// message (ln_msg_) is waiting for a fast retry answers.  Once swapped with
+    /// ln_msg_ for its retransmission, holds that next message (tx_deferred_).
+    lnMsg tx_done_msg_;
+    bool tx_done_valid_;            // tx_done_msg_ has been sent
+    bool tx_deferred_;              // tx_done_msg_ is to be sent before the next dequeued message
+
     size_t sensor_init_size_;       // The size the sensor vector is initialized to (to compare against its final size)
 
 
@@ -308,14 +590,35 @@ private:
 
 //    uint8_t retransmit_;
 
-    Mrrwa_loconet_tx_buffer tx_buffer_;
+    Mrrwa_loconet_tx_buffer<MRRWA_LN_TX_BUFFER_CAPACITY> tx_buffer_;                // Bulk lane
+
+    Mrrwa_loconet_tx_buffer<MRRWA_LN_TX_URGENT_BUFFER_CAPACITY> urgent_tx_buffer_;  // Urgent lane
+
+    uint8_t urgent_burst_count_;    // Consecutive urgent messages sent while bulk messages waited
+
+    Mrrwa_loconet_tx_telemetry tx_telemetry_;
 
     /// Count of transmit errors from the MRRWA library
     uint16_t tx_errors_;
 
+    uint8_t config_errors_;         // Constructor arguments not used as given
+
+    /// Count of each status returned by LocoNetClass::send()
+    uint16_t tx_status_counts_[LN_RETRY_ERROR + 1];
+
+    uint8_t fast_retry_count_;      // Fast retries of ln_msg_ so far; non-zero while one is pending
+    Runtime_ms fast_retry_time_;    // Time of the pending fast retry
+
     // Count of LONG_ACKs received for switch messages
     uint16_t long_acks_;
 
+    uint16_t rx_backlog_;                   // Bytes received since the receive buffer was last empty
+    uint16_t rx_backlog_high_watermark_;
+    uint16_t rx_near_full_count_;
+
+    /// Timers serviced by loop()
+    Timer_service timer_service_;
+
     /// Instance of the MRWWA Loconet Class used by the adapter
     LocoNetClass& loconet_;
 
@@ -327,6 +630,14 @@ private:
 
     bool any_sensor_indeterminate_;
 
+#if MR_SIGNALS_LOOP_TIMING
+    /// Loop_timing slots of the phases of loop()
+    Timing_slot timers_timing_;
+    Timing_slot rx_timing_;
+    Timing_slot tx_timing_;
+    Timing_slot power_on_timing_;
+#endif
+
 };
 
 }
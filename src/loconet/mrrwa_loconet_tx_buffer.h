@@ -0,0 +1,294 @@
+/*
+ * mrrwa_loconet_tx_buffer.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_LOCONET_MRRWA_LOCONET_TX_BUFFER_H_
+#define SRC_LOCONET_MRRWA_LOCONET_TX_BUFFER_H_
+
+#include "../base/circular_buffer.h"
+
+#ifdef ARDUINO
+
+    #include "LocoNet.h"    // The MRRWA package
+
+#else
+
+    #include "mrrwa_loconet_mock.h"  // Assume mock instance of LocoNet needed
+
+#endif
+
+
+namespace mr_signals {
+
+
+/**
+ * Handles the management of a LocoNet Transmit queue for Mrrwa_loconet_adapter
+ *
+ * This class is private to Mrrwa_loconet_adapter and should not be accessed
+ * directly at any time.  The adapter holds one per priority lane.
+ *
+ * Messages are stored as records: a length byte followed by the message
+ * bytes (without the checksum for messages longer than 2 bytes, as the MRRWA
+ * library calculates it on sending).  The boundaries between messages never
+ * depend on the message contents, so the next message can be peeked or
+ * skipped without parsing it.
+ *
+ * @param N Capacity of the storage in bytes; must be a power of two
+ */
+template <std::size_t N>
+class Mrrwa_loconet_tx_buffer
+{
+public:
+
+    Mrrwa_loconet_tx_buffer() :
+        buffer_limit_(N), msg_count_(0), flush_count_(0)
+    {
+    }
+
+    /**
+     * Limit the number of bytes that may be queued
+     *
+     * The storage is fixed at N bytes; this only sets how much of it is used.
+     *
+     * @param buffer_size - Number of bytes that may be queued
+     * @return true if buffer_size is valid, false if it is too small or larger
+     *         than N (the full capacity is then used)
+     */
+    bool initialize(std::size_t buffer_size)
+    {
+        bool return_value = false;
+
+        if(buffer_size >= 2 && buffer_size <= N) {
+            buffer_limit_ = buffer_size;
+            return_value = true;
+        }
+        else {
+            buffer_limit_ = N;
+        }
+
+        return(return_value);
+    }
+
+
+    /**
+     * Queue a lnMsg (Loconet message) for transmission onto LocoNet
+     *
+     * The length of the message is extracted from it using the MRWWA's
+     * getLnMsgSize function and checked to be from 2 bytes (the minimum LN
+     * message) to the size of lnMsg.
+     *
+     * Messages longer than 2 bytes are stored without the checksum.  2 byte
+     * messages are stored whole, as the second byte carries the delay for
+     * the OPC_IDLE tx delay pseudo-message.
+     *
+     * The record is only added if it fits within the limit set by
+     * initialize().
+     *
+     * @param msg - The Loconet message to queue
+     * @return true if enqueued, false otherwise
+     */
+    bool queue_loconet_msg(lnMsg& msg)
+    {
+        bool return_value = false;
+        uint8_t msg_len = getLnMsgSize(&msg);
+
+        if( msg_len <= sizeof(lnMsg) &&                     // Not too big
+            msg_len >= 2) {                                 // Not too small
+
+            uint8_t stored_len = (msg_len > 2) ? msg_len - 1 : 2;
+
+            if(stored_len + 1U <= get_free()) {             // Record can fit into the buffer
+
+                (void) loconet_tx_buffer_.enqueue(stored_len);
+                (void) loconet_tx_buffer_.enqueue(msg.data, stored_len);
+
+                msg_count_++;
+
+                return_value = true;
+            }
+        }
+
+        return (return_value);
+    }
+
+    /**
+     *  Dequeue a queued lnMsg (Loconet message)
+     *
+     * @param msg - The dequeued message
+     * @return true if a message was dequed, false if not
+     */
+    bool dequeue_loconet_msg(lnMsg& msg)
+    {
+        uint8_t stored_len = read_record_len();
+
+        if(stored_len) {
+            (void) loconet_tx_buffer_.peek(msg.data, stored_len, 1);
+            loconet_tx_buffer_.consume(stored_len + 1U);
+            msg_count_--;
+        }
+
+        return (stored_len > 0);
+    }
+
+    /**
+     *  Read the next queued lnMsg (Loconet message) without dequeuing it
+     *
+     * Not const; a corrupted buffer is emptied when detected
+     *
+     * @param msg - The next message
+     * @return true if a message was read, false if the queue is empty
+     */
+    bool peek_loconet_msg(lnMsg& msg)
+    {
+        uint8_t stored_len = read_record_len();
+
+        if(stored_len) {
+            (void) loconet_tx_buffer_.peek(msg.data, stored_len, 1);
+        }
+
+        return (stored_len > 0);
+    }
+
+    /**
+     * Discard the next queued message without reading it
+     *
+     * @return true if a message was discarded, false if the queue is empty
+     */
+    bool skip_loconet_msg()
+    {
+        uint8_t stored_len = read_record_len();
+
+        if(stored_len) {
+            loconet_tx_buffer_.consume(stored_len + 1U);
+            msg_count_--;
+        }
+
+        return (stored_len > 0);
+    }
+
+    /**
+     * Replace a queued switch request that msg supersedes
+     *
+     * A queued OPC_SW_REQ with the same address and on/off flag as msg is
+     * superseded by it; only the newest is updated, in place, so that it
+     * keeps its position in the queue.  A queued 'off' is not updated if an
+     * 'on' for the address follows it, as the 'off' would then be sent
+     * before that 'on'.
+     *
+     * Scans every queued record, so the cost grows with msg_count().
+     *
+     * @param msg - OPC_SW_REQ about to be queued
+     * @return true if a queued request was updated (msg need not be queued),
+     *         false if msg is not an OPC_SW_REQ or supersedes nothing
+     */
+    bool coalesce_sw_req(const lnMsg& msg)
+    {
+        bool return_value = false;
+
+        if(OPC_SW_REQ == msg.data[0]) {
+
+            const uint8_t sw1 = msg.data[1];
+            const uint8_t sw2 = msg.data[2];
+
+            std::size_t match = 0;      // Offset of the sw2 byte to update; 0 for none
+            std::size_t offset = 0;
+
+            while(offset < loconet_tx_buffer_.size()) {
+
+                const uint8_t stored_len = loconet_tx_buffer_.at(offset);
+
+                if( OPC_SW_REQ == loconet_tx_buffer_.at(offset + 1) &&
+                    sw1 == loconet_tx_buffer_.at(offset + 2) &&
+                    (sw2 & 0x0F) == (loconet_tx_buffer_.at(offset + 3) & 0x0F)) {
+
+                    const uint8_t queued_sw2 = loconet_tx_buffer_.at(offset + 3);
+
+                    if((sw2 & OPC_SW_REQ_OUT) == (queued_sw2 & OPC_SW_REQ_OUT)) {
+                        match = offset + 3;
+                    }
+                    else if(queued_sw2 & OPC_SW_REQ_OUT) {
+                        match = 0;      // 'on' after the match; an 'off' may not move ahead of it
+                    }
+                }
+
+                offset += stored_len + 1U;
+            }
+
+            if(match) {
+                loconet_tx_buffer_.at(match) = sw2;
+                return_value = true;
+            }
+        }
+
+        return(return_value);
+    }
+
+    /// Number of messages queued
+    std::size_t msg_count() const { return(msg_count_); }
+
+    /// Number of bytes queued (including the record length bytes)
+    std::size_t size() const { return(loconet_tx_buffer_.size()); }
+
+    /// Number of bytes that can still be queued
+    std::size_t get_free() const { return(buffer_limit_ - loconet_tx_buffer_.size()); }
+
+    /// Number of bytes that may be queued in total
+    std::size_t max_size() const { return(buffer_limit_); }
+
+    /// The maximum number of bytes that have been queued at once
+    std::size_t high_watermark() const { return(loconet_tx_buffer_.high_watermark()); }
+
+    /// Number of times the buffer was found corrupted and emptied
+    uint16_t flush_count() const { return(flush_count_); }
+
+
+    Circular_buffer<uint8_t, N> loconet_tx_buffer_;
+
+private:
+
+    /**
+     * Reads the length byte of the record at the head of the buffer
+     *
+     * Records are only written by queue_loconet_msg(), so an invalid length
+     * means the buffer has been corrupted.  Rather than transmit garbage, the
+     * buffer is emptied.
+     *
+     * @return Number of message bytes in the record; 0 if the buffer is empty
+     */
+    uint8_t read_record_len()
+    {
+        std::size_t readable = 0;
+        const uint8_t* head = loconet_tx_buffer_.peek(readable);
+
+        uint8_t stored_len = 0;
+
+        if(readable) {
+            stored_len = *head;
+
+            if( stored_len < 2 ||
+                stored_len > sizeof(lnMsg) ||
+                stored_len + 1U > loconet_tx_buffer_.size()) {
+
+                loconet_tx_buffer_.consume(loconet_tx_buffer_.size());
+                msg_count_ = 0;
+                flush_count_++;
+
+                stored_len = 0;
+            }
+        }
+
+        return stored_len;
+    }
+
+    std::size_t buffer_limit_;      // Number of bytes of loconet_tx_buffer_ that may be used
+    std::size_t msg_count_;         // Number of records in loconet_tx_buffer_
+    uint16_t flush_count_;          // Times loconet_tx_buffer_ was emptied as corrupted
+};
+
+
+}   // namespace mr_signals
+
+
+#endif /* SRC_LOCONET_MRRWA_LOCONET_TX_BUFFER_H_ */
@@ -10,6 +10,10 @@
 
 #include <vector>   // std::vector<>
 #include <cstddef>  // size_t
+#include <stdint.h>
+#include "base/change_listener.h"
+#include "base/loop_timing.h"
+#include "base/startup_arena.h"
 
 namespace mr_signals {
 
@@ -18,7 +22,19 @@ namespace mr_signals {
 class Logic_interface;
 
 
-class Logic_collection {
+/**
+ * Holds the logic of the layout and runs it from loop()
+ *
+ * By default every logic is evaluated on every loop().  Once
+ * enable_change_propagation() is called, a logic is only evaluated when one
+ * of the sensors or heads it lists (Logic_interface::list_dependencies())
+ * reports a change, so a quiet layout costs next to nothing per loop.
+ * Logic that cannot list its inputs, or that reads a sensor that does not
+ * report its changes (e.g. Pin_sensor), is still evaluated on every loop.
+ *
+ * With MR_SIGNALS_LOOP_TIMING, each evaluation of a logic is timed.
+ */
+class Logic_collection : public Change_listener {
 
 public:
     /// Dimension the storage at construction so that the storage ::vector
@@ -51,10 +67,56 @@ public:
     /// are periodically run
     void loop();
 
+    /**
+     * Evaluate each logic only when its inputs change, rather than on every
+     * loop().  To be called once, after all of the logic has been attached
+     * (e.g. at the end of setup()).
+     *
+     * Builds an index from each input to the logic that reads it, and orders
+     * the logic so that logic setting a sensor or head (e.g. an APB tumbledown)
+     * is evaluated before the logic that reads it, so a change ripples through
+     * in a single loop() where the dependencies allow.  Every logic is
+     * evaluated on the first loop().
+     *
+     * The collection becomes the Change_listener; only one collection can
+     * use change propagation.  Heads are only run (Head_interface::loop())
+     * when their logic is evaluated; the switches in this library do their
+     * follow-up work from the Timer_service instead.
+     */
+    void enable_change_propagation();
+
+    /// Marks the logic reading the changed sensor or head for evaluation
+    void changed(const void* source) override;
+
+    ~Logic_collection();
+
 private:
-    std::vector<Logic_interface *> logic_functions_;
+    /// Index entry: logic (position in logic_functions_) reading a source
+    struct Dependent {
+        const void* source;
+        uint16_t logic;
+    };
+
+    enum : uint8_t {
+        logic_dirty = 1,        // An input changed since the last evaluation
+        logic_polled = 2        // Evaluated on every loop()
+    };
+
+    void mark_dirty(uint16_t logic);
+
+    Arena_vector<Logic_interface *, Arena_use::logic> logic_functions_;
     size_t init_size_;
 
+    Arena_vector<Dependent, Arena_use::logic> dependents_;     // Sorted by source
+    Arena_vector<uint8_t, Arena_use::logic> flags_;            // Per logic_functions_ entry
+    uint16_t dirty_count_;
+    uint16_t polled_count_;
+    bool propagate_;
+
+#if MR_SIGNALS_LOOP_TIMING
+    Arena_vector<Timing_slot, Arena_use::loop_timing> timing_slots_; // Per logic_functions_ entry
+#endif
+
 };
 
 }; /* namespace mr_signals */
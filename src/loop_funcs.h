@@ -15,18 +15,79 @@
 class Loop_collection;
 
 
+/**
+ * Task run by a Loop_collection
+ *
+ * By default a task is run on every pass of the collection.  A task that
+ * only needs to run periodically (e.g. 10-100 Hz) registers a period, and
+ * optionally a priority that decides which due tasks run first when the
+ * collection's time budget for a pass is short.
+ */
 class Loop_interface {
 public:
   Loop_interface(Loop_collection&);
+
+  /**
+   * @param period_ms - Run at most once per period (0 = every pass)
+   * @param priority  - Higher priority due tasks run first
+   */
+  Loop_interface(Loop_collection&, uint16_t period_ms, uint8_t priority = 0);
+
   virtual void loop() = 0;
+
+  uint16_t get_period_ms() const { return period_ms_; }
+  uint8_t get_priority() const { return priority_; }
+
+  /// Number of times the task ran a whole period or more after it was due
+  uint16_t get_overruns() const { return overruns_; }
+
+private:
+  friend class Loop_collection;
+
+  uint32_t next_due_ms_;    // 0 until first run
+  uint16_t period_ms_;
+  uint8_t priority_;
+  uint16_t overruns_;
 };
 
 
+/**
+ * Cooperative scheduler for the Loop_interface tasks
+ *
+ * Each execute() (one pass, from the sketch's loop()) runs every task with no
+ * period, then the periodic tasks that are due, highest priority first and
+ * round-robin within a priority.  If a time budget is set, no further
+ * periodic task is started once the pass has used it (at least one due task
+ * is always run), so that the time between passes, and so the latency of the
+ * every pass tasks such as the LocoNet adapter, stays bounded as more tasks
+ * are added.  Tasks left due run on the following passes.
+ *
+ * With MR_SIGNALS_LOOP_TIMING, each task is timed and each execute() is taken
+ * as a pass of the main loop for Loop_timing's period and jitter.
+ */
 class Loop_collection : public Collection_base<Loop_interface,&Loop_interface::loop>
 {
 public:
-    Loop_collection(const collec_size size) : Collection_base(size) {}
+    /**
+     * @param size      - Number of tasks to reserve storage for
+     * @param budget_us - Time for each pass after which no further periodic
+     *                    task is started (0 = no limit)
+     */
+    Loop_collection(const collec_size size, const uint16_t budget_us = 0);
+
+    /// Attach a task, ordered by priority
+    void attach(Loop_interface* obj);
+
+    /// Run one pass of the tasks
+    void execute();
+
+    /// Number of passes that ended with due tasks left by the time budget
+    uint16_t get_budget_overruns() const { return budget_overruns_; }
 
+private:
+    mr_signals::Arena_vector<collec_size, mr_signals::Arena_use::collections> rr_offset_;   // Round-robin start, at the first index of each priority
+    uint16_t budget_us_;
+    uint16_t budget_overruns_;
 };
 
 
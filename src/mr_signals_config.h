@@ -0,0 +1,96 @@
+/*
+ * mr_signals_config.h
+ *
+ * Build options of the mr-signals library
+ *
+ * Options here change the size or layout of the library's classes, so must
+ * be the same for the library's .cpp files and the sketch.  The Arduino IDE
+ * compiles the library without the sketch's #defines, so set them by editing
+ * this file (or with a flag given to the whole build, e.g. PlatformIO's
+ * build_flags), never with a #define in the sketch: the sketch would then
+ * see different classes from the library and corrupt memory.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef SRC_MR_SIGNALS_CONFIG_H_
+#define SRC_MR_SIGNALS_CONFIG_H_
+
+
+// Define as 1 to time each task, logic and LocoNet adapter phase run from
+// loop(), and the period of loop() itself.  When 0 no timing code is
+// compiled into the collections or the adapter.
+#ifndef MR_SIGNALS_LOOP_TIMING
+#define MR_SIGNALS_LOOP_TIMING 0
+#endif
+
+// Number of objects that can be timed (46 bytes each); objects beyond it are
+// counted and reported as not timed
+#ifndef MR_SIGNALS_LOOP_TIMING_ENTRIES
+#define MR_SIGNALS_LOOP_TIMING_ENTRIES 16
+#endif
+
+// Capacity of the LocoNet adapter's transmit buffer (bytes), held in the
+// adapter.  Must be a power of two.  The tx_buffer_size given to the adapter
+// may use less of it, but not more.
+#ifndef MRRWA_LN_TX_BUFFER_CAPACITY
+#define MRRWA_LN_TX_BUFFER_CAPACITY 512
+#endif
+
+// Capacity of the urgent lane of the transmit queue (bytes), used for switch
+// requests that make a head more restrictive.  Must be a power of two.
+#ifndef MRRWA_LN_TX_URGENT_BUFFER_CAPACITY
+#define MRRWA_LN_TX_URGENT_BUFFER_CAPACITY 64
+#endif
+
+// Track the time each queued message waits before transmission (1) or not (0)
+#ifndef MRRWA_LN_TX_LATENCY_TRACKING
+#define MRRWA_LN_TX_LATENCY_TRACKING 1
+#endif
+
+// Number of queued messages per transmit lane whose queue time is tracked (2
+// bytes each).  Messages queued behind a full set are transmitted untimed.
+// Must be a power of two, at least 2.
+#ifndef MRRWA_LN_TX_LATENCY_MESSAGES
+#define MRRWA_LN_TX_LATENCY_MESSAGES 32
+#endif
+
+// Define as 1 for the LocoNet adapter to keep the states of its sensors in a
+// Sensor_state_store, for bulk queries with a Sensor_set.  Costs the store
+// (2 bits per sensor) and 4 bytes per Loconet_sensor (store and slot), whose
+// own state bits then go unused, so is off by default.
+#ifndef MR_SIGNALS_SENSOR_STORE
+#define MR_SIGNALS_SENSOR_STORE 0
+#endif
+
+// Number of sensor states held by a Sensor_state_store (2 bits each).
+// Sensors beyond it hold their own state.
+#ifndef MR_SIGNALS_SENSOR_STORE_CAPACITY
+#define MR_SIGNALS_SENSOR_STORE_CAPACITY 256
+#endif
+
+// Bytes of LocoNet traffic held by a Loconet_capture (about 5 bytes per
+// message).  Must be a power of two, at least 32.
+#ifndef MR_SIGNALS_CAPTURE_BYTES
+#define MR_SIGNALS_CAPTURE_BYTES 256
+#endif
+
+// Number of records held by a Trace_ring (16 bytes each).  Must be a power of
+// two, at least 2.
+#ifndef MR_SIGNALS_TRACE_RECORDS
+#define MR_SIGNALS_TRACE_RECORDS 32
+#endif
+
+// Number of slots in the timer wheel.  Must be a power of two, at least 2.
+#ifndef MR_SIGNALS_TIMER_WHEEL_SLOTS
+#define MR_SIGNALS_TIMER_WHEEL_SLOTS 32
+#endif
+
+// Time covered by each slot of the timer wheel (ms).  Timers fire up to this
+// much later than requested, on the first service() after they expire.
+#ifndef MR_SIGNALS_TIMER_TICK_MS
+#define MR_SIGNALS_TIMER_TICK_MS 8
+#endif
+
+
+#endif /* SRC_MR_SIGNALS_CONFIG_H_ */
@@ -21,6 +21,9 @@ public:
 
     bool is_indeterminate() const override;
 
+    /// The pin is read directly, so changes are not reported
+    const void* change_source() const override { return nullptr; }
+
 protected:
     uint8_t pin_;
 };
@@ -41,7 +41,7 @@ public:
     void loop() override {}
 
 
-    bool request_direction(const Switch_direction direction) override {
+    bool request_direction(const Switch_direction direction, const Switch_priority = Switch_priority::normal) override {
         if(Switch_direction::thrown == direction) {
             digitalWrite(pin_,HIGH);
         }
@@ -9,9 +9,10 @@
 #define SRC_RYG_LOGIC_H_
 
 #include <stdint.h>
-#include <vector>
+#include <cstddef>
 #include <initializer_list>
 #include "base/logic_interface.h"
+#include "base/static_vector.h"
 #include "base/head_interface.h"
 #include "sensor_interface.h"
 #include "logic_collection.h"
@@ -20,6 +21,14 @@
 
 namespace mr_signals {
 
+/**
+ * Logic for a Red/Yellow/Green head protecting sensors and, optionally,
+ * another head
+ *
+ * The protected sensors passed as an initializer list are copied to storage
+ * drawn from Startup_arena.  Static_simple_ryg_logic keeps them in the object
+ * instead.
+ */
 class Simple_ryg_logic : public Logic_interface
 {
 public:
@@ -34,13 +43,28 @@ public:
 
     void loop() override;
 
-    virtual ~Simple_ryg_logic() = default;
+    bool list_dependencies(Logic_dependencies& dependencies) const override;
+
+    bool is_settled() const override { return !pending_; }
+
+    Simple_ryg_logic(const Simple_ryg_logic&) = delete;
+    Simple_ryg_logic& operator=(const Simple_ryg_logic&) = delete;
+
+    virtual ~Simple_ryg_logic();
 
 protected:
 
+    /// Protected sensors held by the derived class (protected_head may be nullptr)
+    Simple_ryg_logic(   Logic_collection& collection,
+                        Head_interface& head,
+                        Head_interface* protected_head,
+                        Sensor_list protected_sensors);
+
     Head_interface& head_;               // Reference as there must be a head
     Head_interface* protected_head_;     // Pointer as there may not be a protected head. nullptr used when not present
-    std::vector<Sensor_interface *> protected_sensors_;
+    Sensor_list protected_sensors_;
+    bool owns_sensors_;                  // protected_sensors_ were copied to Startup_arena storage by this object
+    bool pending_;                       // The head has not taken the aspect last determined for it
 };
 
 class Interlocked_ryg_logic : public Simple_ryg_logic
@@ -72,14 +96,93 @@ public:
 
     void loop() override;
 
+    bool list_dependencies(Logic_dependencies& dependencies) const override;
+
     virtual ~Interlocked_ryg_logic() = default;
 
+protected:
+
+    /// Protected sensors held by the derived class (protected_head and automated_lever may be nullptr)
+    Interlocked_ryg_logic(  Logic_collection& collection,
+                            Head_interface& head,
+                            Head_interface* protected_head,
+                            Sensor_interface& lever,
+                            Sensor_interface* automated_lever,
+                            Sensor_list protected_sensors);
+
 private:
     Sensor_interface& lever_;               // Reference as mandatory
     Sensor_interface* automated_lever_;     // Pointer as optional
 };
 
 
+/**
+ * Simple_ryg_logic holding up to N protected sensors in the object, so that
+ * constructing it uses no heap.  Passing more than N sensors is a compile
+ * error.
+ *
+ * Example
+ *
+ * Static_simple_ryg_logic<2> logic_1(logic_collection, head_1, head_2, {&sensor_1, &sensor_2});
+ */
+template <std::size_t N>
+class Static_simple_ryg_logic : private Sensor_storage<N>, public Simple_ryg_logic
+{
+public:
+    template <std::size_t M>
+    Static_simple_ryg_logic(Logic_collection& collection,
+                            Head_interface& head,
+                            Head_interface& protected_head,
+                            Sensor_interface* const (&protected_sensors)[M]) :
+        Sensor_storage<N>(protected_sensors),
+        Simple_ryg_logic(collection, head, &protected_head, this->sensors_.view()) {}
+
+    template <std::size_t M>
+    Static_simple_ryg_logic(Logic_collection& collection,
+                            Head_interface& head,
+                            Sensor_interface* const (&protected_sensors)[M]) :
+        Sensor_storage<N>(protected_sensors),
+        Simple_ryg_logic(collection, head, nullptr, this->sensors_.view()) {}
+};
+
+
+/**
+ * Interlocked_ryg_logic holding up to N protected sensors in the object
+ * (see Static_simple_ryg_logic)
+ */
+template <std::size_t N>
+class Static_interlocked_ryg_logic : private Sensor_storage<N>, public Interlocked_ryg_logic
+{
+public:
+    template <std::size_t M>
+    Static_interlocked_ryg_logic(   Logic_collection& collection,
+                                    Head_interface& head,
+                                    Head_interface& protected_head,
+                                    Sensor_interface& lever,
+                                    Sensor_interface* const (&protected_sensors)[M]) :
+        Sensor_storage<N>(protected_sensors),
+        Interlocked_ryg_logic(collection, head, &protected_head, lever, nullptr, this->sensors_.view()) {}
+
+    template <std::size_t M>
+    Static_interlocked_ryg_logic(   Logic_collection& collection,
+                                    Head_interface& head,
+                                    Head_interface& protected_head,
+                                    Sensor_interface& lever,
+                                    Sensor_interface& automated_lever,
+                                    Sensor_interface* const (&protected_sensors)[M]) :
+        Sensor_storage<N>(protected_sensors),
+        Interlocked_ryg_logic(collection, head, &protected_head, lever, &automated_lever, this->sensors_.view()) {}
+
+    template <std::size_t M>
+    Static_interlocked_ryg_logic(   Logic_collection& collection,
+                                    Head_interface& head,
+                                    Sensor_interface& lever,
+                                    Sensor_interface* const (&protected_sensors)[M]) :
+        Sensor_storage<N>(protected_sensors),
+        Interlocked_ryg_logic(collection, head, nullptr, lever, nullptr, this->sensors_.view()) {}
+};
+
+
 /**
  * Implements the logic of a interlocking lever that has a dependency on
  * a push-key to fully reverse. In an actual interlocking frame, such a lever
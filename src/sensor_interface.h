@@ -49,6 +49,14 @@ public:
      */
     virtual bool is_indeterminate() const = 0;
 
+    /**
+     * The source of the change reports (see Change_listener) that cover this
+     * sensor's state, for logic that is only evaluated on a change
+     * @return The reporting Sensor_interface* or Head_interface*, or nullptr
+     *         if the state can change without a report and must be polled
+     */
+    virtual const void* change_source() const { return nullptr; }
+
     virtual ~Sensor_interface() = default;
 };
 
@@ -88,12 +96,19 @@ public:
      */
     bool is_indeterminate() const override;
 
+    /// State only changes through set_state(), which reports each change
+    const void* change_source() const override { return static_cast<const Sensor_interface*>(this); }
+
     /// Set the state of the sensor true or false
     /** \brief Allows the state of the sensor to be set (active/inactive = true/false)
      * \param state - true/false = active/inactive
-     * \return true if the sensor's state changed
+     * \return true if the sensor's state changed (reported to the Change_listener)
+     *
+     * Virtual so that sensors holding their state elsewhere (e.g. Loconet_sensor
+     * in the adapter's state store) see every write, including through a
+     * Sensor_base&
      */
-    bool set_state(const bool state);
+    virtual bool set_state(const bool state);
 
 protected:
     enum
@@ -119,6 +134,7 @@ class Active_sensor : public Sensor_interface {
 public:
     bool is_active() override { return true; }
     bool is_indeterminate() const override { return false; }
+    const void* change_source() const override { return static_cast<const Sensor_interface*>(this); }
 };
 
 
@@ -134,6 +150,9 @@ public:
 
     bool is_indeterminate() const override;
 
+    /// Changes with the wrapped sensor
+    const void* change_source() const override;
+
 
 private:
     Sensor_interface& sensor_;
@@ -19,7 +19,7 @@ public:
 class Setup_collection : public Collection_base<Setup_interface, &Setup_interface::setup>
 {
 public:
-    Setup_collection(const collec_size size) : Collection_base(size) {}
+    Setup_collection(const collec_size size) : Collection_base(size, "setup") {}
 
 };
 
@@ -29,6 +29,22 @@ unsigned long set_millis(const unsigned long val)
 void init_millis(void)
 {
     set_millis(0L);
+    set_micros(0L);
+}
+
+
+unsigned long micros_val = 0;
+
+unsigned long micros(void)
+{
+    return(micros_val);
+}
+
+unsigned long set_micros(const unsigned long val)
+{
+    micros_val = val;
+
+    return(micros());
 }
 
 
@@ -36,6 +36,16 @@ unsigned long set_millis(const unsigned long val);
 void init_millis(void);
 
 
+/**
+ * Mock for the Arduino micros function, independent of millis()
+ *
+ * Returns a value that is set through the set_micros() function
+ */
+unsigned long micros(void);
+
+unsigned long set_micros(const unsigned long val);
+
+
 /******************** Digital I/O mocks *******************/
 
 // From Arduino.h
@@ -265,6 +265,153 @@ TEST(Logic_Collection,SizeAndLoop)
 
 }
 
+namespace {
+
+/// Copies its input to an optional output, counting its evaluations
+class Counting_logic : public Logic_interface {
+public:
+    Counting_logic(Logic_collection& collection, Sensor_interface& input, Sensor_base* output = nullptr) :
+        Logic_interface(collection), input_(input), output_(output), loops_(0) {}
+
+    void loop() override {
+        loops_++;
+        if(output_ && !input_.is_indeterminate()) {
+            output_->set_state(input_.is_active());
+        }
+    }
+
+    bool list_dependencies(Logic_dependencies& dependencies) const override {
+        dependencies.input(input_);
+        if(output_) {
+            dependencies.output(*output_);
+        }
+        return true;
+    }
+
+    Sensor_interface& input_;
+    Sensor_base* output_;
+    int loops_;
+};
+
+/// Test_head that only accepts a new aspect when allowed to
+class Refusing_head : public Test_head {
+public:
+    Refusing_head() : accept_(false) {}
+
+    bool request_aspect(const Head_aspect aspect) override {
+        return accept_ ? Test_head::request_aspect(aspect) : false;
+    }
+
+    bool accept_;
+};
+
+}
+
+/*
+ * With change propagation enabled, logic is only evaluated when an input
+ * changes, in dependency order rather than attach order, and logic reading
+ * an unreported input (Pin_sensor) or that cannot list its inputs is
+ * evaluated on every loop
+ */
+TEST(Logic_Collection,ChangePropagation)
+{
+    Logic_collection collection(4);
+
+    Sensor_base input, middle, unrelated;
+    Pin_sensor pin(3);
+    Inverted_sensor inverted_input(input);
+
+    // Attach the reader of 'middle' before the logic that sets it
+    Counting_logic reader(collection, middle);
+    Counting_logic writer(collection, input, &middle);
+    Counting_logic polled(collection, pin);
+    Counting_logic inverted(collection, inverted_input);
+
+    collection.enable_change_propagation();
+
+    // Everything is evaluated on the first loop
+    collection.loop();
+    EXPECT_EQ(1,reader.loops_);
+    EXPECT_EQ(1,writer.loops_);
+    EXPECT_EQ(1,polled.loops_);
+    EXPECT_EQ(1,inverted.loops_);
+
+    // Nothing changed
+    collection.loop();
+    collection.loop();
+    EXPECT_EQ(1,reader.loops_);
+    EXPECT_EQ(1,writer.loops_);
+    EXPECT_EQ(3,polled.loops_);
+    EXPECT_EQ(1,inverted.loops_);
+
+    // The change to 'middle' made by the writer reaches the reader in the
+    // same loop
+    input.set_state(true);
+    collection.loop();
+    EXPECT_TRUE(middle.is_active());
+    EXPECT_EQ(2,reader.loops_);
+    EXPECT_EQ(2,writer.loops_);
+    EXPECT_EQ(2,inverted.loops_);
+
+    // Setting an unchanged state or an unread sensor is not a change
+    input.set_state(true);
+    unrelated.set_state(false);
+    collection.loop();
+    EXPECT_EQ(2,reader.loops_);
+    EXPECT_EQ(2,writer.loops_);
+    EXPECT_EQ(2,inverted.loops_);
+    EXPECT_EQ(5,polled.loops_);
+}
+
+/*
+ * Signal logic follows its protected sensors and heads under change
+ * propagation, and keeps retrying a head that did not take its new aspect
+ */
+TEST(Logic_Collection,ChangePropagationRyg)
+{
+    Logic_collection collection(3);
+
+    Sensor_base block_1, block_2, block_3;
+    Test_head head_1("1"), head_2("2");
+    Refusing_head head_3;
+
+    // head_1 protects block_1 and head_2, which protects block_2
+    Simple_ryg_logic logic_1(collection, head_1, head_2, {&block_1});
+    Simple_ryg_logic logic_2(collection, head_2, {&block_2});
+    Simple_ryg_logic logic_3(collection, head_3, {&block_3});
+
+    collection.enable_change_propagation();
+
+    block_1.set_state(false);
+    block_2.set_state(false);
+    block_3.set_state(false);
+
+    collection.loop();
+    EXPECT_EQ(Head_aspect::green,head_1.get_aspect());
+    EXPECT_EQ(Head_aspect::green,head_2.get_aspect());
+    EXPECT_EQ(Head_aspect::unknown,head_3.get_aspect());
+    EXPECT_FALSE(logic_3.is_settled());
+
+    // head_2 falls to red and head_1 to yellow in the same loop
+    block_2.set_state(true);
+    collection.loop();
+    EXPECT_EQ(Head_aspect::red,head_2.get_aspect());
+    EXPECT_EQ(Head_aspect::yellow,head_1.get_aspect());
+
+    // head_3 takes its aspect once it accepts, with no input change
+    collection.loop();
+    EXPECT_EQ(Head_aspect::unknown,head_3.get_aspect());
+    head_3.accept_ = true;
+    collection.loop();
+    EXPECT_EQ(Head_aspect::green,head_3.get_aspect());
+    EXPECT_TRUE(logic_3.is_settled());
+
+    block_2.set_state(false);
+    collection.loop();
+    EXPECT_EQ(Head_aspect::green,head_2.get_aspect());
+    EXPECT_EQ(Head_aspect::green,head_1.get_aspect());
+}
+
 /*
  * Test an interlocking lever with a pushkey controlling a Call-On signal head
  *
@@ -633,6 +780,40 @@ TEST(Simple_ryg_logic_test, Protect1SensorsOnly)
     EXPECT_EQ(Head_aspect::green, head_.get_aspect());
 }
 
+/*
+ * Static_simple_ryg_logic and Static_interlocked_ryg_logic hold their
+ * protected sensors in the object, and set the same aspects as the classes
+ * that copy them to Startup_arena storage
+ */
+TEST(Simple_ryg_logic_test, StaticSensors)
+{
+    Logic_collection collection_(4);
+    Test_head head_, static_head_, interlocked_head_, static_interlocked_head_;
+    Sensor_base sensor_1_;
+    Sensor_base sensor_2_;
+    Sensor_base lever_;
+
+    Simple_ryg_logic test_mast_(collection_, head_, {&sensor_1_, &sensor_2_});
+    Static_simple_ryg_logic<3> static_mast_(collection_, static_head_, {&sensor_1_, &sensor_2_});
+    Interlocked_ryg_logic interlocked_mast_(collection_, interlocked_head_, lever_, {&sensor_1_, &sensor_2_});
+    Static_interlocked_ryg_logic<2> static_interlocked_mast_(collection_, static_interlocked_head_, lever_,
+                                                             {&sensor_1_, &sensor_2_});
+
+    lever_.set_state(true);
+
+    for(int states = 0; states < 4; states++) {
+        sensor_1_.set_state(states & 1);
+        sensor_2_.set_state(states & 2);
+        collection_.loop();
+
+        Head_aspect expected = states ? Head_aspect::red : Head_aspect::green;
+        EXPECT_EQ(expected, head_.get_aspect());
+        EXPECT_EQ(expected, static_head_.get_aspect());
+        EXPECT_EQ(expected, interlocked_head_.get_aspect());
+        EXPECT_EQ(expected, static_interlocked_head_.get_aspect());
+    }
+}
+
 /*
  * Test the behaviour of Simple_ryg_logic with only a head
  * attached; the head should go and stay green with no
@@ -935,6 +1116,40 @@ TEST_F(Double_switch_test,HeldStates)
 
 }
 
+/*
+ * Test that the switches of a Double_switch_head are requested urgently only
+ * when the head becomes more restrictive, and not for the initial aspect
+ */
+
+TEST_F(Double_switch_test,RestrictingPriority)
+{
+    SetUp();
+
+    // Initial aspect (from unknown) is not urgent, even when red
+    EXPECT_TRUE(head_->request_aspect(Head_aspect::red));
+    EXPECT_EQ(Switch_priority::normal,test_switch_1_.get_last_priority());
+    EXPECT_EQ(Switch_priority::normal,test_switch_2_.get_last_priority());
+
+    // Clearing is not urgent
+    EXPECT_TRUE(head_->request_aspect(Head_aspect::green));
+    EXPECT_EQ(Switch_priority::normal,test_switch_2_.get_last_priority());
+
+    // Green to yellow and yellow to red are
+    EXPECT_TRUE(head_->request_aspect(Head_aspect::yellow));
+    EXPECT_EQ(Switch_priority::urgent,test_switch_1_.get_last_priority());
+    EXPECT_EQ(Switch_priority::urgent,test_switch_2_.get_last_priority());
+
+    EXPECT_TRUE(head_->request_aspect(Head_aspect::red));
+    EXPECT_EQ(Switch_priority::urgent,test_switch_2_.get_last_priority());
+
+    // Red to dark is not
+    EXPECT_TRUE(head_->request_aspect(Head_aspect::dark));
+    EXPECT_EQ(Switch_priority::normal,test_switch_2_.get_last_priority());
+
+    EXPECT_TRUE(head_->request_aspect(Head_aspect::yellow));
+    EXPECT_EQ(Switch_priority::normal,test_switch_2_.get_last_priority());
+}
+
 /*
  * Test that the states of the switch associated with a Single_switch_head
  * set as expected for the supported aspects.
@@ -1653,6 +1868,132 @@ Sensor_base lever_1;    // Have to be globals to use in template Two_lever_inter
 Sensor_base lever_2;
 
 
+/*
+ * A train running down through 20 blocks leaves the up tumbledowns set from
+ * its block onwards, across the bytes the tumbledowns are held in, and each
+ * tumbledown change is reported for change propagation
+ */
+TEST(Apb_logic,full_apb_20_sensor) {
+
+    Logic_collection collection(2);
+
+    Sensor_base blocks[20];
+
+    Full_apb apb_test(collection, {&blocks[0], &blocks[1], &blocks[2], &blocks[3], &blocks[4],
+                                   &blocks[5], &blocks[6], &blocks[7], &blocks[8], &blocks[9],
+                                   &blocks[10], &blocks[11], &blocks[12], &blocks[13], &blocks[14],
+                                   &blocks[15], &blocks[16], &blocks[17], &blocks[18], &blocks[19]});
+
+    // Only evaluated when a change of up tumbledown 10 is reported
+    Sensor_base up_10_copy;
+    Counting_logic copier(collection, apb_test.up_tumbledown_num(10), &up_10_copy);
+
+    collection.enable_change_propagation();
+
+    for(Sensor_base& block : blocks) {
+        block.set_state(false);
+    }
+    collection.loop();
+
+    for(uint8_t i = 0; i < 20; i++) {
+        EXPECT_FALSE(apb_test.up_tumbledown_num(i).is_indeterminate());
+        EXPECT_FALSE(apb_test.up_tumbledown_num(i).is_active());
+        EXPECT_FALSE(apb_test.down_tumbledown_num(i).is_active());
+    }
+    EXPECT_FALSE(up_10_copy.is_active());
+
+    // Train enters the first block in the down direction
+    blocks[0].set_state(true);
+    collection.loop();
+
+    for(uint8_t i = 0; i < 20; i++) {
+        EXPECT_TRUE(apb_test.up_tumbledown_num(i).is_active());
+        EXPECT_FALSE(apb_test.down_tumbledown_num(i).is_active());
+    }
+    EXPECT_TRUE(up_10_copy.is_active());
+
+    // Train moves on to block 12
+    for(uint8_t block = 1; block <= 12; block++) {
+        blocks[block].set_state(true);
+        collection.loop();
+        blocks[block - 1].set_state(false);
+        collection.loop();
+    }
+
+    for(uint8_t i = 0; i < 20; i++) {
+        EXPECT_EQ(i >= 12, apb_test.up_tumbledown_num(i).is_active()) << (int)i;
+        EXPECT_FALSE(apb_test.down_tumbledown_num(i).is_active());
+    }
+    EXPECT_FALSE(up_10_copy.is_active());
+
+    // Nothing changes, so the copier is not evaluated
+    int copier_loops = copier.loops_;
+    collection.loop();
+    EXPECT_EQ(copier_loops, copier.loops_);
+
+    // Train leaves the section
+    blocks[12].set_state(false);
+    collection.loop();
+
+    for(uint8_t i = 0; i < 20; i++) {
+        EXPECT_FALSE(apb_test.up_tumbledown_num(i).is_active());
+    }
+
+    // Out of range tumbledowns are the first
+    EXPECT_EQ(&apb_test.up_tumbledown_num(0), &apb_test.up_tumbledown_num(20));
+    EXPECT_EQ(&apb_test.down_tumbledown_num(0), &apb_test.down_tumbledown_num(20));
+}
+
+/*
+ * Static_simple_apb and Static_full_apb hold their sensors (and Full_apb's
+ * tumbledowns) in the object, and follow the classes that allocate them on
+ * the heap through a run of block states
+ */
+TEST(Apb_logic,static_apb) {
+
+    Logic_collection collection(4);
+
+    Sensor_base blocks[9];
+
+    Simple_apb simple(collection, {&blocks[0], &blocks[4], &blocks[8]});
+    Static_simple_apb<3> static_simple(collection, {&blocks[0], &blocks[4], &blocks[8]});
+
+    Full_apb full(collection, {&blocks[0], &blocks[1], &blocks[2], &blocks[3], &blocks[4],
+                               &blocks[5], &blocks[6], &blocks[7], &blocks[8]});
+    Static_full_apb<12> static_full(collection, {&blocks[0], &blocks[1], &blocks[2], &blocks[3], &blocks[4],
+                                                 &blocks[5], &blocks[6], &blocks[7], &blocks[8]});
+
+    // Tumbledowns are indeterminate until every block is known
+    collection.loop();
+    EXPECT_TRUE(static_simple.up_tumbledown().is_indeterminate());
+    EXPECT_TRUE(static_full.up_tumbledown_num(8).is_indeterminate());
+
+    // Trains entering from either end and running through, in turn
+    uint32_t seed = 1;
+    for(int step = 0; step < 500; step++) {
+        seed = seed * 1103515245 + 12345;
+        blocks[(seed >> 16) % 9].set_state((seed >> 8) & 1);
+
+        if(0 == step) {
+            for(Sensor_base& block : blocks) {
+                block.set_state(false);
+            }
+        }
+
+        collection.loop();
+
+        EXPECT_EQ(simple.up_tumbledown().is_active(), static_simple.up_tumbledown().is_active());
+        EXPECT_EQ(simple.down_tumbledown().is_active(), static_simple.down_tumbledown().is_active());
+
+        for(uint8_t i = 0; i < 9; i++) {
+            EXPECT_EQ(full.up_tumbledown_num(i).is_active(), static_full.up_tumbledown_num(i).is_active());
+            EXPECT_EQ(full.down_tumbledown_num(i).is_active(), static_full.down_tumbledown_num(i).is_active());
+        }
+    }
+
+    EXPECT_FALSE(static_full.up_tumbledown_num(8).is_indeterminate());
+}
+
 TEST(LeverInterlock, BasicTest) {
 
     Logic_collection logic(1);
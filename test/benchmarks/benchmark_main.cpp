@@ -0,0 +1,64 @@
+/*
+ * benchmark_main.cpp
+ *
+ * Entry point for the host micro-benchmarks.  Built separately from the
+ * gtest suites (which have their own main()) against the same mocks, with
+ * the command below (as one line) run from the repository root.
+ *
+ * As well as the console report, the results are written as JSON to
+ * mr_signals_benchmarks.json (unless --benchmark_out is given), so that they
+ * can be compared between releases with Google Benchmark's compare.py.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// g++ -std=c++14 -O2 -Isrc -Isrc/base -Isrc/loconet -Itest src/base/*.cpp
+//     src/loconet/*.cpp test/arduino_mock.cpp test/mrrwa_loconet_mock.cpp
+//     test/loconet_bus_sim.cpp test/loconet_replay.cpp test/benchmarks/*.cpp
+//     -lbenchmark -lgmock -lgtest -lpthread -o mr_signals_benchmarks
+
+#include "benchmark/benchmark.h"
+
+#include <cstring>
+#include <vector>
+
+bool debug__=false;
+
+namespace {
+
+const char* default_out = "--benchmark_out=mr_signals_benchmarks.json";
+const char* default_out_format = "--benchmark_out_format=json";
+
+}
+
+
+int main(int argc, char** argv)
+{
+    std::vector<char*> args(argv, argv + argc);
+    bool has_out = false;
+
+    for(int i = 1; i < argc; i++) {
+        if(0 == strncmp(argv[i], "--benchmark_out=", strlen("--benchmark_out="))) {
+            has_out = true;
+        }
+    }
+
+    if(!has_out) {
+        args.push_back(const_cast<char*>(default_out));
+        args.push_back(const_cast<char*>(default_out_format));
+    }
+
+    int count = args.size();
+    args.push_back(nullptr);
+
+    benchmark::Initialize(&count, args.data());
+
+    if(benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * circular_buffer_benchmarks.cpp
+ *
+ * Compares the per-byte cost of the power-of-two Circular_buffer template
+ * against the heap allocated, modulo wrapped buffer it replaced.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+#include "circular_buffer.h"
+
+#include <cstddef>
+#include <new>
+
+
+namespace {
+
+/*
+ * Copy of the original (pre-template) Circular_buffer, kept only as the
+ * baseline for these benchmarks
+ */
+class Modulo_circular_buffer {
+
+public:
+    Modulo_circular_buffer() : buffer_(nullptr), head_(0), tail_(0), count_(0), buffer_size_(0), high_watermark_(0) {}
+
+    ~Modulo_circular_buffer() { delete[] buffer_; }
+
+    bool initialize(const std::size_t size) {
+        if(nullptr == buffer_ && size >= 2) {
+            buffer_ = new (std::nothrow) uint8_t[size];
+            if(buffer_) {
+                buffer_size_ = size;
+                head_ = 0;
+                tail_ = buffer_size_-1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool enqueue(const uint8_t& byte) {
+        if(count_ < buffer_size_) {
+            tail_ = (tail_+1) % buffer_size_;
+            buffer_[tail_] = byte;
+            count_ ++;
+            if(count_ > high_watermark_) {
+                high_watermark_ = count_;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool dequeue(uint8_t& byte) {
+        if(count_ > 0) {
+            byte = buffer_[head_];
+            head_ = (head_+1) % buffer_size_;
+            count_--;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    uint8_t *buffer_;
+    std::size_t head_;
+    std::size_t tail_;
+    std::size_t count_;
+    std::size_t buffer_size_;
+    std::size_t high_watermark_;
+};
+
+
+const std::size_t bench_buffer_size = 512;
+const std::size_t bench_burst = 12;     // Four 3-byte OPC_SW_REQ messages
+
+
+/*
+ * Enqueue a short burst then drain it, as the LocoNet transmit path does.
+ * The buffer size is passed at run time to stop the compiler turning the
+ * modulo into a mask, as it could not on the target.
+ */
+void BM_modulo_circular_buffer(benchmark::State& state)
+{
+    Modulo_circular_buffer buffer;
+    buffer.initialize(static_cast<std::size_t>(state.range(0)));
+
+    uint8_t byte = 0;
+
+    for(auto _ : state) {
+        for(std::size_t i = 0; i < bench_burst; i++) {
+            buffer.enqueue(byte++);
+        }
+        for(std::size_t i = 0; i < bench_burst; i++) {
+            buffer.dequeue(byte);
+        }
+        benchmark::DoNotOptimize(byte);
+    }
+
+    state.SetItemsProcessed(state.iterations() * bench_burst);
+}
+BENCHMARK(BM_modulo_circular_buffer)->Arg(bench_buffer_size);
+
+
+void BM_masked_circular_buffer(benchmark::State& state)
+{
+    Circular_buffer<uint8_t, bench_buffer_size> buffer;
+
+    uint8_t byte = 0;
+
+    for(auto _ : state) {
+        for(std::size_t i = 0; i < bench_burst; i++) {
+            buffer.enqueue(byte++);
+        }
+        for(std::size_t i = 0; i < bench_burst; i++) {
+            buffer.dequeue(byte);
+        }
+        benchmark::DoNotOptimize(byte);
+    }
+
+    state.SetItemsProcessed(state.iterations() * bench_burst);
+}
+BENCHMARK(BM_masked_circular_buffer);
+
+}   // namespace
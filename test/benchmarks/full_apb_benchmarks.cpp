@@ -0,0 +1,90 @@
+/*
+ * full_apb_benchmarks.cpp
+ *
+ * Cost of Full_apb::loop() against the number of protected blocks (the
+ * second template argument), with a train moving through the blocks one block
+ * every 8th loop, alternating direction on each pass through.  Run for
+ * Full_apb, which draws its sensors and tumbledowns from Startup_arena (the
+ * heap here), and Static_full_apb, which holds them in the object.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "apb_logic.h"
+#include "logic_collection.h"
+#include "sensor_interface.h"
+
+#include <iostream>
+#include <utility>      // std::index_sequence
+#include <vector>
+
+using namespace mr_signals;
+
+
+namespace {
+
+const uint32_t move_period = 8;
+
+
+/// The logic only takes a braced list, so expand one of N blocks
+template <class Apb, std::size_t... I>
+Full_apb* make_full_apb(Logic_collection& collection, std::vector<Sensor_base>& blocks, std::index_sequence<I...>)
+{
+    return new Apb(collection, {&blocks[I]...});
+}
+
+
+template <class Apb, std::size_t N>
+void BM_full_apb_loop(benchmark::State& state)
+{
+    Logic_collection collection(1);
+    std::vector<Sensor_base> blocks(N);
+
+    for(Sensor_base& block : blocks) {
+        block.set_state(false);
+    }
+
+    Full_apb* apb = make_full_apb<Apb>(collection, blocks, std::make_index_sequence<N>());
+
+    // State changes are traced to Serial (std::cout); discard them
+    std::cout.setstate(std::ios::badbit);
+
+    apb->loop();
+
+    uint32_t loops = 0;
+    std::size_t position = 0;   // Position of the train within a pass through and out of the blocks
+    bool down = true;
+
+    for(auto _ : state) {
+        if(0 == ++loops % move_period) {
+            if(position < N) {
+                blocks[down ? position : N - 1 - position].set_state(false);
+            }
+
+            if(++position > N) {
+                position = 0;
+                down = !down;
+            }
+
+            if(position < N) {
+                blocks[down ? position : N - 1 - position].set_state(true);
+            }
+        }
+
+        apb->loop();
+    }
+
+    std::cout.clear();
+
+    delete apb;
+}
+BENCHMARK_TEMPLATE(BM_full_apb_loop, Full_apb, 4);
+BENCHMARK_TEMPLATE(BM_full_apb_loop, Full_apb, 16);
+BENCHMARK_TEMPLATE(BM_full_apb_loop, Full_apb, 64);
+BENCHMARK_TEMPLATE(BM_full_apb_loop, Static_full_apb<4>, 4);
+BENCHMARK_TEMPLATE(BM_full_apb_loop, Static_full_apb<16>, 16);
+BENCHMARK_TEMPLATE(BM_full_apb_loop, Static_full_apb<64>, 64);
+
+}   // namespace
@@ -0,0 +1,141 @@
+/*
+ * loconet_replay_benchmarks.cpp
+ *
+ * Cost of replaying LocoNet traffic through the adapter with Loconet_replay,
+ * as fast as the adapter takes it (one loop() per simulated ms).  The
+ * synthetic capture is a global power on burst: every sensor (the benchmark
+ * argument) reports active then inactive, back to back on the bus (4ms
+ * each).  A capture recorded on a layout is also replayed when its path is
+ * given in the environment variable MR_SIGNALS_REPLAY_CAPTURE.  A sensor is
+ * attached at each address reported in the capture.
+ *
+ * Reported counters:
+ *
+ *  messages    - received messages replayed, and their rate
+ *  passes      - loop() calls to replay them
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "loconet_replay.h"
+#include "loconet_bus_sim.h"        // Loconet_bus_sim::report_sensor() message encoding
+#include "mrrwa_loconet_adapter.h"
+#include "loconet_txmgr.h"
+
+#include "arduino_mock.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace mr_signals;
+
+
+namespace {
+
+/// Capture of a power on burst, recorded through Loconet_capture
+std::vector<uint8_t> power_on_capture(std::size_t sensor_count)
+{
+    init_millis();
+
+    Loconet_capture capture;
+    Loconet_bus_sim bus({ 8, 25, 0, 0, 1 });
+    std::ostringstream out;
+
+    for(int state = 1; state >= 0; state--) {
+        for(std::size_t i = 0; i < sensor_count; i++) {
+            bus.report_sensor(1 + i, state);
+            set_millis(millis() + 4);      // Received once carried by the bus
+
+            capture.record(Loconet_capture_direction::rx, bus.receive()->data);
+            capture.dump(out);
+        }
+    }
+
+    std::string text = out.str();
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+/// Addresses of the sensors reported in a capture
+std::vector<Loconet_address> reported_addresses(const std::vector<uint8_t>& bytes)
+{
+    std::vector<Loconet_address> addresses;
+    Loconet_capture_reader reader(bytes.data(), bytes.size());
+    Loconet_capture_entry entry;
+
+    while(reader.next(entry)) {
+        if(Loconet_capture_direction::rx == entry.direction && OPC_INPUT_REP == entry.message[0]) {
+            Loconet_address address = entry.message[1] | ((entry.message[2] & 0x0F) << 7);
+            address = (address << 1) + ((entry.message[2] & OPC_INPUT_REP_SW) ? 2 : 1);
+
+            if(addresses.end() == std::find(addresses.begin(), addresses.end(), address)) {
+                addresses.push_back(address);
+            }
+        }
+    }
+
+    return addresses;
+}
+
+void replay(benchmark::State& state, const std::vector<uint8_t>& bytes)
+{
+    const std::vector<Loconet_address> addresses = reported_addresses(bytes);
+
+    uint32_t received = 0;
+    uint32_t passes = 0;
+
+    // The adapter traces each message to Serial (std::cout); discard it
+    std::cout.setstate(std::ios::badbit);
+
+    for(auto _ : state) {
+        init_millis();
+
+        Loconet_replay loconet(bytes.data(), bytes.size(), 0);
+        Setup_collection setup_coll(1);
+        Loop_collection loop_coll(1);
+        Loconet_txmgr tx_mgr;
+        Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, loconet, 2, addresses.size(),
+                                      MRRWA_LN_TX_BUFFER_CAPACITY, tx_mgr);
+
+        std::vector<std::unique_ptr<Loconet_sensor>> sensors;
+        for(Loconet_address address : addresses) {
+            sensors.emplace_back(new Loconet_sensor("S", address, adapter));
+        }
+
+        passes = loconet.run([&]() { adapter.loop(); });
+        received = loconet.get_received();
+    }
+
+    std::cout.clear();
+
+    state.counters["messages"] = received;
+    state.counters["message_rate"] = benchmark::Counter(received, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["passes"] = passes;
+}
+
+
+void BM_replay_power_on(benchmark::State& state)
+{
+    replay(state, power_on_capture(state.range(0)));
+}
+BENCHMARK(BM_replay_power_on)->Arg(16)->Arg(64)->Arg(300)->Unit(benchmark::kMicrosecond);
+
+
+void BM_replay_capture_file(benchmark::State& state, std::string path)
+{
+    replay(state, Loconet_replay::load(path));
+}
+
+const char* capture_path = getenv("MR_SIGNALS_REPLAY_CAPTURE");
+
+benchmark::internal::Benchmark* capture_file_benchmark = capture_path ?
+        benchmark::RegisterBenchmark("BM_replay_capture_file", BM_replay_capture_file,
+                                     std::string(capture_path))->Unit(benchmark::kMicrosecond) : nullptr;
+
+}   // namespace
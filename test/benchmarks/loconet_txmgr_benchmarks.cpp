@@ -0,0 +1,70 @@
+/*
+ * loconet_txmgr_benchmarks.cpp
+ *
+ * Startup drain time of a full transmit queue with each transmission
+ * manager, on the Loconet_bus_sim bus and command station model: switch
+ * requests are held in a buffer of 8 that the station empties onto DCC at one
+ * command every 25ms (or 50ms for a slower station, the first benchmark
+ * argument), and a request arriving with the buffer full is answered with a
+ * LONG_ACK (so must be retransmitted).  With the second argument set, the bus
+ * is noisy: 5% of messages find another device transmitting and 2% collide.
+ *
+ * Reported counters (simulated time):
+ *
+ *  drain_ms    - time until the last queued request was accepted
+ *  long_acks   - LONG_ACKs received
+ *  dropped     - requests given up after the retransmit limit
+ *  collisions  - messages sent that collided
+ *  bus_util    - bus busy time, parts per thousand
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "loconet_bus_sim.h"
+#include "loconet_txmgr.h"
+#include "loconet_aimd_txmgr.h"
+#include "loconet_token_bucket_txmgr.h"
+
+using namespace mr_signals;
+
+
+namespace {
+
+/// Loconet_txmgr with its slow period started at power on
+struct Slow_start_txmgr : public Loconet_txmgr {
+    Slow_start_txmgr() { set_slow_duration(0); }
+};
+
+
+template <class Txmgr>
+void BM_startup_drain(benchmark::State& state)
+{
+    const bool noisy = state.range(1);
+    const Loconet_bus_config config = { 8, (Runtime_ms)state.range(0),
+                                        (uint16_t)(noisy ? 50 : 0), (uint16_t)(noisy ? 20 : 0), 1 };
+
+    Startup_result result = {};
+
+    for(auto _ : state) {
+        Txmgr tx_mgr;
+
+        result = simulate_startup(tx_mgr, config);
+    }
+
+    state.counters["drain_ms"] = result.drain_ms;
+    state.counters["long_acks"] = result.long_acks;
+    state.counters["dropped"] = result.dropped;
+    state.counters["collisions"] = result.collisions;
+    state.counters["bus_util"] = result.utilization_per_mille;
+}
+
+#define STARTUP_DRAIN_ARGS ->Args({25, 0})->Args({50, 0})->Args({25, 1})->Args({50, 1})->Iterations(1)->Unit(benchmark::kMillisecond)
+
+BENCHMARK_TEMPLATE(BM_startup_drain, Slow_start_txmgr) STARTUP_DRAIN_ARGS;
+BENCHMARK_TEMPLATE(BM_startup_drain, Loconet_txmgr) STARTUP_DRAIN_ARGS;
+BENCHMARK_TEMPLATE(BM_startup_drain, Loconet_aimd_txmgr) STARTUP_DRAIN_ARGS;
+BENCHMARK_TEMPLATE(BM_startup_drain, Loconet_token_bucket_txmgr) STARTUP_DRAIN_ARGS;
+
+}   // namespace
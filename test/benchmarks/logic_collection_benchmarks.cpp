@@ -0,0 +1,130 @@
+/*
+ * logic_collection_benchmarks.cpp
+ *
+ * Per-loop cost of Logic_collection::loop() for N logic (the benchmark
+ * argument), with one block changing state every 64th loop: evaluating every
+ * logic on every loop against evaluating only the logic whose inputs
+ * changed.  The logic is either a line of signals, each protecting its block
+ * and the next head, or a run of Simple_apb sections of three blocks each.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "logic_collection.h"
+#include "ryg_logic.h"
+#include "apb_logic.h"
+#include "sensor_interface.h"
+#include "head_interface.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace mr_signals;
+
+
+namespace {
+
+const uint32_t change_period = 64;
+
+
+struct Signal_line {
+    explicit Signal_line(std::size_t count) : collection(count), blocks(count), heads(count)
+    {
+        for(std::size_t i = 0; i < count; i++) {
+            blocks[i].set_state(false);
+
+            if(i + 1 < count) {
+                logic.emplace_back(new Simple_ryg_logic(collection, heads[i], heads[i+1], {&blocks[i]}));
+            }
+            else {
+                logic.emplace_back(new Simple_ryg_logic(collection, heads[i], {&blocks[i]}));
+            }
+        }
+    }
+
+    Logic_collection collection;
+    std::vector<Sensor_base> blocks;
+    std::vector<Test_head> heads;
+    std::vector<std::unique_ptr<Simple_ryg_logic>> logic;
+};
+
+
+/// Sections of three blocks, each protected by a Simple_apb
+struct Apb_line {
+    explicit Apb_line(std::size_t count) : collection(count), blocks(3 * count)
+    {
+        for(std::size_t i = 0; i < count; i++) {
+            for(std::size_t block = 3 * i; block < 3 * i + 3; block++) {
+                blocks[block].set_state(false);
+            }
+
+            logic.emplace_back(new Simple_apb(collection, {&blocks[3 * i], &blocks[3 * i + 1], &blocks[3 * i + 2]}));
+        }
+    }
+
+    Logic_collection collection;
+    std::vector<Sensor_base> blocks;
+    std::vector<std::unique_ptr<Simple_apb>> logic;
+};
+
+
+template <class Line>
+void run_line(benchmark::State& state, bool propagate)
+{
+    Line line(state.range(0));
+
+    if(propagate) {
+        line.collection.enable_change_propagation();
+    }
+
+    // Aspect changes are traced to Serial (std::cout); discard them
+    std::cout.setstate(std::ios::badbit);
+
+    line.collection.loop();
+
+    uint32_t loops = 0;
+
+    for(auto _ : state) {
+        if(0 == ++loops % change_period) {
+            Sensor_base& block = line.blocks[(loops / change_period) % line.blocks.size()];
+            block.set_state(!block.is_active());
+        }
+
+        line.collection.loop();
+    }
+
+    std::cout.clear();
+}
+
+
+void BM_logic_every_loop(benchmark::State& state)
+{
+    run_line<Signal_line>(state, false);
+}
+BENCHMARK(BM_logic_every_loop)->Arg(10)->Arg(100)->Arg(1000);
+
+
+void BM_logic_on_change(benchmark::State& state)
+{
+    run_line<Signal_line>(state, true);
+}
+BENCHMARK(BM_logic_on_change)->Arg(10)->Arg(100)->Arg(1000);
+
+
+void BM_apb_logic_every_loop(benchmark::State& state)
+{
+    run_line<Apb_line>(state, false);
+}
+BENCHMARK(BM_apb_logic_every_loop)->Arg(10)->Arg(100)->Arg(1000);
+
+
+void BM_apb_logic_on_change(benchmark::State& state)
+{
+    run_line<Apb_line>(state, true);
+}
+BENCHMARK(BM_apb_logic_on_change)->Arg(10)->Arg(100)->Arg(1000);
+
+}   // namespace
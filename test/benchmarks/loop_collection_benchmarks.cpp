@@ -0,0 +1,79 @@
+/*
+ * loop_collection_benchmarks.cpp
+ *
+ * Per-pass cost of Loop_collection::execute() for N tasks (the benchmark
+ * argument) with one pass per millisecond: every task run on every pass
+ * against tasks with a 20ms period, spread over the period.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "loop_funcs.h"
+#include "arduino_mock.h"
+
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+const uint16_t task_period_ms = 20;
+
+
+/// Stands in for a task such as a head or sensor poll
+class Work_task : public Loop_interface {
+public:
+    Work_task(Loop_collection& collection, uint16_t period_ms) :
+        Loop_interface(collection, period_ms), total_(0) {}
+
+    void loop() override {
+        for(int i = 0; i < 32; i++) {
+            total_ += i;
+        }
+    }
+
+    volatile uint32_t total_;
+};
+
+
+void run_tasks(benchmark::State& state, uint16_t period_ms)
+{
+    const std::size_t count = state.range(0);
+
+    Loop_collection collection(count);
+    std::vector<std::unique_ptr<Work_task>> tasks;
+
+    init_millis();
+
+    // Attach a task per ms so that the periodic tasks are spread out
+    for(std::size_t i = 0; i < count; i++) {
+        tasks.emplace_back(new Work_task(collection, period_ms));
+        set_millis(i % task_period_ms);   // Task i first runs here
+        collection.execute();
+    }
+
+    unsigned long now = task_period_ms;
+
+    for(auto _ : state) {
+        set_millis(++now);
+        collection.execute();
+    }
+}
+
+
+void BM_loop_every_pass(benchmark::State& state)
+{
+    run_tasks(state, 0);
+}
+BENCHMARK(BM_loop_every_pass)->Arg(8)->Arg(64);
+
+
+void BM_loop_periodic(benchmark::State& state)
+{
+    run_tasks(state, task_period_ms);
+}
+BENCHMARK(BM_loop_periodic)->Arg(8)->Arg(64);
+
+}   // namespace
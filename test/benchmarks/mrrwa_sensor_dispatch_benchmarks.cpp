@@ -0,0 +1,118 @@
+/*
+ * mrrwa_sensor_dispatch_benchmarks.cpp
+ *
+ * Cost of dispatching one received sensor report to the attached sensors
+ * against the number of sensors (the benchmark argument): the linear
+ * std::find_if scan that notify_sensors() used, against the adapter's binary
+ * search of its address sorted sensors.  Reports cycle through every
+ * attached address, as in a global power on burst.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+#include "mrrwa_loconet_adapter.h"
+#include "loconet_txmgr.h"
+
+#include "arduino_mock.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace mr_signals;
+
+using ::testing::NiceMock;
+
+
+namespace {
+
+/// Attaches sensors at scrambled addresses from 1
+struct Sensor_layout {
+    explicit Sensor_layout(std::size_t count) :
+        tx_mgr(), setup_coll(1), loop_coll(1),
+        adapter(setup_coll, loop_coll, loconet_mock, 2, count, MRRWA_LN_TX_BUFFER_CAPACITY, tx_mgr)
+    {
+        for(std::size_t i = 0; i < count; i++) {
+            Loconet_address address = 1 + (i * 7919) % count;
+            sensors.emplace_back(new Loconet_sensor("S", address, adapter));
+            addresses.push_back(address);
+        }
+    }
+
+    NiceMock<LocoNetMock> loconet_mock;
+    Loconet_txmgr tx_mgr;
+    Setup_collection setup_coll;
+    Loop_collection loop_coll;
+    Mrrwa_loconet_adapter adapter;
+
+    std::vector<std::unique_ptr<Loconet_sensor>> sensors;
+    std::vector<Loconet_address> addresses;
+};
+
+
+void BM_linear_sensor_dispatch(benchmark::State& state)
+{
+    Sensor_layout layout(state.range(0));
+
+    // Attach order, as the adapter held them
+    std::vector<Loconet_sensor*> sensors;
+    for(auto& sensor : layout.sensors) {
+        sensors.push_back(sensor.get());
+    }
+
+    std::size_t report = 0;
+    bool sensor_state = false;
+
+    // Traced as notify_sensors() does; discard it
+    std::cout.setstate(std::ios::badbit);
+
+    for(auto _ : state) {
+        Loconet_address address = layout.addresses[report];
+
+        std::find_if(sensors.begin(), sensors.end(), [address, sensor_state](Loconet_sensor* sensor) {
+            if(sensor->notify(address, sensor_state)) {
+                std::cout << "\nSet Sensor " << sensor->get_name() << " -> " << (sensor_state ? "Active" : "Inactive");
+                return true;
+            }
+            return false;
+        });
+
+        if(++report == layout.addresses.size()) {
+            report = 0;
+            sensor_state = !sensor_state;
+        }
+    }
+
+    std::cout.clear();
+}
+BENCHMARK(BM_linear_sensor_dispatch)->Arg(16)->Arg(64)->Arg(300)->Arg(1000);
+
+
+void BM_sorted_sensor_dispatch(benchmark::State& state)
+{
+    Sensor_layout layout(state.range(0));
+
+    std::size_t report = 0;
+    bool sensor_state = false;
+
+    // notify_sensors() traces each notification to Serial (std::cout); discard it
+    std::cout.setstate(std::ios::badbit);
+
+    for(auto _ : state) {
+        layout.adapter.notify_sensors(layout.addresses[report], sensor_state);
+
+        if(++report == layout.addresses.size()) {
+            report = 0;
+            sensor_state = !sensor_state;
+        }
+    }
+
+    std::cout.clear();
+}
+BENCHMARK(BM_sorted_sensor_dispatch)->Arg(16)->Arg(64)->Arg(300)->Arg(1000);
+
+}   // namespace
@@ -0,0 +1,109 @@
+/*
+ * mrrwa_tx_buffer_benchmarks.cpp
+ *
+ * Drain throughput of the record framed Mrrwa_loconet_tx_buffer against the
+ * raw byte stream buffer it replaced (which re-parsed each message's length
+ * with getLnMsgSize() as it was dequeued).
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+#include "mrrwa_loconet_adapter.h"
+
+using namespace mr_signals;
+
+
+namespace {
+
+/*
+ * Copy of the byte stream transmit buffer, kept only as the baseline for
+ * these benchmarks
+ */
+class Byte_stream_tx_buffer {
+public:
+    bool queue_loconet_msg(lnMsg& msg) {
+        uint8_t msg_len = getLnMsgSize(&msg);
+
+        if(msg_len > 2) {
+            msg_len--;
+        }
+
+        if(msg_len <= sizeof(lnMsg) && msg_len >= 2 && msg_len <= buffer_.get_free()) {
+            return buffer_.enqueue(msg.data, msg_len);
+        }
+        return false;
+    }
+
+    bool dequeue_loconet_msg(lnMsg& msg) {
+        if(buffer_.peek(msg.data, 2)) {
+            uint8_t msg_len = getLnMsgSize(&msg);
+            uint8_t stored_len = (msg_len > 2) ? msg_len - 1 : 2;
+
+            (void) buffer_.peek(&msg.data[2], stored_len - 2, 2);
+            buffer_.consume(stored_len);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    Circular_buffer<uint8_t, MRRWA_LN_TX_BUFFER_CAPACITY> buffer_;
+};
+
+
+/// Fill the buffer with a startup-like mix of switch requests and delays
+template <class Buffer>
+std::size_t fill(Buffer& buffer)
+{
+    lnMsg sw_req;
+    sw_req.data[0] = OPC_SW_REQ;
+    sw_req.data[2] = 0x10;
+
+    lnMsg delay;
+    delay.data[0] = OPC_IDLE;
+    delay.data[1] = 20;
+
+    std::size_t count = 0;
+
+    for(uint8_t i = 0; ; i++) {
+        sw_req.data[1] = i & 0x7F;
+
+        lnMsg& msg = (i % 8 == 7) ? delay : sw_req;
+
+        if(!buffer.queue_loconet_msg(msg)) {
+            break;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+
+template <class Buffer>
+void BM_drain(benchmark::State& state)
+{
+    Buffer buffer;
+    lnMsg msg;
+    std::size_t drained = 0;
+
+    for(auto _ : state) {
+        state.PauseTiming();
+        std::size_t count = fill(buffer);
+        state.ResumeTiming();
+
+        for(std::size_t i = 0; i < count; i++) {
+            buffer.dequeue_loconet_msg(msg);
+        }
+        benchmark::DoNotOptimize(msg);
+
+        drained += count;
+    }
+
+    state.SetItemsProcessed(drained);
+}
+BENCHMARK_TEMPLATE(BM_drain, Byte_stream_tx_buffer);
+BENCHMARK_TEMPLATE(BM_drain, Mrrwa_loconet_tx_buffer<MRRWA_LN_TX_BUFFER_CAPACITY>);
+
+}   // namespace
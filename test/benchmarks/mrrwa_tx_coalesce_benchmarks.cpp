@@ -0,0 +1,155 @@
+/*
+ * mrrwa_tx_coalesce_benchmarks.cpp
+ *
+ * Bus traffic while heads flap during startup: 16 Double_switch_heads are
+ * set and then cycled red -> yellow -> green every 100ms for 2 seconds of
+ * simulated time, while the transmit queue drains at the default transmit
+ * manager rate.  Reported counters:
+ *
+ *  requests     - switch requests ('on' and 'off') made by the switches
+ *  transmitted  - messages sent on the bus
+ *  coalesced    - requests that replaced a superseded queued request
+ *  rejected     - requests not queued as the queue was full (retried by the
+ *                 heads on their next request)
+ *  drain_ms     - simulated time until the queue is empty
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+#include "mrrwa_loconet_adapter.h"
+#include "loconet_txmgr.h"
+#include "loconet_switch.h"
+#include "double_switch_head.h"
+
+#include "arduino_mock.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace mr_signals;
+
+using ::testing::A;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+
+namespace {
+
+/// Passes requests to the adapter, counting the switch requests
+class Counting_adapter : public Loconet_adapter_interface {
+public:
+    explicit Counting_adapter(Loconet_adapter_interface& adapter) : adapter_(adapter), requests_(0) {}
+
+    void attach_sensor(Loconet_sensor* sensor) override { adapter_.attach_sensor(sensor); }
+
+    bool send_opc_sw_req(Loconet_address address, bool thrown, bool on, Switch_priority priority) override {
+        requests_++;
+        return adapter_.send_opc_sw_req(address, thrown, on, priority);
+    }
+
+    bool send_opc_gp_on() override { return adapter_.send_opc_gp_on(); }
+    bool insert_ln_tx_delay(uint8_t delay) override { return adapter_.insert_ln_tx_delay(delay); }
+    Runtime_ms get_time_ms() const override { return adapter_.get_time_ms(); }
+    Timer_service* get_timer_service() override { return adapter_.get_timer_service(); }
+    Sensor_state_store* get_sensor_state_store() override { return adapter_.get_sensor_state_store(); }
+
+    std::size_t requests() const { return requests_; }
+
+private:
+    Loconet_adapter_interface& adapter_;
+    std::size_t requests_;
+};
+
+
+void BM_flapping_heads(benchmark::State& state)
+{
+    const int head_count = 16;
+    const Runtime_ms flap_period_ms = 100;
+    const Runtime_ms flap_duration_ms = 2000;
+
+    const Head_aspect cycle[] = { Head_aspect::red, Head_aspect::yellow, Head_aspect::green };
+
+    std::size_t requests = 0;
+    std::size_t transmitted = 0;
+    std::size_t coalesced = 0;
+    std::size_t rejected = 0;
+    Runtime_ms drain_ms = 0;
+
+    // The adapter traces each message to Serial (std::cout); discard it
+    std::cout.setstate(std::ios::badbit);
+
+    for(auto _ : state) {
+        init_millis();
+
+        NiceMock<LocoNetMock> loconet_mock;
+        Setup_collection setup_coll(1);
+        Loop_collection loop_coll(1);
+        Loconet_txmgr tx_mgr;
+
+        Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, loconet_mock, 2, 0,
+                                      MRRWA_LN_TX_BUFFER_CAPACITY, tx_mgr);
+
+        Counting_adapter counting_adapter(adapter);
+
+        std::vector<std::unique_ptr<Loconet_switch>> switches;
+        std::vector<std::unique_ptr<Double_switch_head>> heads;
+
+        for(int i = 0; i < head_count; i++) {
+            switches.emplace_back(new Loconet_switch(2 * i + 1, &counting_adapter));
+            switches.emplace_back(new Loconet_switch(2 * i + 2, &counting_adapter));
+            heads.emplace_back(new Double_switch_head("H", *switches[2 * i], *switches[2 * i + 1]));
+        }
+
+        std::size_t sent = 0;
+
+        ON_CALL(loconet_mock, reportPower(A<uint8_t>())).WillByDefault(Return(LN_DONE));
+        ON_CALL(loconet_mock, send(A<lnMsg*>())).WillByDefault(testing::Invoke([&sent](lnMsg*) {
+            sent++;
+            return LN_DONE;
+        }));
+
+        Runtime_ms time_ms = 0;
+        bool queue_empty = false;
+
+        while(!queue_empty && time_ms < 60000) {
+
+            if(time_ms <= flap_duration_ms && 0 == time_ms % flap_period_ms) {
+                for(auto& head : heads) {
+                    head->request_aspect(cycle[(time_ms / flap_period_ms) % 3]);
+                }
+            }
+
+            set_millis(++time_ms);
+
+            for(auto& sw : switches) {
+                sw->loop();
+            }
+            adapter.loop();
+
+            const Mrrwa_loconet_tx_telemetry& telemetry = adapter.get_tx_telemetry();
+            queue_empty = (time_ms > flap_duration_ms + 100) &&
+                          telemetry.transmitted_count() == telemetry.queued_count();
+        }
+
+        requests = counting_adapter.requests();
+        transmitted = sent;
+        coalesced = adapter.get_tx_telemetry().coalesced_count();
+        rejected = adapter.get_tx_telemetry().rejected_count();
+        drain_ms = time_ms;
+    }
+
+    std::cout.clear();
+
+    state.counters["requests"] = requests;
+    state.counters["transmitted"] = transmitted;
+    state.counters["coalesced"] = coalesced;
+    state.counters["rejected"] = rejected;
+    state.counters["drain_ms"] = drain_ms;
+}
+BENCHMARK(BM_flapping_heads)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+}   // namespace
@@ -0,0 +1,130 @@
+/*
+ * mrrwa_tx_priority_benchmarks.cpp
+ *
+ * Worst case latency of a head going to red while the transmit queue holds a
+ * full startup backlog: the Double_switch_head's two LocoNet switch requests
+ * are queued behind a full bulk lane, and the simulated time (millis()) until
+ * both have been transmitted is reported as red_latency_ms.  The transmit
+ * manager uses its default timing.
+ *
+ * Compared with the single FIFO behavior (every request queued in the bulk
+ * lane) by a switch that drops the priority it is given.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+
+#include "mrrwa_loconet_adapter.h"
+#include "loconet_txmgr.h"
+#include "loconet_switch.h"
+#include "double_switch_head.h"
+
+#include "arduino_mock.h"
+
+#include <iostream>
+
+using namespace mr_signals;
+
+using ::testing::A;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+
+namespace {
+
+/// Loconet_switch that queues every request with normal priority, as a single FIFO did
+class Fifo_loconet_switch : public Loconet_switch {
+public:
+    using Loconet_switch::Loconet_switch;
+
+    bool request_direction(const Switch_direction direction, const Switch_priority = Switch_priority::normal) override {
+        return Loconet_switch::request_direction(direction, Switch_priority::normal);
+    }
+};
+
+
+template <class Switch>
+void BM_red_latency_full_backlog(benchmark::State& state)
+{
+    const Loconet_address head_address_1 = 1001;
+    const Loconet_address head_address_2 = 1002;
+    const Runtime_ms timeout_ms = 60000;
+
+    Runtime_ms red_latency = 0;
+    std::size_t backlog = 0;
+
+    // The adapter traces each message to Serial (std::cout); discard it
+    std::cout.setstate(std::ios::badbit);
+
+    for(auto _ : state) {
+        init_millis();
+
+        NiceMock<LocoNetMock> loconet_mock;
+        Setup_collection setup_coll(1);
+        Loop_collection loop_coll(1);
+        Loconet_txmgr tx_mgr;
+
+        Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, loconet_mock, 2, 0,
+                                      MRRWA_LN_TX_BUFFER_CAPACITY, tx_mgr);
+
+        Switch switch_1(head_address_1, &adapter);
+        Switch switch_2(head_address_2, &adapter);
+        Double_switch_head head("H", switch_1, switch_2);
+
+        int red_sent = 0;
+
+        ON_CALL(loconet_mock, reportPower(A<uint8_t>())).WillByDefault(Return(LN_DONE));
+        ON_CALL(loconet_mock, send(A<lnMsg*>())).WillByDefault(testing::Invoke([&red_sent](lnMsg* msg) {
+            Loconet_address address = (msg->data[1] | ((msg->data[2] & 0x0F) << 7)) + 1;
+
+            if((address == head_address_1 || address == head_address_2) && (msg->data[2] & OPC_SW_REQ_OUT)) {
+                red_sent++;
+            }
+            return LN_DONE;
+        }));
+
+        // Head is green, and has been sent, before the backlog builds
+        head.request_aspect(Head_aspect::green);
+
+        Runtime_ms time_ms = 0;
+
+        while(!(adapter.get_tx_telemetry().transmitted_count() >= 2)) {
+            set_millis(++time_ms);
+            adapter.loop();
+        }
+
+        // Startup backlog fills the bulk lane
+        backlog = 0;
+        while(adapter.send_opc_sw_req(1 + backlog % 1000, true, true)) {
+            backlog++;
+        }
+
+        red_sent = 0;
+
+        Runtime_ms red_time_ms = time_ms;
+
+        // As in the logic loop, the aspect is requested again until the
+        // switch requests have been queued (a full FIFO rejects them)
+        while(red_sent < 2 && time_ms - red_time_ms < timeout_ms) {
+            head.request_aspect(Head_aspect::red);
+
+            set_millis(++time_ms);
+            switch_1.loop();
+            switch_2.loop();
+            adapter.loop();
+        }
+
+        red_latency = time_ms - red_time_ms;
+    }
+
+    std::cout.clear();
+
+    state.counters["red_latency_ms"] = red_latency;
+    state.counters["backlog_msgs"] = backlog;
+}
+BENCHMARK_TEMPLATE(BM_red_latency_full_backlog, Fifo_loconet_switch)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_red_latency_full_backlog, Loconet_switch)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+}   // namespace
@@ -0,0 +1,100 @@
+/*
+ * timer_service_benchmarks.cpp
+ *
+ * Per-loop cost of switch on->off follow-ups with N switches (the benchmark
+ * argument), each with an 'off' pending every 64th loop: each switch testing
+ * its own deadline (as Loconet_switch::loop() did) against the Timer_service.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+#include "timer_service.h"
+
+#include <vector>
+
+using namespace mr_signals;
+
+
+namespace {
+
+const Runtime_ms on_off_delay_ms = 60;
+const Runtime_ms request_period_ms = 64;
+
+
+/// Deadline polled in loop(), as Loconet_switch did
+class Polled_switch {
+public:
+    Polled_switch() : send_off_time_ms_(0), offs_(0) {}
+
+    void request(Runtime_ms time_ms) { send_off_time_ms_ = time_ms + on_off_delay_ms; }
+
+    void loop(Runtime_ms time_ms) {
+        if(send_off_time_ms_) {
+            if(time_ms >= send_off_time_ms_) {
+                offs_++;
+                send_off_time_ms_ = 0;
+            }
+        }
+    }
+
+    Runtime_ms send_off_time_ms_;
+    uint32_t offs_;
+};
+
+
+class Timed_switch : public Timer_interface {
+public:
+    Timed_switch() : offs_(0) {}
+
+    void on_timer(const Runtime_ms) override { offs_++; }
+
+    uint32_t offs_;
+};
+
+
+void BM_polled_follow_up(benchmark::State& state)
+{
+    std::vector<Polled_switch> switches(state.range(0));
+    Runtime_ms time_ms = 0;
+
+    for(auto _ : state) {
+        time_ms++;
+
+        Polled_switch& requested = switches[time_ms % switches.size()];
+        if(0 == time_ms % request_period_ms) {
+            requested.request(time_ms);
+        }
+
+        for(Polled_switch& sw : switches) {
+            sw.loop(time_ms);
+        }
+    }
+
+    benchmark::DoNotOptimize(switches.data());
+}
+BENCHMARK(BM_polled_follow_up)->Arg(16)->Arg(256);
+
+
+void BM_timer_service_follow_up(benchmark::State& state)
+{
+    Timer_service service;
+    std::vector<Timed_switch> switches(state.range(0));
+    Runtime_ms time_ms = 0;
+
+    for(auto _ : state) {
+        time_ms++;
+
+        Timed_switch& requested = switches[time_ms % switches.size()];
+        if(0 == time_ms % request_period_ms) {
+            service.schedule(requested, time_ms + on_off_delay_ms);
+        }
+
+        service.service(time_ms);
+    }
+
+    benchmark::DoNotOptimize(switches.data());
+}
+BENCHMARK(BM_timer_service_follow_up)->Arg(16)->Arg(256);
+
+}   // namespace
@@ -0,0 +1,67 @@
+/*
+ * trace_benchmarks.cpp
+ *
+ * Hot path cost of tracing a received 4 byte LocoNet message and the sensor
+ * report it carries: formatting the text as it is traced (as print_lnMsg()
+ * and notifySensor() did) against writing records to a Trace_ring, with the
+ * ring drained outside of the timed region.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "benchmark/benchmark.h"
+#include "trace.h"
+
+#include <sstream>
+
+using namespace mr_signals;
+
+
+namespace {
+
+const uint8_t msg[4] = { 0xB2, 0x13, 0x50, 0x0E };
+const uint8_t report[3] = { 39, 0, 1 };
+
+
+void BM_trace_formatted(benchmark::State& state)
+{
+    std::ostringstream out;
+
+    for(auto _ : state) {
+        Trace_decoder::format(out, 1234, Trace_event::ln_rx, msg, sizeof(msg));
+        Trace_decoder::format(out, 1234, Trace_event::sensor_report, report, sizeof(report));
+        Trace_decoder::format(out, 1234, Trace_event::line_end, nullptr, 0);
+
+        if(out.tellp() > 4096) {
+            out.str("");
+        }
+    }
+}
+BENCHMARK(BM_trace_formatted);
+
+
+void BM_trace_ring(benchmark::State& state)
+{
+    Trace_ring ring;
+    std::ostringstream out;
+
+    Trace_ring::set_active(&ring);
+
+    for(auto _ : state) {
+        trace(Trace_event::ln_rx, msg, sizeof(msg));
+        trace(Trace_event::sensor_report, report, sizeof(report));
+        trace(Trace_event::line_end);
+
+        if(ring.size() + 3 > Trace_ring::capacity) {
+            state.PauseTiming();
+            ring.drain(out);
+            out.str("");
+            state.ResumeTiming();
+        }
+    }
+
+    Trace_ring::set_active(nullptr);
+}
+BENCHMARK(BM_trace_ring);
+
+}   // namespace
@@ -10,66 +10,35 @@
 #include "circular_buffer.h"
 #include <cstddef>
 #include <iostream>
+#include <cstring>
 
 
 /*
- * Test all expecte behaviour for an instantiated but non-initialized Circular_buffer object
+ * Test all expected behaviour for a newly constructed Circular_buffer object
  */
 TEST(CircularBuffer,Setup)
 {
-    Circular_buffer circular_buffer;
+    Circular_buffer<uint8_t, 2> circular_buffer;
 
-    uint8_t test_byte;
+    uint8_t test_byte = 0;
 
-    // Should not be able to enqueue or deqeue as not initialized
-    EXPECT_FALSE(circular_buffer.enqueue(test_byte));
+    // Nothing to dequeue from an empty buffer
     EXPECT_FALSE(circular_buffer.dequeue(test_byte));
 
     // Confirm buffer characteristics
-    EXPECT_EQ(circular_buffer.max_size(),0U);
-    EXPECT_EQ(circular_buffer.get_free(),0U);
-    EXPECT_EQ(circular_buffer.high_watermark(),0U);
-
-
-    // Attempt to create an invalid size
-    EXPECT_FALSE(circular_buffer.initialize(1));
-
-
-    // Check everything is still as expected
-    EXPECT_EQ(circular_buffer.max_size(),0U);
-    EXPECT_EQ(circular_buffer.get_free(),0U);
-    EXPECT_EQ(circular_buffer.high_watermark(),0U);
-
-
-
-
-    // Now set a valid size
-    EXPECT_TRUE(circular_buffer.initialize(2));
-
-    // Check everything is as expected
     EXPECT_EQ(circular_buffer.max_size(),2U);
     EXPECT_EQ(circular_buffer.get_free(),2U);
+    EXPECT_EQ(circular_buffer.size(),0U);
     EXPECT_EQ(circular_buffer.high_watermark(),0U);
 
-
-
-
-    // Try Setting again with larger buffer; should fail and buffer should remain same size
-    EXPECT_FALSE(circular_buffer.initialize(3));
-
-    EXPECT_EQ(circular_buffer.max_size(),2U);
-    EXPECT_EQ(circular_buffer.get_free(),2U);
-    EXPECT_EQ(circular_buffer.high_watermark(),0U);
+    // Capacity is a compile time constant
+    static_assert(Circular_buffer<uint8_t, 256>::max_size() == 256, "max_size() should match N");
 }
 
 TEST(CircularBuffer,Filling)
 {
-    Circular_buffer circular_buffer;
     const std::size_t buffer_size = 4;
-
-
-
-    EXPECT_TRUE(circular_buffer.initialize(buffer_size ));
+    Circular_buffer<uint8_t, buffer_size> circular_buffer;
 
     uint8_t byte_in=1, byte_out=2;
 
@@ -128,3 +97,181 @@ TEST(CircularBuffer,Filling)
     }
 
 }
+
+
+/*
+ * Run the read and write indexes around the end of the storage several times,
+ * interleaving enqueues and dequeues, to confirm FIFO order is kept across
+ * the wrap
+ */
+TEST(CircularBuffer,Wrapping)
+{
+    const std::size_t buffer_size = 8;
+    Circular_buffer<uint8_t, buffer_size> circular_buffer;
+
+    uint8_t next_in = 0, next_out = 0;
+
+    for(int cycle = 0; cycle < 20; cycle++) {
+
+        // Add 3, remove 2 so that the occupancy creeps up and the indexes wrap
+        for(int i = 0; i < 3; i++) {
+            if(circular_buffer.get_free()) {
+                EXPECT_TRUE(circular_buffer.enqueue(next_in++));
+            }
+        }
+
+        for(int i = 0; i < 2; i++) {
+            uint8_t byte = 0xFF;
+            EXPECT_TRUE(circular_buffer.dequeue(byte));
+            EXPECT_EQ(next_out++,byte);
+        }
+    }
+
+    EXPECT_EQ(circular_buffer.high_watermark(),buffer_size);
+
+    // Drain what remains, still in order
+    uint8_t byte;
+    while(circular_buffer.dequeue(byte)) {
+        EXPECT_EQ(next_out++,byte);
+    }
+
+    EXPECT_EQ(next_in,next_out);
+    EXPECT_EQ(circular_buffer.get_free(),buffer_size);
+}
+
+
+/*
+ * The buffer is not limited to bytes; check a wider element type
+ */
+TEST(CircularBuffer,ElementType)
+{
+    struct Element {
+        uint16_t address;
+        bool state;
+    };
+
+    Circular_buffer<Element, 4> circular_buffer;
+
+    EXPECT_TRUE(circular_buffer.enqueue({1000, true}));
+    EXPECT_TRUE(circular_buffer.enqueue({2000, false}));
+
+    Element element = {0, false};
+
+    EXPECT_TRUE(circular_buffer.dequeue(element));
+    EXPECT_EQ(1000,element.address);
+    EXPECT_TRUE(element.state);
+
+    EXPECT_TRUE(circular_buffer.dequeue(element));
+    EXPECT_EQ(2000,element.address);
+    EXPECT_FALSE(element.state);
+
+    EXPECT_FALSE(circular_buffer.dequeue(element));
+}
+
+
+/*
+ * Move blocks of bytes in and out, positioning the indexes so that blocks
+ * straddle the end of the storage and are split in two
+ */
+TEST(CircularBuffer,BulkWrapping)
+{
+    const std::size_t buffer_size = 8;
+    Circular_buffer<uint8_t, buffer_size> circular_buffer;
+
+    const uint8_t block_in[5] = {1,2,3,4,5};
+    uint8_t block_out[5] = {0,0,0,0,0};
+
+    // Move the indexes to 6 so the next 5 byte block is split 2 + 3
+    EXPECT_TRUE(circular_buffer.enqueue(block_in,5));
+    EXPECT_TRUE(circular_buffer.dequeue(block_out,5));
+    EXPECT_TRUE(circular_buffer.enqueue(block_in,1));
+    EXPECT_TRUE(circular_buffer.dequeue(block_out,1));
+
+    EXPECT_TRUE(circular_buffer.enqueue(block_in,5));
+    EXPECT_EQ(circular_buffer.get_free(),3U);
+
+    // All or nothing; a block larger than the free space is rejected
+    EXPECT_FALSE(circular_buffer.enqueue(block_in,4));
+    EXPECT_EQ(circular_buffer.get_free(),3U);
+
+    // Peek across the split without consuming, including from an offset
+    std::memset(block_out,0,sizeof(block_out));
+    EXPECT_TRUE(circular_buffer.peek(block_out,5));
+    EXPECT_EQ(0,std::memcmp(block_in,block_out,5));
+    EXPECT_EQ(circular_buffer.size(),5U);
+
+    uint8_t byte = 0;
+    EXPECT_TRUE(circular_buffer.peek(&byte,1,3));
+    EXPECT_EQ(4,byte);
+    EXPECT_FALSE(circular_buffer.peek(block_out,2,4));   // Beyond what is held
+
+    // Cannot dequeue more than is held
+    EXPECT_FALSE(circular_buffer.dequeue(block_out,6));
+
+    std::memset(block_out,0,sizeof(block_out));
+    EXPECT_TRUE(circular_buffer.dequeue(block_out,5));
+    EXPECT_EQ(0,std::memcmp(block_in,block_out,5));
+    EXPECT_EQ(circular_buffer.get_free(),buffer_size);
+    EXPECT_EQ(circular_buffer.high_watermark(),5U);
+}
+
+
+/*
+ * Write and read in place through reserve()/commit() and peek()/consume(),
+ * confirming the regions stop at the end of the storage
+ */
+TEST(CircularBuffer,InPlaceRegions)
+{
+    const std::size_t buffer_size = 8;
+    Circular_buffer<uint8_t, buffer_size> circular_buffer;
+
+    std::size_t length = 0;
+
+    // Empty buffer; whole storage is writable, nothing readable
+    uint8_t* write = circular_buffer.reserve(length);
+    EXPECT_EQ(length,buffer_size);
+
+    (void) circular_buffer.peek(length);
+    EXPECT_EQ(length,0U);
+
+    // Write 6 in place
+    for(uint8_t i = 0; i < 6; i++) {
+        write[i] = i;
+    }
+    circular_buffer.commit(6);
+    EXPECT_EQ(circular_buffer.size(),6U);
+    EXPECT_EQ(circular_buffer.high_watermark(),6U);
+
+    // Read 4 in place
+    const uint8_t* read = circular_buffer.peek(length);
+    EXPECT_EQ(length,6U);
+    EXPECT_EQ(0,read[0]);
+    EXPECT_EQ(3,read[3]);
+    circular_buffer.consume(4);
+
+    // Writable region runs to the end of the storage (2), then from the start (4)
+    write = circular_buffer.reserve(length);
+    EXPECT_EQ(length,2U);
+    write[0] = 6;
+    write[1] = 7;
+    circular_buffer.commit(2);
+
+    write = circular_buffer.reserve(length);
+    EXPECT_EQ(length,4U);
+    write[0] = 8;
+    circular_buffer.commit(1);
+
+    // Readable region stops at the end of the storage
+    read = circular_buffer.peek(length);
+    EXPECT_EQ(length,4U);
+    EXPECT_EQ(4,read[0]);
+    EXPECT_EQ(7,read[3]);
+    circular_buffer.consume(4);
+
+    read = circular_buffer.peek(length);
+    EXPECT_EQ(length,1U);
+    EXPECT_EQ(8,read[0]);
+    circular_buffer.consume(1);
+
+    EXPECT_EQ(circular_buffer.size(),0U);
+}
@@ -0,0 +1,259 @@
+/*
+ * layout_sim.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "layout_sim.h"
+#include "arduino_mock.h"
+
+namespace mr_signals
+{
+
+
+Layout_sim::Layout_sim(Logic_collection& logic, Loop_collection* loops, Runtime_ms pass_ms) :
+        logic_(logic), loops_(loops), pass_ms_(pass_ms ? pass_ms : 1),
+        now_ms_(millis()), passes_(0), block_changes_(0), aspect_changes_(0), last_activity_ms_(now_ms_),
+        episode_open_(false), episode_pass_(0), episode_ms_(0), episode_changed_(false),
+        last_change_pass_(0), last_change_ms_(0), superseded_(0), unmet_(0)
+{
+}
+
+Layout_sim::Block Layout_sim::add_block(Sensor_base& sensor, uint32_t length_mm)
+{
+    return add_block([&sensor](bool occupied) { sensor.set_state(occupied); }, length_mm);
+}
+
+Layout_sim::Block Layout_sim::add_block(Block_driver driver, uint32_t length_mm)
+{
+    driver(false);
+    blocks_.push_back({driver, length_mm, false});
+
+    return blocks_.size() - 1;
+}
+
+void Layout_sim::watch(Head_interface& head)
+{
+    heads_.push_back({&head, head.get_aspect()});
+}
+
+void Layout_sim::watch(Sim_switch& sw)
+{
+    switches_.push_back(&sw);
+}
+
+void Layout_sim::add_train(std::initializer_list<Block> route, uint32_t speed_mm_s, uint32_t length_mm,
+                           Runtime_ms start_ms)
+{
+    Train train = {route, speed_mm_s, length_mm, start_ms, 0};
+
+    for(Block block : train.route) {
+        if(block < blocks_.size()) {
+            train.route_mm += blocks_[block].length_mm;
+        }
+    }
+
+    trains_.push_back(train);
+}
+
+void Layout_sim::run_until(Runtime_ms end_ms)
+{
+    while((int32_t)(end_ms - now_ms_) > 0) {
+        pass();
+    }
+
+    end_episode();
+}
+
+bool Layout_sim::run_until_idle(Runtime_ms max_ms, Runtime_ms settle_ms)
+{
+    const Runtime_ms end_ms = now_ms_ + max_ms;
+    bool idle = false;
+
+    while(!idle && (int32_t)(end_ms - now_ms_) > 0) {
+        pass();
+
+        // As of the pass just run
+        idle = trains_done(now_ms_ - pass_ms_) && (now_ms_ - last_activity_ms_) >= settle_ms;
+    }
+
+    end_episode();
+
+    return idle;
+}
+
+void Layout_sim::pass()
+{
+    set_millis(now_ms_);
+
+    move_trains();
+
+    if(loops_) {
+        loops_->execute();
+    }
+
+    logic_.loop();
+
+    for(Watched_head& watched : heads_) {
+        Head_aspect aspect = watched.head->get_aspect();
+
+        if(aspect != watched.aspect) {
+            watched.aspect = aspect;
+            aspect_changes_++;
+            last_activity_ms_ = now_ms_;
+
+            if(episode_open_) {
+                episode_changed_ = true;
+                last_change_pass_ = passes_;
+                last_change_ms_ = now_ms_;
+            }
+        }
+    }
+
+    if(oracle_) {
+        check_expected();
+    }
+
+    passes_++;
+    now_ms_ += pass_ms_;
+}
+
+uint32_t Layout_sim::get_switch_requests() const
+{
+    uint32_t requests = 0;
+
+    for(const Sim_switch* sw : switches_) {
+        requests += sw->get_requests();
+    }
+
+    return requests;
+}
+
+void Layout_sim::move_trains()
+{
+    std::vector<bool> occupied(blocks_.size(), false);
+
+    for(const Train& train : trains_) {
+        if((int32_t)(now_ms_ - train.start_ms) < 0) {
+            continue;
+        }
+
+        // Positions along the route
+        int64_t front = (int64_t)train.speed_mm_s * (now_ms_ - train.start_ms) / 1000;
+        int64_t rear = front - train.length_mm;
+        int64_t offset = 0;
+
+        for(Block block : train.route) {
+            if(block >= blocks_.size()) {
+                continue;
+            }
+
+            int64_t end = offset + blocks_[block].length_mm;
+
+            if(front > offset && rear < end) {
+                occupied[block] = true;
+            }
+
+            offset = end;
+        }
+    }
+
+    bool changed = false;
+
+    for(Block block = 0; block < blocks_.size(); block++) {
+        if(occupied[block] != blocks_[block].occupied) {
+            blocks_[block].occupied = occupied[block];
+            blocks_[block].driver(occupied[block]);
+
+            block_changes_++;
+            last_activity_ms_ = now_ms_;
+            changed = true;
+
+            if(!oracle_) {
+                end_episode();
+
+                episode_open_ = true;
+                episode_pass_ = passes_;
+                episode_ms_ = now_ms_;
+            }
+        }
+    }
+
+    if(changed && oracle_) {
+        expect_aspects();
+    }
+}
+
+void Layout_sim::end_episode()
+{
+    if(episode_open_ && episode_changed_) {
+        latency_passes_.add(last_change_pass_ - episode_pass_ + 1);
+        latency_ms_.add(last_change_ms_ - episode_ms_);
+    }
+
+    episode_open_ = false;
+    episode_changed_ = false;
+
+    unmet_ += expected_.size();
+    expected_.clear();
+}
+
+void Layout_sim::expect_aspects()
+{
+    Expected_episode episode = { passes_, now_ms_, oracle_(*this) };
+
+    if(!shows(episode.aspects)) {
+        expected_.push_back(episode);
+    }
+}
+
+void Layout_sim::check_expected()
+{
+    // Episodes before the last complete one are superseded
+    std::size_t done = 0;
+
+    for(std::size_t i = 0; i < expected_.size(); i++) {
+        const Expected_episode& episode = expected_[i];
+
+        if(shows(episode.aspects)) {
+            latency_passes_.add(passes_ - episode.pass + 1);
+            latency_ms_.add(now_ms_ - episode.ms);
+
+            superseded_ += i - done;
+            done = i + 1;
+        }
+    }
+
+    expected_.erase(expected_.begin(), expected_.begin() + done);
+}
+
+bool Layout_sim::shows(const std::vector<Head_aspect>& aspects) const
+{
+    for(std::size_t i = 0; i < aspects.size() && i < heads_.size(); i++) {
+        if(aspects[i] != heads_[i].aspect) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Layout_sim::trains_done(Runtime_ms time_ms) const
+{
+    for(const Train& train : trains_) {
+        if((int32_t)(time_ms - train.start_ms) < 0) {
+            return false;
+        }
+
+        int64_t front = (int64_t)train.speed_mm_s * (time_ms - train.start_ms) / 1000;
+
+        if(front - train.length_mm < (int64_t)train.route_mm) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+} // namespace mr_signals
@@ -0,0 +1,253 @@
+/*
+ * layout_sim.h
+ *
+ * Deterministic host simulator of trains moving through a layout's blocks,
+ * for measuring how long the logic takes to show the right aspects
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef TEST_LAYOUT_SIM_H_
+#define TEST_LAYOUT_SIM_H_
+
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+#include "sensor_interface.h"
+#include "base/head_interface.h"
+#include "base/switch_interface.h"
+#include "base/loop_timing.h"       // Timing_stats
+#include "base/timer_service.h"     // Runtime_ms
+#include "logic_collection.h"
+#include "loop_funcs.h"
+
+namespace mr_signals
+{
+
+
+/**
+ * Switch that counts the requests that change its direction, each of which
+ * would be a message on a real bus
+ */
+class Sim_switch : public Test_switch {
+public:
+    Sim_switch(int num = -1) : Test_switch(num), requests_(0) {}
+
+    bool request_direction(const Switch_direction direction, const Switch_priority priority = Switch_priority::normal) override
+    {
+        Switch_direction previous = direction_;
+
+        bool accepted = Test_switch::request_direction(direction, priority);
+
+        if(accepted && direction != previous) {
+            requests_++;
+        }
+
+        return accepted;
+    }
+
+    uint32_t get_requests() const { return requests_; }
+
+private:
+    uint32_t requests_;
+};
+
+
+/**
+ * Moves trains along routes of blocks and runs the layout's loop as the
+ * sketch would, on the set_millis() clock, one pass every pass_ms
+ *
+ * Each block has a length and a way to set its occupancy (normally a
+ * Sensor_base).  A block is occupied while any part of a train is in it.
+ * Every block starts unoccupied.
+ *
+ * Each change of block occupancy starts an episode that lasts until the
+ * next change.  Its latency is the time from the change to the last change of
+ * the aspect of any watched head during the episode, in passes (the pass that
+ * first sees the change counts as 1) and in ms.  An episode with no aspect
+ * change has no latency.  Switch requests made by the watched switches are
+ * counted as bus traffic.  An episode's latency is recorded when it ends, at
+ * the next change of occupancy or at the end of a run.
+ *
+ * As an episode cut short by the next change of occupancy measures only the
+ * aspect changes seen so far, the expected aspects can be given by an oracle
+ * (set_oracle()).  Each pass that changes the occupancy then starts an
+ * episode that lasts until the watched heads show the aspects the oracle gave
+ * for that occupancy, however many later changes there are.  An episode whose
+ * aspects are already shown has no latency.  An episode still waiting when a
+ * later one is complete is counted as superseded, and one still waiting at
+ * the end of a run as unmet.
+ *
+ * Example
+ *
+ * Layout_sim sim(logic);
+ * Layout_sim::Block b1 = sim.add_block(sensor_1, 2000);
+ * Layout_sim::Block b2 = sim.add_block(sensor_2, 3000);
+ * sim.watch(head_1);
+ * sim.add_train({b1, b2}, 500, 600);      // 500mm/s, 600mm long
+ * sim.run_until_idle(60000);
+ * sim.get_latency_passes().max();
+ */
+class Layout_sim {
+public:
+
+    typedef uint16_t Block;
+
+    /// Sets the occupancy of a block (true = occupied)
+    typedef std::function<void(bool)> Block_driver;
+
+    /// Aspects the watched heads should show (in watch order) for the current occupancy
+    typedef std::function<std::vector<Head_aspect>(const Layout_sim&)> Aspect_oracle;
+
+    /**
+     * @param logic     - Logic run each pass
+     * @param loops     - Loop_collection executed each pass before the logic, if any
+     * @param pass_ms   - Time between passes
+     */
+    Layout_sim(Logic_collection& logic, Loop_collection* loops = nullptr, Runtime_ms pass_ms = 1);
+
+    /// Add a block whose occupancy is shown by a sensor
+    Block add_block(Sensor_base& sensor, uint32_t length_mm);
+
+    /// Add a block whose occupancy is set through a driver
+    Block add_block(Block_driver driver, uint32_t length_mm);
+
+    /// Watch a head for aspect changes
+    void watch(Head_interface& head);
+
+    /// Count the requests of a switch as bus traffic
+    void watch(Sim_switch& sw);
+
+    /// Measure each episode until the aspects given by the oracle are shown
+    void set_oracle(Aspect_oracle oracle) { oracle_ = oracle; }
+
+    /**
+     * Add a train that enters the first block of its route at start_ms and
+     * runs through the route at a constant speed until it has left the last
+     * block
+     */
+    void add_train(std::initializer_list<Block> route, uint32_t speed_mm_s, uint32_t length_mm,
+                   Runtime_ms start_ms = 0);
+
+    /// Run passes until the time reaches end_ms
+    void run_until(Runtime_ms end_ms);
+
+    /**
+     * Run passes until every train has left its route and the aspects have
+     * not changed for settle_ms, or max_ms has passed
+     * @return true if idle was reached
+     */
+    bool run_until_idle(Runtime_ms max_ms, Runtime_ms settle_ms = 100);
+
+    /// Run a single pass at the current time, then advance the time
+    void pass();
+
+    Runtime_ms get_time() const { return now_ms_; }
+    uint32_t get_passes() const { return passes_; }
+
+    /// Changes of block occupancy
+    uint32_t get_block_changes() const { return block_changes_; }
+
+    /// Changes of the aspect of the watched heads
+    uint32_t get_aspect_changes() const { return aspect_changes_; }
+
+    /// Direction changing requests made by the watched switches
+    uint32_t get_switch_requests() const;
+
+    /// Latency of the episodes with an aspect change, in passes
+    const Timing_stats& get_latency_passes() const { return latency_passes_; }
+
+    /// Latency of the episodes with an aspect change, in ms
+    const Timing_stats& get_latency_ms() const { return latency_ms_; }
+
+    /// With an oracle, episodes overtaken by a later episode before their aspects were shown
+    uint32_t get_superseded_episodes() const { return superseded_; }
+
+    /// With an oracle, episodes whose aspects were not shown by the end of a run
+    uint32_t get_unmet_episodes() const { return unmet_; }
+
+    bool is_occupied(Block block) const { return block < blocks_.size() && blocks_[block].occupied; }
+
+private:
+
+    struct Block_state {
+        Block_driver driver;
+        uint32_t length_mm;
+        bool occupied;
+    };
+
+    struct Train {
+        std::vector<Block> route;
+        uint32_t speed_mm_s;
+        uint32_t length_mm;
+        Runtime_ms start_ms;
+        uint32_t route_mm;          // Length of the route
+    };
+
+    struct Watched_head {
+        Head_interface* head;
+        Head_aspect aspect;
+    };
+
+    /// Episode waiting for the aspects expected by the oracle
+    struct Expected_episode {
+        uint32_t pass;              // Pass that first saw the change
+        Runtime_ms ms;
+        std::vector<Head_aspect> aspects;
+    };
+
+    /// Set the occupancy of the blocks from the train positions
+    void move_trains();
+
+    /// Close the open episode, recording its latency
+    void end_episode();
+
+    /// Start an episode waiting for the oracle's aspects for the current occupancy
+    void expect_aspects();
+
+    /// Record the waiting episodes whose aspects are shown
+    void check_expected();
+
+    /// true if the watched heads show the aspects
+    bool shows(const std::vector<Head_aspect>& aspects) const;
+
+    /// true if every train has left its route at the time
+    bool trains_done(Runtime_ms time_ms) const;
+
+    Logic_collection& logic_;
+    Loop_collection* loops_;
+    Runtime_ms pass_ms_;
+
+    std::vector<Block_state> blocks_;
+    std::vector<Train> trains_;
+    std::vector<Watched_head> heads_;
+    std::vector<Sim_switch*> switches_;
+
+    Runtime_ms now_ms_;
+    uint32_t passes_;
+    uint32_t block_changes_;
+    uint32_t aspect_changes_;
+
+    Runtime_ms last_activity_ms_;   // Time of the last block or aspect change
+
+    bool episode_open_;
+    uint32_t episode_pass_;         // Pass that first saw the change
+    Runtime_ms episode_ms_;
+    bool episode_changed_;          // An aspect changed during the episode
+    uint32_t last_change_pass_;
+    Runtime_ms last_change_ms_;
+
+    Aspect_oracle oracle_;
+    std::vector<Expected_episode> expected_;
+    uint32_t superseded_;
+    uint32_t unmet_;
+
+    Timing_stats latency_passes_;
+    Timing_stats latency_ms_;
+};
+
+
+} // namespace mr_signals
+
+#endif /* TEST_LAYOUT_SIM_H_ */
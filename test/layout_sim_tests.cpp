@@ -0,0 +1,399 @@
+/*
+ * layout_sim_tests.cpp
+ *
+ * Aspect propagation latency measured with Layout_sim, on a simple line and
+ * on a copy of the Yelta - Marino - Pt Adelaide section of the Blackwood South
+ * layout
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "layout_sim.h"
+#include "arduino_mock.h"
+
+#include "ryg_logic.h"
+#include "apb_logic.h"
+#include "double_switch_head.h"
+#include "quadln_s_head.h"
+
+#include "loconet_bus_sim.h"
+#include "mrrwa_loconet_adapter.h"
+#include "loconet_sensor.h"
+#include "loconet_txmgr.h"
+
+
+using namespace mr_signals;
+
+
+namespace {
+
+/// Three blocks, each protected by a signal that also shows the next signal
+struct Three_block_line {
+    Three_block_line(Sensor_base& b_1, Sensor_base& b_2, Sensor_base& b_3) :
+        block_1(b_1), block_2(b_2), block_3(b_3), logic(3),
+        l_1(logic, head_1, head_2, {&block_1}),
+        l_2(logic, head_2, head_3, {&block_2}),
+        l_3(logic, head_3, {&block_3})
+    {}
+
+    Sensor_base& block_1;
+    Sensor_base& block_2;
+    Sensor_base& block_3;
+    Test_head head_1, head_2, head_3;
+    Logic_collection logic;
+    Simple_ryg_logic l_1, l_2, l_3;
+};
+
+
+/// Copy of the Yelta - Marino - Pt Adelaide section of Blackwood South (the
+/// "Yelta" logics of src/configs/blackwood_south.cc, which only builds for
+/// Arduino), with its Loconet sensors and switches replaced by simulated ones.
+/// Changes to that section of the config are not picked up; update this copy.
+struct Yelta_section {
+    Yelta_section() : logic(12),
+        head_1213a("1213a", sw[0], sw[1]),
+        head_1214a("1214a", sw[2], sw[3]),
+        head_1342a("1342a", sw[4], sw[5]),
+        head_1343a("1343a", sw[6], sw[7]),
+        head_1381a("1381a", sw[8], sw[9]),
+        head_1382a("1382a", sw[10], sw[11]),
+        head_2412a("2412a", sw[12], sw[13]),
+        head_2413a("2413a", sw[14], sw[15]),
+        head_2430a("2430a", sw[16], sw[17]),
+        head_2431a("2431a", sw[18], sw[19]),
+        head_2612a("2612a", sw[20], sw[21]),
+
+        bkwd_yelta_apb(logic, {&t_20, &t_1214, &t_1342}),
+
+        l_1213(logic, head_1213a, head_1343a, {&t_1342}),
+        l_1214a(logic, head_1214a, head_red, {&t_1214, &bkwd_yelta_apb.up_tumbledown()}),
+        l_1342(logic, head_1342a, head_1214a, {&t_1342, &bkwd_yelta_apb.up_tumbledown()}),
+        l_1343(logic, head_1343a, head_1381a, {&t_31, &t_33, &sw_yelta}),
+        l_1381(logic, head_1381a, head_2413a, {&t_34, &t_35}),
+        l_1382(logic, head_1382a, head_1342a, {&t_31, &t_33, &sw_yelta}),
+        l_2412(logic, head_2412a, head_1382a, {&t_34, &t_33}),
+        l_2413(logic, head_2413a, head_2431a, {&t_35, &t_36, &t_37, &sw_marino}),
+        l_2430(logic, head_2430a, head_2412a, {&t_35, &t_36, &t_37, &sw_marino}),
+        l_2431(logic, head_2431a, {&t_ptAdel}),
+        l_2612(logic, head_2612a, {&t_ptAdel, &t_37})
+    {
+        sw_yelta.set_state(false);
+        sw_marino.set_state(false);
+    }
+
+    Sensor_base t_20, t_1214, t_1342, t_31, t_33, t_34, t_35, t_36, t_37, t_ptAdel;
+    Sensor_base sw_yelta, sw_marino;
+
+    Sim_switch sw[22];
+
+    Logic_collection logic;
+
+    Fixed_red_head head_red;
+    Double_switch_head head_1213a, head_1214a;
+    Quadln_s_head head_1342a, head_1343a, head_1381a, head_1382a;
+    Quadln_s_head head_2412a, head_2413a, head_2430a, head_2431a;
+    Double_switch_head head_2612a;
+
+    Simple_apb bkwd_yelta_apb;
+
+    Simple_ryg_logic l_1213, l_1214a, l_1342, l_1343, l_1381, l_1382;
+    Simple_ryg_logic l_2412, l_2413, l_2430, l_2431, l_2612;
+};
+
+
+/// Shows red on a head once its block has been occupied for a number of passes
+class Delayed_red_logic : public Logic_interface {
+public:
+    Delayed_red_logic(Logic_collection& collection, Sensor_interface& block, Test_head& head, uint8_t delay) :
+        Logic_interface(collection), block_(block), head_(head), delay_(delay), passes_(0)
+    {
+        head_.request_aspect(Head_aspect::green);
+    }
+
+    void loop() override
+    {
+        if(!block_.is_active()) {
+            passes_ = 0;
+        }
+        else if(passes_ < delay_) {
+            passes_++;
+        }
+
+        head_.request_aspect(passes_ >= delay_ ? Head_aspect::red : Head_aspect::green);
+    }
+
+private:
+    Sensor_interface& block_;
+    Test_head& head_;
+    uint8_t delay_;
+    uint8_t passes_;
+};
+
+
+/// Latency and traffic of one simulated run
+struct Sim_result {
+    bool idle;
+    uint32_t max_latency_passes;
+    uint32_t max_latency_ms;
+    uint32_t aspect_changes;
+    uint32_t switch_requests;
+    uint32_t missed_episodes;       // Superseded or unmet, with an oracle
+};
+
+/// Expected aspect of a signal protecting a block, given the signal ahead
+Head_aspect ryg_aspect(bool occupied, Head_aspect ahead)
+{
+    if(occupied) {
+        return Head_aspect::red;
+    }
+
+    return (Head_aspect::red == ahead) ? Head_aspect::yellow : Head_aspect::green;
+}
+
+
+Sim_result run_three_block_line(bool propagate, Sensor_base& b_1, Sensor_base& b_2, Sensor_base& b_3,
+                                bool oracle = true, uint32_t speed_mm_s = 1000)
+{
+    init_millis();
+
+    Three_block_line line(b_1, b_2, b_3);
+
+    if(propagate) {
+        line.logic.enable_change_propagation();
+    }
+
+    Layout_sim sim(line.logic);
+
+    Layout_sim::Block b1 = sim.add_block(line.block_1, 2000);
+    Layout_sim::Block b2 = sim.add_block(line.block_2, 2000);
+    Layout_sim::Block b3 = sim.add_block(line.block_3, 2000);
+
+    sim.watch(line.head_1);
+    sim.watch(line.head_2);
+    sim.watch(line.head_3);
+
+    // Measure each change until the whole line shows it
+    if(oracle) {
+        sim.set_oracle([b1, b2, b3](const Layout_sim& layout) {
+            Head_aspect head_3 = ryg_aspect(layout.is_occupied(b3), Head_aspect::green);
+            Head_aspect head_2 = ryg_aspect(layout.is_occupied(b2), head_3);
+            Head_aspect head_1 = ryg_aspect(layout.is_occupied(b1), head_2);
+
+            return std::vector<Head_aspect>{ head_1, head_2, head_3 };
+        });
+    }
+
+    sim.add_train({b1, b2, b3}, speed_mm_s, 500, 100);     // 0.5m long
+
+    bool idle = sim.run_until_idle(20000);
+
+    // The line is clear again once the train has left
+    EXPECT_EQ(Head_aspect::green,line.head_1.get_aspect());
+    EXPECT_EQ(Head_aspect::green,line.head_2.get_aspect());
+    EXPECT_EQ(Head_aspect::green,line.head_3.get_aspect());
+
+    // Each block is entered and left once
+    EXPECT_EQ(6u,sim.get_block_changes());
+
+    return { idle, sim.get_latency_passes().max(), sim.get_latency_ms().max(),
+             sim.get_aspect_changes(), sim.get_switch_requests(),
+             sim.get_superseded_episodes() + sim.get_unmet_episodes() };
+}
+
+
+Sim_result run_yelta_section(bool propagate, Runtime_ms pass_ms)
+{
+    init_millis();
+
+    Yelta_section layout;
+
+    if(propagate) {
+        layout.logic.enable_change_propagation();
+    }
+
+    Layout_sim sim(layout.logic, nullptr, pass_ms);
+
+    // Blocks in order from Pt Adelaide to Blackwood
+    Layout_sim::Block pt_adel = sim.add_block(layout.t_ptAdel, 3000);
+    Layout_sim::Block b_37 = sim.add_block(layout.t_37, 1500);
+    Layout_sim::Block b_36 = sim.add_block(layout.t_36, 1500);
+    Layout_sim::Block b_35 = sim.add_block(layout.t_35, 1500);
+    Layout_sim::Block b_34 = sim.add_block(layout.t_34, 2000);
+    Layout_sim::Block b_33 = sim.add_block(layout.t_33, 1500);
+    Layout_sim::Block b_31 = sim.add_block(layout.t_31, 2000);
+    Layout_sim::Block b_1342 = sim.add_block(layout.t_1342, 2500);
+    Layout_sim::Block b_1214 = sim.add_block(layout.t_1214, 2500);
+    Layout_sim::Block b_20 = sim.add_block(layout.t_20, 2000);
+
+    for(Head_interface* head : std::initializer_list<Head_interface*>{
+            &layout.head_1213a, &layout.head_1214a, &layout.head_1342a, &layout.head_1343a,
+            &layout.head_1381a, &layout.head_1382a, &layout.head_2412a, &layout.head_2413a,
+            &layout.head_2430a, &layout.head_2431a, &layout.head_2612a }) {
+        sim.watch(*head);
+    }
+
+    for(Sim_switch& sw : layout.sw) {
+        sim.watch(sw);
+    }
+
+    // Settle the initial aspects before the trains start
+    sim.run_until(1000);
+
+    // A train from Pt Adelaide to Blackwood, then one back
+    sim.add_train({pt_adel, b_37, b_36, b_35, b_34, b_33, b_31, b_1342, b_1214, b_20}, 400, 900, 2000);
+    sim.add_train({b_20, b_1214, b_1342, b_31, b_33, b_34, b_35, b_36, b_37, pt_adel}, 600, 600, 60000);
+
+    bool idle = sim.run_until_idle(180000, 1000);
+
+    EXPECT_EQ(40u,sim.get_block_changes());
+
+    // The APB section is clear again
+    EXPECT_FALSE(layout.bkwd_yelta_apb.up_tumbledown().is_active());
+    EXPECT_FALSE(layout.bkwd_yelta_apb.down_tumbledown().is_active());
+
+    return { idle, sim.get_latency_passes().max(), sim.get_latency_ms().max(),
+             sim.get_aspect_changes(), sim.get_switch_requests(), 0 };
+}
+
+}
+
+
+/*
+ * Evaluated in attach order, a signal only sees the signal ahead of it
+ * change on the following pass; ordered by change propagation, a clear block
+ * reaches every signal in a single pass
+ */
+TEST(Layout_sim,ThreeBlockLine)
+{
+    Sensor_base loop_blocks[3], change_blocks[3];
+
+    Sim_result every_loop = run_three_block_line(false, loop_blocks[0], loop_blocks[1], loop_blocks[2]);
+    Sim_result on_change = run_three_block_line(true, change_blocks[0], change_blocks[1], change_blocks[2]);
+
+    EXPECT_TRUE(every_loop.idle);
+    EXPECT_TRUE(on_change.idle);
+
+    EXPECT_EQ(2u,every_loop.max_latency_passes);
+    EXPECT_EQ(1u,every_loop.max_latency_ms);
+    EXPECT_EQ(1u,on_change.max_latency_passes);
+    EXPECT_EQ(0u,on_change.max_latency_ms);
+
+    // Every change reached the aspects expected for it
+    EXPECT_EQ(0u,every_loop.missed_episodes);
+    EXPECT_EQ(0u,on_change.missed_episodes);
+
+    // The same aspects are shown either way
+    EXPECT_EQ(every_loop.aspect_changes,on_change.aspect_changes);
+}
+
+/*
+ * The same line with its blocks detected by Loconet sensors, whose states are
+ * held in the adapter's state store with MR_SIGNALS_SENSOR_STORE: the
+ * simulated train sets them through Sensor_base and the logic sees them change
+ */
+TEST(Layout_sim,ThreeBlockLineLoconetSensors)
+{
+    init_millis();
+
+    Loconet_bus_sim bus({ 8, 25, 0, 0, 1 });
+    Setup_collection setup_coll(1);
+    Loop_collection loop_coll(1);
+    Loconet_txmgr tx_mgr;
+    Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, bus, 2, 3, 16, tx_mgr);
+
+    Loconet_sensor block_1("B1", 1, adapter);
+    Loconet_sensor block_2("B2", 2, adapter);
+    Loconet_sensor block_3("B3", 3, adapter);
+
+#if MR_SIGNALS_SENSOR_STORE
+    EXPECT_NE(Sensor_state_store::no_slot,block_1.get_slot());
+    EXPECT_NE(Sensor_state_store::no_slot,block_3.get_slot());
+#endif
+
+    Sim_result on_change = run_three_block_line(true, block_1, block_2, block_3);
+
+    EXPECT_TRUE(on_change.idle);
+    EXPECT_EQ(1u,on_change.max_latency_passes);
+    EXPECT_EQ(0u,on_change.max_latency_ms);
+
+    Sensor_base blocks[3];
+    Sim_result base_sensors = run_three_block_line(true, blocks[0], blocks[1], blocks[2]);
+
+    EXPECT_EQ(base_sensors.aspect_changes,on_change.aspect_changes);
+}
+
+/*
+ * Two trains through the Yelta section of Blackwood South, with a pass every
+ * 1ms and every 10ms
+ */
+TEST(Layout_sim,BlackwoodSouthYelta)
+{
+    for(Runtime_ms pass_ms : { 1, 10 }) {
+        Sim_result every_loop = run_yelta_section(false, pass_ms);
+        Sim_result on_change = run_yelta_section(true, pass_ms);
+
+        EXPECT_TRUE(every_loop.idle);
+        EXPECT_TRUE(on_change.idle);
+
+        EXPECT_EQ(2u,every_loop.max_latency_passes);
+        EXPECT_EQ(pass_ms,every_loop.max_latency_ms);
+        EXPECT_EQ(1u,on_change.max_latency_passes);
+        EXPECT_EQ(0u,on_change.max_latency_ms);
+
+        EXPECT_EQ(70u,every_loop.aspect_changes);
+        EXPECT_EQ(every_loop.aspect_changes,on_change.aspect_changes);
+        EXPECT_EQ(100u,every_loop.switch_requests);
+        EXPECT_EQ(every_loop.switch_requests,on_change.switch_requests);
+    }
+}
+
+/*
+ * Blocks entered on consecutive passes by two trains, with heads that take 3
+ * passes to show red: measured to the last aspect change, the first entry's
+ * episode is cut short by the second and not measured; with an oracle both
+ * are measured until their aspects are shown
+ */
+TEST(Layout_sim,ExpectedAspects)
+{
+    for(bool oracle : { false, true }) {
+        init_millis();
+
+        Sensor_base block_a, block_b;
+        Test_head head_a, head_b;
+        Logic_collection logic(2);
+        Delayed_red_logic logic_a(logic, block_a, head_a, 3);
+        Delayed_red_logic logic_b(logic, block_b, head_b, 3);
+
+        Layout_sim sim(logic);
+
+        Layout_sim::Block a = sim.add_block(block_a, 1000);
+        Layout_sim::Block b = sim.add_block(block_b, 1000);
+
+        sim.watch(head_a);
+        sim.watch(head_b);
+
+        if(oracle) {
+            sim.set_oracle([a, b](const Layout_sim& layout) {
+                return std::vector<Head_aspect>{
+                    layout.is_occupied(a) ? Head_aspect::red : Head_aspect::green,
+                    layout.is_occupied(b) ? Head_aspect::red : Head_aspect::green };
+            });
+        }
+
+        sim.add_train({a}, 1000, 100, 0);       // Enters at 1ms
+        sim.add_train({b}, 1000, 100, 1);       // Enters at 2ms
+
+        EXPECT_TRUE(sim.run_until_idle(5000));
+
+        // Both are entered and left
+        EXPECT_EQ(4u,sim.get_block_changes());
+        EXPECT_EQ(3u,sim.get_latency_passes().max());
+        EXPECT_EQ(2u,sim.get_latency_ms().max());
+
+        EXPECT_EQ(oracle ? 4u : 3u,sim.get_latency_passes().count());
+        EXPECT_EQ(0u,sim.get_superseded_episodes());
+        EXPECT_EQ(0u,sim.get_unmet_episodes());
+    }
+}
@@ -0,0 +1,261 @@
+/*
+ * loconet_bus_sim.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "loconet_bus_sim.h"
+#include "arduino_mock.h"
+
+#include "mrrwa_loconet_adapter.h"
+#include "loconet_adapter_interface.h"     // Loconet_txmgr_interface
+
+
+namespace mr_signals
+{
+
+
+// Define static constant members for external use
+const uint32_t Loconet_bus_sim::byte_us;
+const uint32_t Loconet_bus_sim::cd_backoff_us;
+const uint32_t Loconet_bus_sim::break_us;
+
+
+namespace {
+
+void set_checksum(lnMsg& msg)
+{
+    uint8_t size = getLnMsgSize(&msg);
+    uint8_t checksum = 0xFF;
+
+    for(uint8_t i = 0; i + 1 < size; i++) {
+        checksum ^= msg.data[i];
+    }
+
+    msg.data[size - 1] = checksum;
+}
+
+}
+
+
+Loconet_bus_sim::Loconet_bus_sim(const Loconet_bus_config& config) :
+        config_(config), random_state_(config.seed ? config.seed : 1),
+        start_us_(0), bus_free_us_(0), busy_us_(0),
+        cs_occupancy_(0), cs_high_watermark_(0), cs_last_drain_ms_(0), rx_msg_(),
+        sent_(0), delivered_(0), accepted_(0), long_acks_(0), collisions_(0), backoffs_(0)
+{
+    start_us_ = now_us();
+    bus_free_us_ = start_us_;
+    cs_last_drain_ms_ = millis();
+}
+
+LN_STATUS Loconet_bus_sim::reportPower(uint8_t state)
+{
+    lnMsg msg = {};
+    msg.data[0] = state ? OPC_GPON : 0x82;      // OPC_GPOFF
+
+    return send(&msg);
+}
+
+lnMsg* Loconet_bus_sim::receive()
+{
+    // Messages are received once they have been carried by the bus
+    if(rx_queue_.empty() || now_us() < bus_free_us_) {
+        return nullptr;
+    }
+
+    rx_msg_ = rx_queue_.front();
+    rx_queue_.pop_front();
+
+    return &rx_msg_;
+}
+
+LN_STATUS Loconet_bus_sim::send(lnMsg* msg)
+{
+    sent_++;
+
+    if(now_us() < bus_free_us_) {
+        backoffs_++;
+        return LN_NETWORK_BUSY;     // Still carrying an earlier message
+    }
+
+    const uint64_t message_us = getLnMsgSize(msg) * byte_us;
+
+    if(config_.busy_per_mille && random_per_mille() < config_.busy_per_mille) {
+        occupy_bus(cd_backoff_us + 4 * byte_us);    // Another device's message takes the bus
+        backoffs_++;
+        return LN_CD_BACKOFF;
+    }
+
+    if(config_.collision_per_mille && random_per_mille() < config_.collision_per_mille) {
+        occupy_bus(cd_backoff_us + message_us + break_us);
+        collisions_++;
+        return LN_COLLISION;
+    }
+
+    occupy_bus(cd_backoff_us + message_us);
+    delivered_++;
+
+    if(OPC_SW_REQ == msg->data[0]) {
+        drain_command_station();
+
+        if(cs_occupancy_ < config_.cs_buffer_capacity) {
+            cs_occupancy_++;
+            accepted_++;
+
+            if(cs_occupancy_ > cs_high_watermark_) {
+                cs_high_watermark_ = cs_occupancy_;
+            }
+        }
+        else {
+            lnMsg long_ack = {};
+            long_ack.data[0] = OPC_LONG_ACK;
+            long_ack.data[1] = OPC_SW_REQ & 0x7F;
+            long_ack.data[2] = 0;       // Rejected
+            set_checksum(long_ack);
+
+            queue_rx(long_ack);
+            long_acks_++;
+        }
+    }
+
+    return LN_DONE;
+}
+
+void Loconet_bus_sim::report_sensor(uint16_t address, bool state)
+{
+    // Inverse of the decoding in processSwitchSensorMessage()
+    uint16_t offset = address ? address - 1 : 0;
+
+    lnMsg report = {};
+    report.data[0] = OPC_INPUT_REP;
+    report.ir.in1 = (offset >> 1) & 0x7F;
+    report.ir.in2 = ((offset >> 8) & 0x0F) | OPC_INPUT_REP_CB |
+                    ((offset & 1) ? OPC_INPUT_REP_SW : 0) | (state ? OPC_INPUT_REP_HI : 0);
+    set_checksum(report);
+
+    queue_rx(report);
+}
+
+uint16_t Loconet_bus_sim::get_utilization_per_mille() const
+{
+    uint64_t elapsed_us = now_us() - start_us_;
+
+    if(0 == elapsed_us) {
+        return 0;
+    }
+
+    uint64_t busy_us = busy_us_ < elapsed_us ? busy_us_ : elapsed_us;
+
+    return busy_us * 1000 / elapsed_us;
+}
+
+uint64_t Loconet_bus_sim::now_us() const
+{
+    return (uint64_t)millis() * 1000;
+}
+
+void Loconet_bus_sim::occupy_bus(uint64_t duration_us)
+{
+    uint64_t now = now_us();
+    uint64_t start = (bus_free_us_ > now) ? bus_free_us_ : now;
+
+    bus_free_us_ = start + duration_us;
+    busy_us_ += duration_us;
+}
+
+void Loconet_bus_sim::drain_command_station()
+{
+    Runtime_ms now = millis();
+
+    if(0 == config_.dcc_interval_ms) {
+        cs_occupancy_ = 0;
+        return;
+    }
+
+    while(cs_occupancy_ && now - cs_last_drain_ms_ >= config_.dcc_interval_ms) {
+        cs_occupancy_--;
+        cs_last_drain_ms_ += config_.dcc_interval_ms;
+    }
+
+    if(0 == cs_occupancy_) {
+        cs_last_drain_ms_ = now;
+    }
+}
+
+void Loconet_bus_sim::queue_rx(const lnMsg& msg)
+{
+    occupy_bus(cd_backoff_us + getLnMsgSize(const_cast<lnMsg*>(&msg)) * byte_us);
+    rx_queue_.push_back(msg);
+}
+
+/// xorshift32
+uint16_t Loconet_bus_sim::random_per_mille()
+{
+    random_state_ ^= random_state_ << 13;
+    random_state_ ^= random_state_ >> 17;
+    random_state_ ^= random_state_ << 5;
+
+    return random_state_ % 1000;
+}
+
+
+///////////////////////////////////////////////////
+
+
+Startup_result simulate_startup(Loconet_txmgr_interface& tx_mgr, const Loconet_bus_config& config,
+                                Runtime_ms timeout_ms)
+{
+    init_millis();
+
+    Loconet_bus_sim bus(config);
+
+    Setup_collection setup_coll(1);
+    Loop_collection loop_coll(1);
+
+    Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, bus, 2, 0, MRRWA_LN_TX_BUFFER_CAPACITY, tx_mgr);
+
+    // Startup backlog fills the bulk lane
+    std::size_t backlog = 0;
+    while(adapter.send_opc_sw_req(1 + backlog, true, true)) {
+        backlog++;
+    }
+
+    const Mrrwa_loconet_tx_telemetry& telemetry = adapter.get_tx_telemetry();
+
+    Runtime_ms time_ms = 0;
+    Runtime_ms last_accept_ms = 0;
+    uint32_t accepted = 0;
+
+    auto run_pass = [&]() {
+        set_millis(++time_ms);
+        adapter.loop();
+
+        if(bus.get_accepted() != accepted) {
+            accepted = bus.get_accepted();
+            last_accept_ms = time_ms;
+        }
+    };
+
+    while(time_ms < timeout_ms && telemetry.transmitted_count() < backlog) {
+        run_pass();
+    }
+
+    // Let the last retransmissions complete
+    for(Runtime_ms end_ms = time_ms + 2000; time_ms < end_ms; ) {
+        run_pass();
+    }
+
+    Startup_result result;
+    result.backlog = backlog;
+    result.drain_ms = last_accept_ms;
+    result.long_acks = adapter.get_long_ack_count();
+    result.dropped = backlog > accepted ? backlog - accepted : 0;
+    result.collisions = bus.get_collisions();
+    result.utilization_per_mille = bus.get_utilization_per_mille();
+
+    return result;
+}
+
+
+} // namespace mr_signals
@@ -0,0 +1,150 @@
+/*
+ * loconet_bus_sim.h
+ *
+ * Behavioural model of a LocoNet bus and command station, for tuning the
+ * transmission managers and the adapter's queues on the host
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef TEST_LOCONET_BUS_SIM_H_
+#define TEST_LOCONET_BUS_SIM_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <deque>
+
+#include "mrrwa_loconet_mock.h"     // LocoNetClass, lnMsg
+#include "base/timer_service.h"     // Runtime_ms
+
+namespace mr_signals
+{
+
+class Loconet_txmgr_interface;
+
+
+/// Settings of a Loconet_bus_sim
+struct Loconet_bus_config {
+    uint8_t cs_buffer_capacity;     /// Switch requests the command station can hold
+    Runtime_ms dcc_interval_ms;     /// Time for the command station to send one request on DCC
+    uint16_t busy_per_mille;        /// Chance that another device is transmitting when a message is sent
+    uint16_t collision_per_mille;   /// Chance that a message collides
+    uint32_t seed;                  /// Seed of the (deterministic) random numbers
+};
+
+
+/**
+ * Drop-in LocoNetClass that models the bus rather than recording calls
+ *
+ * Each message sent, and each message received from the other devices and
+ * the command station, occupies the bus for its bytes at LocoNet's 16.66k
+ * baud, after the carrier detect backoff.  Time is taken from millis().
+ *
+ * - A message sent while the bus is still carrying an earlier message
+ *   returns LN_NETWORK_BUSY, and with busy_per_mille another device's
+ *   message takes the bus first and LN_CD_BACKOFF is returned, as MRRWA's
+ *   send() does when it gives up waiting for the bus.
+ * - With collision_per_mille a message collides and LN_COLLISION is
+ *   returned; the bus is held for the message and the break.
+ * - Switch requests delivered are put in the command station's buffer, which
+ *   drains one request every dcc_interval_ms.  A request arriving with the
+ *   buffer full is answered with OPC_LONG_ACK, returned by receive().
+ * - processSwitchSensorMessage() calls notifySensor() for the sensor reports
+ *   injected with report_sensor(), as MRRWA does.
+ */
+class Loconet_bus_sim : public LocoNetClass {
+public:
+
+    static const uint32_t byte_us = 600;            // 10 bits of 60us at 16.66k baud
+    static const uint32_t cd_backoff_us = 1200;     // 20 bit times
+    static const uint32_t break_us = 900;           // 15 bit times, after a collision
+
+    explicit Loconet_bus_sim(const Loconet_bus_config& config);
+
+    void init(uint8_t) override {}
+
+    LN_STATUS reportPower(uint8_t state) override;
+
+    lnMsg* receive() override;
+
+    uint8_t processSwitchSensorMessage(lnMsg* msg) override { return process_sensor_message(msg); }
+
+    LN_STATUS send(lnMsg* msg) override;
+
+    /// Queue a sensor report from another device, received on the bus now
+    void report_sensor(uint16_t address, bool state);
+
+    uint32_t get_sent() const { return sent_; }                 /// Calls to send()
+    uint32_t get_delivered() const { return delivered_; }       /// Messages sent with LN_DONE
+    uint32_t get_accepted() const { return accepted_; }         /// Switch requests taken by the command station
+    uint32_t get_long_acks() const { return long_acks_; }
+    uint32_t get_collisions() const { return collisions_; }
+    uint32_t get_backoffs() const { return backoffs_; }         /// LN_CD_BACKOFF and LN_NETWORK_BUSY returned
+    uint8_t get_cs_high_watermark() const { return cs_high_watermark_; }
+
+    /// Time that the bus has carried messages since the simulation started
+    uint64_t get_busy_us() const { return busy_us_; }
+
+    /// Bus busy time as parts per thousand of the time since the simulation started
+    uint16_t get_utilization_per_mille() const;
+
+private:
+
+    uint64_t now_us() const;
+
+    /// Put a message on the bus at the earliest time it is free
+    void occupy_bus(uint64_t duration_us);
+
+    /// Remove the requests sent to DCC from the command station's buffer
+    void drain_command_station();
+
+    void queue_rx(const lnMsg& msg);
+
+    uint16_t random_per_mille();
+
+    Loconet_bus_config config_;
+    uint32_t random_state_;
+
+    uint64_t start_us_;
+    uint64_t bus_free_us_;
+    uint64_t busy_us_;
+
+    uint8_t cs_occupancy_;
+    uint8_t cs_high_watermark_;
+    Runtime_ms cs_last_drain_ms_;
+
+    std::deque<lnMsg> rx_queue_;
+    lnMsg rx_msg_;              // Message returned by receive()
+
+    uint32_t sent_;
+    uint32_t delivered_;
+    uint32_t accepted_;
+    uint32_t long_acks_;
+    uint32_t collisions_;
+    uint32_t backoffs_;
+};
+
+
+/// Result of simulate_startup()
+struct Startup_result {
+    std::size_t backlog;        /// Switch requests queued at startup
+    Runtime_ms drain_ms;        /// Time when the last request was accepted by the command station
+    uint32_t long_acks;
+    std::size_t dropped;        /// Requests never accepted
+    uint32_t collisions;
+    uint16_t utilization_per_mille;
+};
+
+
+/**
+ * Fill the adapter's transmit queue with switch requests at power on and run
+ * the adapter's loop, one pass per ms, until every request has been
+ * transmitted (plus 2s for the last retransmissions) or timeout_ms
+ */
+Startup_result simulate_startup(Loconet_txmgr_interface& tx_mgr, const Loconet_bus_config& config,
+                                Runtime_ms timeout_ms = 120000);
+
+
+} // namespace mr_signals
+
+#endif /* TEST_LOCONET_BUS_SIM_H_ */
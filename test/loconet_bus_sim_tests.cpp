@@ -0,0 +1,184 @@
+/*
+ * loconet_bus_sim_tests.cpp
+ *
+ * Unit tests for the Loconet_bus_sim bus and command station model
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "loconet_bus_sim.h"
+#include "arduino_mock.h"
+
+#include "mrrwa_loconet_adapter.h"
+#include "loconet_txmgr.h"
+
+
+using namespace mr_signals;
+
+
+namespace {
+
+const Loconet_bus_config quiet_bus = { 8, 25, 0, 0, 1 };
+
+lnMsg switch_request(uint8_t address)
+{
+    lnMsg msg = {};
+    msg.data[0] = OPC_SW_REQ;
+    msg.data[1] = address;
+    msg.data[2] = OPC_SW_REQ_OUT;
+
+    return msg;
+}
+
+}
+
+
+/*
+ * Messages hold the bus for their bytes, and a message sent while the bus is
+ * carrying an earlier one is refused
+ */
+TEST(Loconet_bus_sim,BusTime)
+{
+    init_millis();
+    set_millis(100);
+
+    Loconet_bus_sim bus(quiet_bus);
+    lnMsg msg = switch_request(1);
+
+    EXPECT_EQ(LN_DONE,bus.send(&msg));
+    EXPECT_EQ(LN_NETWORK_BUSY,bus.send(&msg));
+
+    const uint64_t message_us = Loconet_bus_sim::cd_backoff_us + 4 * Loconet_bus_sim::byte_us;
+    EXPECT_EQ(message_us,bus.get_busy_us());
+
+    set_millis(110);
+    EXPECT_EQ(message_us * 1000 / 10000,bus.get_utilization_per_mille());
+
+    EXPECT_EQ(LN_DONE,bus.send(&msg));
+
+    EXPECT_EQ(3u,bus.get_sent());
+    EXPECT_EQ(2u,bus.get_delivered());
+    EXPECT_EQ(1u,bus.get_backoffs());
+}
+
+/*
+ * The command station answers a switch request with a LONG_ACK when its
+ * buffer is full, and drains a request per DCC interval
+ */
+TEST(Loconet_bus_sim,CommandStationBuffer)
+{
+    init_millis();
+
+    Loconet_bus_sim bus({ 2, 100, 0, 0, 1 });
+    lnMsg msg = switch_request(1);
+
+    for(Runtime_ms time = 10; time <= 30; time += 10) {
+        set_millis(time);
+        EXPECT_EQ(LN_DONE,bus.send(&msg));
+    }
+
+    EXPECT_EQ(2u,bus.get_accepted());
+    EXPECT_EQ(1u,bus.get_long_acks());
+    EXPECT_EQ(2,bus.get_cs_high_watermark());
+
+    // The LONG_ACK is received once the bus has carried it
+    EXPECT_EQ(nullptr,bus.receive());
+
+    set_millis(40);
+    lnMsg* ack = bus.receive();
+    ASSERT_NE(nullptr,ack);
+    EXPECT_EQ(OPC_LONG_ACK,ack->data[0]);
+    EXPECT_EQ(OPC_SW_REQ & 0x7F,ack->data[1]);
+    EXPECT_EQ(0xFF ^ OPC_LONG_ACK ^ (OPC_SW_REQ & 0x7F),ack->data[3]);
+    EXPECT_EQ(nullptr,bus.receive());
+
+    // One request has been sent on DCC
+    set_millis(111);
+    EXPECT_EQ(LN_DONE,bus.send(&msg));
+    EXPECT_EQ(3u,bus.get_accepted());
+}
+
+/*
+ * Collisions and other devices' traffic are returned as the MRRWA statuses
+ */
+TEST(Loconet_bus_sim,CollisionsAndBackoff)
+{
+    init_millis();
+
+    lnMsg msg = switch_request(1);
+
+    Loconet_bus_sim busy_bus({ 8, 25, 1000, 0, 1 });
+    EXPECT_EQ(LN_CD_BACKOFF,busy_bus.send(&msg));
+    EXPECT_EQ(0u,busy_bus.get_delivered());
+
+    Loconet_bus_sim colliding_bus({ 8, 25, 0, 1000, 1 });
+    EXPECT_EQ(LN_COLLISION,colliding_bus.send(&msg));
+    EXPECT_EQ(1u,colliding_bus.get_collisions());
+    EXPECT_EQ(0u,colliding_bus.get_accepted());
+
+    // Random outcomes are repeatable for a seed
+    Loconet_bus_config config = { 8, 0, 100, 100, 7 };
+    Loconet_bus_sim bus_a(config);
+    Loconet_bus_sim bus_b(config);
+
+    for(Runtime_ms time = 10; time < 10000; time += 10) {
+        set_millis(time);
+        bus_a.send(&msg);
+        bus_b.send(&msg);
+    }
+
+    EXPECT_EQ(bus_a.get_collisions(),bus_b.get_collisions());
+    EXPECT_EQ(bus_a.get_backoffs(),bus_b.get_backoffs());
+    EXPECT_LT(50u,bus_a.get_collisions());
+    EXPECT_GT(150u,bus_a.get_collisions());
+}
+
+/*
+ * Sensor reports from other devices reach the adapter's sensors
+ */
+TEST(Loconet_bus_sim,SensorReports)
+{
+    init_millis();
+
+    Loconet_bus_sim bus(quiet_bus);
+    Setup_collection setup_coll(1);
+    Loop_collection loop_coll(1);
+    Loconet_txmgr tx_mgr;
+    Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, bus, 2, 3, 16, tx_mgr);
+
+    Loconet_sensor sensor_1("S1", 1, adapter);
+    Loconet_sensor sensor_2("S2", 2, adapter);
+    Loconet_sensor sensor_1000("S1000", 1000, adapter);
+
+    bus.report_sensor(2, true);
+    bus.report_sensor(1000, true);
+    bus.report_sensor(1, false);
+
+    set_millis(20);
+    adapter.loop();
+
+    EXPECT_TRUE(sensor_2.is_active());
+    EXPECT_TRUE(sensor_1000.is_active());
+    EXPECT_FALSE(sensor_1.is_active());
+    EXPECT_FALSE(sensor_1.is_indeterminate());
+}
+
+/*
+ * The startup harness drains a full transmit queue through the command
+ * station
+ */
+TEST(Loconet_bus_sim,StartupHarness)
+{
+    Loconet_txmgr tx_mgr;
+
+    Startup_result result = simulate_startup(tx_mgr, { 8, 50, 20, 20, 1 });
+
+    EXPECT_LT(0u,result.backlog);
+    EXPECT_EQ(0u,result.dropped);
+    EXPECT_LT(result.backlog * 50,result.drain_ms);
+    EXPECT_LT(0u,result.collisions);
+    EXPECT_LT(0,result.utilization_per_mille);
+    EXPECT_GT(1000,result.utilization_per_mille);
+}
@@ -0,0 +1,243 @@
+/*
+ * loconet_capture_tests.cpp
+ *
+ * Unit tests for Loconet_capture, Loconet_capture_reader and Loconet_replay
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "loconet_capture.h"
+#include "loconet_replay.h"
+#include "loconet_bus_sim.h"
+#include "arduino_mock.h"
+
+#include "mrrwa_loconet_adapter.h"
+#include "loconet_txmgr.h"
+
+#include <sstream>
+#include <string>
+
+using namespace mr_signals;
+
+
+namespace {
+
+const uint8_t sensor_msg[4] = { 0xB2, 0x13, 0x50, 0x0E };
+const uint8_t switch_msg[4] = { 0xB0, 0x01, 0x30, 0x00 };      // Checksum not set, as queued
+
+std::vector<uint8_t> dump_bytes(Loconet_capture& capture, std::size_t max_bytes = SIZE_MAX)
+{
+    std::ostringstream out;
+    capture.dump(out, max_bytes);
+
+    std::string text = out.str();
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+}
+
+
+/*
+ * Records hold the time since the previous record and the message, and are
+ * read back with their times from the start of the capture
+ */
+TEST(Loconet_capture,RecordAndRead)
+{
+    set_millis(1000);
+    Loconet_capture capture;
+
+    EXPECT_TRUE(capture.record(Loconet_capture_direction::rx, sensor_msg));
+    set_millis(1010);
+    EXPECT_TRUE(capture.record(Loconet_capture_direction::tx, switch_msg));
+    set_millis(1300);
+    EXPECT_TRUE(capture.record(Loconet_capture_direction::rx, sensor_msg));
+
+    std::vector<uint8_t> bytes = dump_bytes(capture);
+
+    // Header, then 1 + 4, 1 + 4 and (as 600 > 127) 2 + 4 bytes
+    ASSERT_EQ(4u + 5 + 5 + 6, bytes.size());
+    EXPECT_EQ('L', bytes[0]);
+    EXPECT_EQ(Loconet_capture::version, bytes[3]);
+    EXPECT_EQ(0u, bytes[4]);
+    EXPECT_EQ((10 << 1) | 1, bytes[9]);
+    EXPECT_EQ(0u, capture.size());
+
+    Loconet_capture_reader reader(bytes.data(), bytes.size());
+    Loconet_capture_entry entry;
+
+    ASSERT_TRUE(reader.next(entry));
+    EXPECT_EQ(0u, entry.time_ms);
+    EXPECT_EQ(Loconet_capture_direction::rx, entry.direction);
+    EXPECT_EQ(4, entry.size);
+    EXPECT_EQ(0, memcmp(sensor_msg, entry.message, sizeof(sensor_msg)));
+
+    ASSERT_TRUE(reader.next(entry));
+    EXPECT_EQ(10u, entry.time_ms);
+    EXPECT_EQ(Loconet_capture_direction::tx, entry.direction);
+    EXPECT_EQ(0xFF ^ 0xB0 ^ 0x01 ^ 0x30, entry.message[3]);
+
+    ASSERT_TRUE(reader.next(entry));
+    EXPECT_EQ(300u, entry.time_ms);
+
+    EXPECT_FALSE(reader.next(entry));
+    EXPECT_FALSE(reader.error());
+
+    // Variable length messages are sized by their second byte; invalid ones are not recorded
+    const uint8_t write_slot[14] = { OPC_WR_SL_DATA, 14 };
+    const uint8_t not_opcode[2] = { 0x12, 0x34 };
+
+    EXPECT_TRUE(capture.record(Loconet_capture_direction::tx, write_slot));
+    EXPECT_FALSE(capture.record(Loconet_capture_direction::tx, not_opcode));
+    EXPECT_EQ(1u + 14, capture.size());
+}
+
+/*
+ * Messages that do not fit are dropped and counted; the next record's time
+ * covers them.  dump() only writes whole records.
+ */
+TEST(Loconet_capture,DropAndPartialDump)
+{
+    set_millis(0);
+    Loconet_capture capture;
+
+    std::size_t recorded = 0;
+    while(capture.record(Loconet_capture_direction::rx, sensor_msg)) {
+        recorded++;
+        set_millis(millis() + 1);
+    }
+
+    EXPECT_EQ(Loconet_capture::capacity / 5, recorded);
+    EXPECT_EQ(1u, capture.dropped());
+
+    // Header plus two records fit in 14 bytes
+    std::vector<uint8_t> bytes = dump_bytes(capture, 14);
+    EXPECT_EQ(4u + 2 * 5, bytes.size());
+
+    set_millis(millis() + 99);
+    EXPECT_TRUE(capture.record(Loconet_capture_direction::rx, sensor_msg));
+
+    std::vector<uint8_t> rest = dump_bytes(capture);
+    bytes.insert(bytes.end(), rest.begin(), rest.end());
+
+    Loconet_capture_reader reader(bytes.data(), bytes.size());
+    Loconet_capture_entry entry;
+    std::size_t read = 0;
+
+    while(reader.next(entry)) {
+        read++;
+    }
+
+    EXPECT_FALSE(reader.error());
+    EXPECT_EQ(recorded + 1, read);
+    EXPECT_EQ(recorded - 1 + 1 + 99, entry.time_ms);
+}
+
+/*
+ * A capture without the header, or that ends part way through a record, is
+ * reported as an error
+ */
+TEST(Loconet_capture,ReaderErrors)
+{
+    const uint8_t no_header[] = { 0x00, 0xB2, 0x13, 0x50, 0x0E };
+    const uint8_t truncated[] = { 'L', 'N', 'C', 1, 0x00, 0xB2, 0x13, 0x50, 0x0E, 0x02, 0xB2, 0x13 };
+
+    Loconet_capture_entry entry;
+
+    Loconet_capture_reader bad_header(no_header, sizeof(no_header));
+    EXPECT_FALSE(bad_header.next(entry));
+    EXPECT_TRUE(bad_header.error());
+
+    Loconet_capture_reader bad_record(truncated, sizeof(truncated));
+    EXPECT_TRUE(bad_record.next(entry));
+    EXPECT_FALSE(bad_record.next(entry));
+    EXPECT_TRUE(bad_record.error());
+
+    bad_record.rewind();
+    EXPECT_FALSE(bad_record.error());
+    EXPECT_TRUE(bad_record.next(entry));
+}
+
+/*
+ * Traffic captured from the adapter replays through a new adapter to the
+ * same sensor states and transmitted messages, at the original or an
+ * accelerated speed
+ */
+TEST(Loconet_capture,AdapterReplay)
+{
+    std::vector<uint8_t> bytes;
+
+    {
+        init_millis();
+
+        Loconet_capture capture;
+        Loconet_capture::set_active(&capture);
+
+        Loconet_bus_sim bus({ 8, 25, 0, 0, 1 });
+        Setup_collection setup_coll(1);
+        Loop_collection loop_coll(1);
+        Loconet_txmgr tx_mgr;
+        Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, bus, 2, 3, 64, tx_mgr);
+
+        Loconet_sensor sensor_1("S1", 1, adapter);
+        Loconet_sensor sensor_2("S2", 2, adapter);
+
+        bus.report_sensor(1, true);
+        adapter.send_opc_sw_req(10, true, true);
+
+        for(Runtime_ms time = 0; time < 1000; time++) {
+            if(200 == time) {
+                bus.report_sensor(2, true);
+                bus.report_sensor(1, false);
+            }
+            if(100 == time) {
+                adapter.send_opc_sw_req(11, false, true);
+            }
+
+            set_millis(time);
+            adapter.loop();
+        }
+
+        EXPECT_EQ(0u, capture.dropped());
+        EXPECT_EQ(1000u, millis() + 1);
+
+        std::ostringstream out;
+        capture.dump(out);
+        std::string text = out.str();
+        bytes.assign(text.begin(), text.end());
+    }
+
+    for(uint16_t speedup : { 1, 10 }) {
+        init_millis();
+
+        Loconet_replay replay(bytes.data(), bytes.size(), speedup);
+        Setup_collection setup_coll(1);
+        Loop_collection loop_coll(1);
+        Loconet_txmgr tx_mgr;
+        Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, replay, 2, 3, 64, tx_mgr);
+
+        Loconet_sensor sensor_1("S1", 1, adapter);
+        Loconet_sensor sensor_2("S2", 2, adapter);
+
+        adapter.send_opc_sw_req(10, true, true);
+
+        uint32_t passes = replay.run([&]() {
+            if(100 / speedup == millis()) {
+                adapter.send_opc_sw_req(11, false, true);
+            }
+            adapter.loop();
+        }, 1, 400);
+
+        EXPECT_FALSE(replay.error());
+        EXPECT_EQ(3u, replay.get_received());
+        EXPECT_LE(200u / speedup + 400, passes);
+        EXPECT_GT(200u / speedup + 410, passes);
+
+        EXPECT_FALSE(sensor_1.is_active());
+        EXPECT_TRUE(sensor_2.is_active());
+
+        ASSERT_EQ(2u, replay.get_captured_tx().size());
+        EXPECT_TRUE(replay.get_captured_tx() == replay.get_sent());
+    }
+}
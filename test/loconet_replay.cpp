@@ -0,0 +1,134 @@
+/*
+ * loconet_replay.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "loconet_replay.h"
+#include "arduino_mock.h"
+
+#include <string.h>
+#include <fstream>
+#include <iterator>
+
+namespace mr_signals
+{
+
+
+Loconet_replay::Loconet_replay(const uint8_t* capture, std::size_t size, uint16_t speedup) :
+        reader_(capture, size), speedup_(speedup), start_ms_(0), pending_(false), next_(), rx_msg_(),
+        received_(0)
+{
+    restart();
+}
+
+void Loconet_replay::restart()
+{
+    reader_.rewind();
+    start_ms_ = millis();
+    received_ = 0;
+    captured_tx_.clear();
+    sent_.clear();
+
+    read_next();
+}
+
+void Loconet_replay::read_next()
+{
+    pending_ = false;
+
+    while(reader_.next(next_)) {
+        if(Loconet_capture_direction::rx == next_.direction) {
+            pending_ = true;
+            break;
+        }
+
+        captured_tx_.push_back(next_);
+    }
+}
+
+lnMsg* Loconet_replay::receive()
+{
+    if(!pending_) {
+        return nullptr;
+    }
+
+    if(speedup_ && millis() - start_ms_ < next_.time_ms / speedup_) {
+        return nullptr;     // Not yet due
+    }
+
+    rx_msg_ = {};
+    memcpy(rx_msg_.data, next_.message, next_.size);
+    received_++;
+
+    read_next();
+
+    return &rx_msg_;
+}
+
+LN_STATUS Loconet_replay::send(lnMsg* msg)
+{
+    Loconet_capture_entry entry = {};
+
+    entry.time_ms = millis() - start_ms_;
+    entry.direction = Loconet_capture_direction::tx;
+    entry.size = Loconet_capture::message_size(msg->data);
+
+    if(entry.size) {
+        memcpy(entry.message, msg->data, entry.size);
+
+        // The adapter leaves the checksum to LocoNetClass
+        uint8_t checksum = 0xFF;
+        for(uint8_t i = 0; i < entry.size - 1; i++) {
+            checksum ^= entry.message[i];
+        }
+        entry.message[entry.size - 1] = checksum;
+    }
+
+    sent_.push_back(entry);
+
+    return LN_DONE;
+}
+
+uint32_t Loconet_replay::run(std::function<void()> pass, Runtime_ms pass_ms, Runtime_ms settle_ms,
+                             Runtime_ms max_ms)
+{
+    const Runtime_ms end_ms = millis() + max_ms;
+    uint32_t passes = 0;
+    Runtime_ms settle_end_ms = 0;
+
+    while(millis() < end_ms) {
+        pass();
+        passes++;
+
+        if(done()) {
+            if(0 == settle_end_ms) {
+                settle_end_ms = millis() + settle_ms;
+            }
+
+            if(millis() >= settle_end_ms) {
+                break;
+            }
+        }
+
+        set_millis(millis() + pass_ms);
+    }
+
+    return passes;
+}
+
+std::vector<uint8_t> Loconet_replay::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+
+bool operator==(const Loconet_capture_entry& a, const Loconet_capture_entry& b)
+{
+    return a.direction == b.direction && a.size == b.size && 0 == memcmp(a.message, b.message, a.size);
+}
+
+
+} // namespace mr_signals
@@ -0,0 +1,114 @@
+/*
+ * loconet_replay.h
+ *
+ * Replays a LocoNet capture (see loconet_capture.h) through the adapter on
+ * the host, for reproducing bus traffic recorded on a layout and as input for
+ * performance runs
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef TEST_LOCONET_REPLAY_H_
+#define TEST_LOCONET_REPLAY_H_
+
+#include <stdint.h>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "mrrwa_loconet_mock.h"     // LocoNetClass, lnMsg
+#include "loconet_capture.h"
+#include "base/timer_service.h"     // Runtime_ms
+
+namespace mr_signals
+{
+
+
+/**
+ * LocoNetClass that returns the received messages of a capture from
+ * receive() at their captured times, scaled by a speedup, measured from
+ * millis() when the replay is constructed (or restarted)
+ *
+ * With a speedup of 0 every message is due at once, so each receive() returns
+ * the next message.  Messages sent by the adapter are kept so that they can be
+ * compared with those sent in the capture; send() always returns LN_DONE.
+ *
+ * Example
+ *
+ * Loconet_replay replay(capture_bytes, capture_size, 10);  // 10x speed
+ * Mrrwa_loconet_adapter adapter(setup_coll, loop_coll, replay, ...);
+ * ...
+ * replay.run([&]() { loop_coll.execute(); logic_coll.loop(); });
+ * EXPECT_EQ(replay.get_captured_tx(), replay.get_sent());
+ */
+class Loconet_replay : public LocoNetClass {
+public:
+
+    /// Replay a capture; the bytes must outlive the replay
+    Loconet_replay(const uint8_t* capture, std::size_t size, uint16_t speedup = 1);
+
+    void init(uint8_t) override {}
+
+    LN_STATUS reportPower(uint8_t) override { return LN_DONE; }
+
+    lnMsg* receive() override;
+
+    uint8_t processSwitchSensorMessage(lnMsg* msg) override { return process_sensor_message(msg); }
+
+    LN_STATUS send(lnMsg* msg) override;
+
+    /// Replay from the first message, from millis() now
+    void restart();
+
+    /// true once every received message has been returned
+    bool done() const { return !pending_; }
+
+    /**
+     * Advance set_millis() by pass_ms and call pass, until done() and then
+     * for settle_ms more, or until max_ms has passed
+     * @return The number of passes
+     */
+    uint32_t run(std::function<void()> pass, Runtime_ms pass_ms = 1, Runtime_ms settle_ms = 0,
+                 Runtime_ms max_ms = 3600000);
+
+    /// true if the capture could not be read to its end
+    bool error() const { return reader_.error(); }
+
+    uint32_t get_received() const { return received_; }     /// Messages returned by receive()
+
+    /// Messages sent in the capture, read so far
+    const std::vector<Loconet_capture_entry>& get_captured_tx() const { return captured_tx_; }
+
+    /// Messages sent by the adapter during the replay
+    const std::vector<Loconet_capture_entry>& get_sent() const { return sent_; }
+
+    /// Load a capture file
+    static std::vector<uint8_t> load(const std::string& path);
+
+private:
+
+    /// Read up to the next received message
+    void read_next();
+
+    Loconet_capture_reader reader_;
+    uint16_t speedup_;
+    Runtime_ms start_ms_;
+
+    bool pending_;                  // next_ holds a received message not yet returned
+    Loconet_capture_entry next_;
+    lnMsg rx_msg_;                  // Message returned by receive()
+
+    uint32_t received_;
+    std::vector<Loconet_capture_entry> captured_tx_;
+    std::vector<Loconet_capture_entry> sent_;
+};
+
+
+/// Messages are equal in direction and bytes; times are not compared
+bool operator==(const Loconet_capture_entry& a, const Loconet_capture_entry& b);
+
+
+} // namespace mr_signals
+
+#endif /* TEST_LOCONET_REPLAY_H_ */
@@ -0,0 +1,167 @@
+/*
+ * loop_collection_tests.cpp
+ *
+ * Unit tests for the Loop_collection scheduler
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "loop_funcs.h"
+#include "arduino_mock.h"
+
+#include <string>
+
+
+namespace {
+
+/// Counts its runs, appends its name to a shared log and optionally uses time
+class Test_task : public Loop_interface {
+public:
+    Test_task(Loop_collection& collection, char name, uint16_t period_ms = 0, uint8_t priority = 0) :
+        Loop_interface(collection, period_ms, priority), name_(name), runs_(0), cost_us_(0), log_(nullptr) {}
+
+    void loop() override {
+        runs_++;
+        if(log_) {
+            *log_ += name_;
+        }
+        set_micros(micros() + cost_us_);
+    }
+
+    char name_;
+    int runs_;
+    unsigned long cost_us_;
+    std::string* log_;
+};
+
+}
+
+
+/*
+ * Tasks without a period run every pass; periodic tasks run once per period
+ * and count the periods they miss
+ */
+TEST(Loop_collection,Periods)
+{
+    init_millis();
+
+    Loop_collection collection(3);
+    Test_task every(collection, 'e');
+    Test_task fast(collection, 'f', 10);
+    Test_task slow(collection, 's', 50);
+
+    EXPECT_EQ(3,collection.count());
+
+    for(unsigned long time = 0; time < 100; time++) {
+        set_millis(time);
+        collection.execute();
+    }
+
+    EXPECT_EQ(100,every.runs_);
+    EXPECT_EQ(10,fast.runs_);
+    EXPECT_EQ(2,slow.runs_);
+    EXPECT_EQ(0,fast.get_overruns());
+
+    // Run late; the task runs once and does not try to catch up
+    set_millis(135);
+    collection.execute();
+    set_millis(136);
+    collection.execute();
+
+    EXPECT_EQ(11,fast.runs_);
+    EXPECT_EQ(1,fast.get_overruns());
+
+    set_millis(145);
+    collection.execute();
+    EXPECT_EQ(12,fast.runs_);
+
+    // The due times survive millis() wrapping
+    Loop_collection wrap_collection(1);
+    Test_task wrap(wrap_collection, 'w', 20);
+
+    set_millis(0xFFFFFFF0UL);
+    wrap_collection.execute();
+    set_millis(0xFFFFFFFFUL);
+    wrap_collection.execute();
+    set_millis(3);
+    wrap_collection.execute();
+    set_millis(4);
+    wrap_collection.execute();
+
+    EXPECT_EQ(2,wrap.runs_);
+}
+
+/*
+ * Due tasks run by priority, round-robin within a priority, and are left for
+ * the next pass once the time budget is used
+ */
+TEST(Loop_collection,PriorityAndBudget)
+{
+    init_millis();
+
+    std::string log;
+    Loop_collection collection(5, 1000);
+
+    // Attached out of priority order
+    Test_task low_a(collection, 'a', 10, 0);
+    Test_task high(collection, 'H', 10, 2);
+    Test_task low_b(collection, 'b', 10, 0);
+    Test_task low_c(collection, 'c', 10, 0);
+    Test_task every(collection, 'e');
+
+    for(Test_task* task : { &low_a, &high, &low_b, &low_c, &every }) {
+        task->log_ = &log;
+        task->cost_us_ = 400;
+    }
+
+    // Everything fits with no cost
+    for(Test_task* task : { &low_a, &high, &low_b, &low_c }) {
+        task->cost_us_ = 0;
+    }
+    collection.execute();
+    EXPECT_EQ("eHabc",log);
+    EXPECT_EQ(0,collection.get_budget_overruns());
+
+    // Each task uses 400us of the 1000us budget; the every pass task counts
+    for(Test_task* task : { &low_a, &high, &low_b, &low_c }) {
+        task->cost_us_ = 400;
+    }
+
+    log.clear();
+    set_millis(10);
+    collection.execute();
+    EXPECT_EQ("eHa",log);
+    EXPECT_EQ(1,collection.get_budget_overruns());
+
+    // The remaining due tasks run on the next passes, continuing the round-robin
+    log.clear();
+    set_millis(11);
+    collection.execute();
+    EXPECT_EQ("ebc",log);
+    EXPECT_EQ(1,collection.get_budget_overruns());
+
+    log.clear();
+    set_millis(12);
+    collection.execute();
+    EXPECT_EQ("e",log);
+
+    // The round-robin continues after the last task run
+    log.clear();
+    set_millis(20);
+    collection.execute();
+    EXPECT_EQ("eHa",log);
+
+    log.clear();
+    set_millis(21);
+    collection.execute();
+    EXPECT_EQ("ebc",log);
+
+    // At least one due task runs, however long the every pass tasks take
+    every.cost_us_ = 5000;
+    log.clear();
+    set_millis(30);
+    collection.execute();
+    EXPECT_EQ("eH",log);
+}
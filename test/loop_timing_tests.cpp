@@ -0,0 +1,255 @@
+/*
+ * loop_timing_tests.cpp
+ *
+ * Unit tests for Timing_stats and Loop_timing
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "loop_timing.h"
+#include "loop_funcs.h"
+#include "logic_collection.h"
+#include "logic_interface.h"
+#include "ryg_logic.h"
+#include "arduino_mock.h"
+
+#include <sstream>
+#include <string>
+
+using namespace mr_signals;
+
+
+namespace {
+
+/// Loop task taking a set time
+class Timed_task : public Loop_interface {
+public:
+    Timed_task(Loop_collection& collection, unsigned long cost_us) :
+        Loop_interface(collection), cost_us_(cost_us) {}
+
+    void loop() override { set_micros(micros() + cost_us_); }
+
+    unsigned long cost_us_;
+};
+
+/// Logic taking a set time
+class Timed_logic : public Logic_interface {
+public:
+    Timed_logic(Logic_collection& collection, unsigned long cost_us) :
+        Logic_interface(collection), cost_us_(cost_us) {}
+
+    void loop() override { set_micros(micros() + cost_us_); }
+
+    unsigned long cost_us_;
+};
+
+}
+
+
+TEST(Timing_stats,Statistics)
+{
+    Timing_stats stats;
+
+    EXPECT_EQ(0u,stats.count());
+    EXPECT_EQ(0u,stats.mean());
+
+    EXPECT_EQ(0,Timing_stats::bucket(0));
+    EXPECT_EQ(0,Timing_stats::bucket(1));
+    EXPECT_EQ(1,Timing_stats::bucket(2));
+    EXPECT_EQ(1,Timing_stats::bucket(3));
+    EXPECT_EQ(2,Timing_stats::bucket(4));
+    EXPECT_EQ(10,Timing_stats::bucket(2047));
+    EXPECT_EQ(Timing_stats::buckets - 1,Timing_stats::bucket(2048));
+    EXPECT_EQ(Timing_stats::buckets - 1,Timing_stats::bucket(UINT32_MAX));
+
+    stats.add(10);
+    stats.add(3);
+    stats.add(20);
+
+    EXPECT_EQ(3u,stats.count());
+    EXPECT_EQ(3u,stats.min());
+    EXPECT_EQ(20u,stats.max());
+    EXPECT_EQ(11u,stats.mean());
+    EXPECT_EQ(1,stats.histogram(1));
+    EXPECT_EQ(1,stats.histogram(3));
+    EXPECT_EQ(1,stats.histogram(4));
+    EXPECT_EQ(0,stats.histogram(Timing_stats::buckets));
+
+    // The mean survives the total overflowing
+    Timing_stats big;
+    for(int i = 0; i < 4; i++) {
+        big.add(2000000000UL);
+    }
+    EXPECT_EQ(2000000000UL,big.mean());
+    EXPECT_EQ(4u,big.histogram(Timing_stats::buckets - 1));
+
+    stats.reset();
+    EXPECT_EQ(0u,stats.count());
+    EXPECT_EQ(0u,stats.max());
+}
+
+/*
+ * Objects are reported slowest first, after the loop period and jitter
+ */
+TEST(Loop_timing,Report)
+{
+    Loop_timing::clear();
+    init_millis();
+
+    int objects[3];
+    EXPECT_EQ(0,Loop_timing::add(&objects[0], "fast"));
+    EXPECT_EQ(1,Loop_timing::add(&objects[1], "slow"));
+    EXPECT_EQ(2,Loop_timing::add(&objects[2], "mid"));
+
+    Loop_timing::record(0, 1);
+    Loop_timing::record(1, 100);
+    Loop_timing::record(1, 300);
+    Loop_timing::record(2, 50);
+    Loop_timing::record(Loop_timing::no_slot, 1000);
+
+    EXPECT_EQ(&objects[1],Loop_timing::get(1)->object);
+    EXPECT_EQ(200u,Loop_timing::get(1)->stats.mean());
+    EXPECT_EQ(nullptr,Loop_timing::get(3));
+
+    Timing_slot slots[2];
+    ASSERT_EQ(2,Loop_timing::top(slots, 2));
+    EXPECT_EQ(1,slots[0]);
+    EXPECT_EQ(2,slots[1]);
+
+    // Passes at 0, 1000, 1500 and 2500us
+    for(unsigned long time : { 0, 1000, 1500, 2500 }) {
+        set_micros(time);
+        Loop_timing::pass();
+    }
+
+    EXPECT_EQ(3u,Loop_timing::period().count());
+    EXPECT_EQ(500u,Loop_timing::period().min());
+    EXPECT_EQ(1000u,Loop_timing::period().max());
+    EXPECT_EQ(2u,Loop_timing::jitter().count());
+    EXPECT_EQ(500u,Loop_timing::jitter().max());
+
+    std::ostringstream out;
+    Loop_timing::report(out, 2);
+    EXPECT_EQ("Loop period us: n=3 min=500 mean=833 max=1000 hist=0,0,0,0,0,0,0,0,1,2,0,0\n"
+              "Loop jitter us: n=2 min=500 mean=500 max=500 hist=0,0,0,0,0,0,0,0,2,0,0,0\n"
+              "slow #1 us: n=2 min=100 mean=200 max=300 hist=0,0,0,0,0,0,1,0,1,0,0,0\n"
+              "mid #2 us: n=1 min=50 mean=50 max=50 hist=0,0,0,0,0,1,0,0,0,0,0,0\n",out.str());
+
+    // Reset keeps the objects
+    Loop_timing::reset();
+    EXPECT_EQ(3,Loop_timing::size());
+    EXPECT_EQ(0u,Loop_timing::get(1)->stats.count());
+    EXPECT_EQ(0u,Loop_timing::period().count());
+
+    // Objects beyond the capacity are not timed, but are counted and reported
+    Loop_timing::clear();
+    for(Timing_slot i = 0; i < Loop_timing::capacity; i++) {
+        EXPECT_EQ(i,Loop_timing::add(&objects[0], "fill"));
+    }
+    EXPECT_EQ(Loop_timing::no_slot,Loop_timing::add(&objects[0], "full"));
+    EXPECT_EQ(Loop_timing::no_slot,Loop_timing::add(&objects[1], "full"));
+    EXPECT_EQ(2u,Loop_timing::untimed());
+
+    std::ostringstream full;
+    Loop_timing::report(full, 0);
+    EXPECT_NE(std::string::npos, full.str().find("!!Not timed (MR_SIGNALS_LOOP_TIMING_ENTRIES full): 2 objects\n"));
+
+    Loop_timing::clear();
+    EXPECT_EQ(0u,Loop_timing::untimed());
+}
+
+/*
+ * An object with a name is reported with it
+ */
+TEST(Loop_timing,Names)
+{
+    Loop_timing::clear();
+
+    const char* name = "1213a";
+    Loop_timing::add(name, "named", [](const void* object) { return static_cast<const char*>(object); });
+    Loop_timing::add(name, "unnamed", [](const void*) -> const char* { return nullptr; });
+    Loop_timing::record(0, 20);
+    Loop_timing::record(1, 10);
+
+    std::ostringstream out;
+    Loop_timing::report(out, 2);
+    EXPECT_NE(std::string::npos, out.str().find("named #0 1213a us: n=1"));
+    EXPECT_NE(std::string::npos, out.str().find("unnamed #1 us: n=1"));
+
+    Loop_timing::clear();
+}
+
+#if MR_SIGNALS_LOOP_TIMING
+
+/*
+ * The collections time each of their objects, and Loop_collection the passes
+ */
+TEST(Loop_timing,Collections)
+{
+    Loop_timing::clear();
+    init_millis();
+
+    Loop_collection loop_collection(2);
+    Timed_task slow_task(loop_collection, 40);
+    Timed_task fast_task(loop_collection, 4);
+
+    Logic_collection logic_collection(2);
+    Timed_logic slow_logic(logic_collection, 300);
+    Timed_logic fast_logic(logic_collection, 2);
+
+    ASSERT_EQ(4,Loop_timing::size());
+
+    for(int pass = 0; pass < 3; pass++) {
+        loop_collection.execute();
+        logic_collection.loop();
+    }
+
+    EXPECT_EQ(&slow_task,Loop_timing::get(0)->object);
+    EXPECT_EQ(3u,Loop_timing::get(0)->stats.count());
+    EXPECT_EQ(40u,Loop_timing::get(0)->stats.mean());
+    EXPECT_EQ(300u,Loop_timing::get(2)->stats.max());
+
+    // Each pass takes 346us
+    EXPECT_EQ(2u,Loop_timing::period().count());
+    EXPECT_EQ(346u,Loop_timing::period().mean());
+    EXPECT_EQ(0u,Loop_timing::jitter().max());
+
+    // Change propagation reorders the logic, but not its timing slots
+    logic_collection.enable_change_propagation();
+    logic_collection.loop();
+    EXPECT_EQ(4u,Loop_timing::get(2)->stats.count());
+    EXPECT_EQ(300u,Loop_timing::get(2)->stats.min());
+
+    Timing_slot slots[2];
+    ASSERT_EQ(2,Loop_timing::top(slots, 2));
+    EXPECT_EQ(2,slots[0]);
+    EXPECT_EQ(0,slots[1]);
+
+    Loop_timing::clear();
+}
+
+/*
+ * Logic is reported with the name of the head it sets
+ */
+TEST(Loop_timing,LogicNames)
+{
+    Loop_timing::clear();
+    init_millis();
+
+    Logic_collection logic_collection(1);
+    Test_head head_1("1213a"), head_2;
+    Sensor_base block;
+    Simple_ryg_logic logic(logic_collection, head_1, head_2, {&block});
+
+    logic_collection.loop();
+
+    std::ostringstream out;
+    Loop_timing::report(out, 1);
+    EXPECT_NE(std::string::npos, out.str().find("logic #0 1213a us: n=1"));
+
+    Loop_timing::clear();
+}
+
+#endif
@@ -8,12 +8,19 @@
 
 #include <iostream>
 #include <cstring>
+#include <memory>
+#include <sstream>
+#include <vector>
 #include <stdio.h>
 //#include <limits>
 
 #include "mrrwa_loconet_adapter.h"
 #include "loconet_txmgr.h"
+#include "loconet_aimd_txmgr.h"
+#include "loconet_token_bucket_txmgr.h"
 #include "loconet_switch.h"
+#include "trace.h"
+#include "change_listener.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -229,9 +236,10 @@ TEST_F(MrrwaAdapter_test,MsgReceivedLoopTest)
 
     lnMsg msg;
 
-    // LocoNet::receive() will be called for each iteration of the cycle
+    // LocoNet::receive() will be called for each iteration of the cycle, and
+    // again in the cycle that receives a message to find there are no more
     // Set it up so that it only returns non-null once
-    EXPECT_CALL(loconet_mock,receive()).Times(cycles).WillOnce(Return(&msg)).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(loconet_mock,receive()).Times(cycles + 1).WillOnce(Return(&msg)).WillRepeatedly(Return(nullptr));
 
     // LocoNet::processSwitchSensorMessage() should only be called once (for the one case that receive() returns non-nullptr
     EXPECT_CALL(loconet_mock,processSwitchSensorMessage(_)).Times(1);
@@ -268,8 +276,9 @@ TEST_F(MrrwaAdapter_test,ReceivedDebugTest)
     msg.srp.chksum = 0x25 ;
 
 
-    // LocoNet::receive() will be called for each iteration of the cycle
-    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(&msg));
+    // One message is received in each loop
+    EXPECT_CALL(loconet_mock,receive()).WillOnce(Return(&msg)).WillOnce(Return(nullptr))
+                                       .WillOnce(Return(&msg)).WillRepeatedly(Return(nullptr));
 
     EXPECT_CALL(loconet_mock,processSwitchSensorMessage(_)).Times(2);
     ON_CALL(loconet_mock,processSwitchSensorMessage(_)).WillByDefault(testing::Invoke(procSwitchSensorMessage));
@@ -277,7 +286,8 @@ TEST_F(MrrwaAdapter_test,ReceivedDebugTest)
 
     std::cout << std::dec;
 
-    // Capture stdout to compare debug output
+    // Capture stdout to compare debug output, traced directly to Serial
+    Trace_ring::set_serial_fallback(true);
     testing::internal::CaptureStdout();
 
     // Run loop to iterate loconet adapter
@@ -297,6 +307,7 @@ TEST_F(MrrwaAdapter_test,ReceivedDebugTest)
 
 
     std::string output = testing::internal::GetCapturedStdout();
+    Trace_ring::set_serial_fallback(false);
     std::cout << "output = '" << output << "'" << std::endl;
 
     /*
@@ -313,6 +324,95 @@ TEST_F(MrrwaAdapter_test,ReceivedDebugTest)
 
 }
 
+/*
+ * Each loop() processes received packets until LocoNet has no more, up to
+ * MRRWA_LN_RX_MAX_PACKETS or MRRWA_LN_RX_BUDGET_US, handling each LONG_ACK,
+ * and counts the receive buffer as nearly full when the bytes received
+ * without it emptying reach MRRWA_LN_RX_NEAR_FULL
+ */
+TEST_F(MrrwaAdapter_test,RxDrainBudget)
+{
+    lnMsg msg;
+    msg.srp.command = 0xB2;
+    msg.srp.sn1 = 0x18;
+    msg.srp.sn2 = 0x70;
+    msg.srp.chksum = 0x25;
+
+    lnMsg long_ack;
+    long_ack.data[0] = OPC_LONG_ACK;
+    long_ack.data[1] = 0x30;
+    long_ack.data[2] = 0x00;
+    long_ack.data[3] = 0x7B;
+
+    int pending = 0;            // Packets waiting in the receive buffer
+    unsigned long packet_us = 0;  // Time taken to receive each packet
+
+    ON_CALL(loconet_mock,receive()).WillByDefault(testing::Invoke([&]() -> lnMsg* {
+        if(0 == pending) {
+            return nullptr;
+        }
+        set_micros(micros() + packet_us);
+        return (--pending == 1) ? &long_ack : &msg;
+    }));
+    EXPECT_CALL(loconet_mock,receive()).Times(testing::AnyNumber());
+    EXPECT_CALL(loconet_mock,processSwitchSensorMessage(_)).Times(testing::AnyNumber());
+
+    // Three packets are all processed in one loop
+    pending = 3;
+    loconet_adapter_->loop();
+    EXPECT_EQ(0,pending);
+    EXPECT_EQ(1u,loconet_adapter_->get_long_ack_count());
+    EXPECT_EQ(12u,loconet_adapter_->get_rx_backlog_high_watermark());
+
+    // A burst is drained MRRWA_LN_RX_MAX_PACKETS at a time
+    const int burst = 3 * MRRWA_LN_RX_MAX_PACKETS + 2;
+    pending = burst;
+    loconet_adapter_->loop();
+    EXPECT_EQ(burst - MRRWA_LN_RX_MAX_PACKETS,pending);
+    loconet_adapter_->loop();
+    EXPECT_EQ(burst - 2 * MRRWA_LN_RX_MAX_PACKETS,pending);
+    EXPECT_EQ(0u,loconet_adapter_->get_rx_near_full_count());
+
+    // The time budget ends the stage early, but at least one packet is processed
+    packet_us = MRRWA_LN_RX_BUDGET_US;
+    loconet_adapter_->loop();
+    EXPECT_EQ(burst - 2 * MRRWA_LN_RX_MAX_PACKETS - 1,pending);
+
+    packet_us = MRRWA_LN_RX_BUDGET_US / 2;
+    loconet_adapter_->loop();
+    EXPECT_EQ(burst - 2 * MRRWA_LN_RX_MAX_PACKETS - 3,pending);
+
+    // The buffer never emptied during the burst
+    EXPECT_EQ(4u * (burst - pending),loconet_adapter_->get_rx_backlog_high_watermark());
+
+    // A burst larger than the near full level is counted once
+    packet_us = 0;
+    pending += MRRWA_LN_RX_NEAR_FULL / 4;
+
+    std::ostringstream trace_text;
+    Trace_ring trace_ring;
+    Trace_ring::set_active(&trace_ring);
+
+    while(pending) {
+        loconet_adapter_->loop();
+    }
+
+    Trace_ring::set_active(nullptr);
+
+    EXPECT_EQ(1u,loconet_adapter_->get_rx_near_full_count());
+
+    trace_ring.drain(trace_text);
+    EXPECT_NE(std::string::npos,trace_text.str().find("!!LN RX buffer near full (120 bytes)\n"));
+
+    // Once caught up, the backlog starts again from empty
+    loconet_adapter_->loop();
+    pending = MRRWA_LN_RX_NEAR_FULL / 4;
+    while(pending) {
+        loconet_adapter_->loop();
+    }
+    EXPECT_EQ(2u,loconet_adapter_->get_rx_near_full_count());
+}
+
 /* Test attaching sensors and that they receive signals
  *
  * Attach 3 sensors to a Mrrwa_loconet_adapter instance that is dimensioned for only 2
@@ -345,8 +445,10 @@ TEST_F(MrrwaAdapter_test,AttachingSensors)
     lnMsg msg;
 
 
-    // Load up the mocks
-    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(&msg));
+    // Load up the mocks; one message is received in each loop
+    EXPECT_CALL(loconet_mock,receive()).WillOnce(Return(&msg)).WillOnce(Return(nullptr))
+                                       .WillOnce(Return(&msg)).WillOnce(Return(nullptr))
+                                       .WillOnce(Return(&msg)).WillRepeatedly(Return(nullptr));
     EXPECT_CALL(loconet_mock,processSwitchSensorMessage(_)).Times(3);
     ON_CALL(loconet_mock,processSwitchSensorMessage(_)).WillByDefault(testing::Invoke(procSwitchSensorMessage));
 
@@ -402,6 +504,49 @@ TEST_F(MrrwaAdapter_test,AttachingSensors)
     EXPECT_FALSE(sensor72.is_active());
 }
 
+/*
+ * Test that sensors attached in any address order are found by
+ * notify_sensors(), that only the first of two sensors with the same address
+ * is notified, and that addresses without a sensor are ignored
+ */
+TEST_F(MrrwaAdapter_test,SensorDispatch)
+{
+    SetupParams(0,100);
+
+    std::vector<std::unique_ptr<Loconet_sensor>> sensors;
+
+    // Addresses 1..97 in a scrambled order
+    for(Loconet_address i = 0; i < 97; i++) {
+        sensors.emplace_back(new Loconet_sensor("S", 1 + (i * 37) % 97, *loconet_adapter_));
+    }
+
+    Loconet_sensor duplicate("Dup", 50, *loconet_adapter_);
+    Loconet_sensor highest("High", 4095, *loconet_adapter_);
+
+    EXPECT_EQ(99u,loconet_adapter_->sensor_count());
+
+    for(auto& sensor : sensors) {
+        EXPECT_TRUE(sensor->is_indeterminate());
+        loconet_adapter_->notify_sensors(sensor->get_address(), true);
+        EXPECT_TRUE(sensor->is_active());
+    }
+
+    EXPECT_TRUE(duplicate.is_indeterminate());
+
+    loconet_adapter_->notify_sensors(4095, true);
+    EXPECT_TRUE(highest.is_active());
+
+    // No sensor at these addresses
+    loconet_adapter_->notify_sensors(0, false);
+    loconet_adapter_->notify_sensors(98, false);
+    loconet_adapter_->notify_sensors(4094, false);
+
+    for(auto& sensor : sensors) {
+        EXPECT_TRUE(sensor->is_active());
+    }
+    EXPECT_TRUE(highest.is_active());
+}
+
 /*
  * Test the sensor debug output of the MRRRWA adapter
  * Print the following states
@@ -463,16 +608,16 @@ TEST_F(MrrwaAdapter_test,TxLoopTest)
 
     Runtime_ms timestamp = 0;
 
-    // Try to queue 3 messages.  With a buffer of 8, only two 3-byte long
-    // messsages (OPC_SW_REQ is 4, the CRC is not stored) can be
+    // Try to queue 3 messages.  With a buffer of 8, only two 4-byte records
+    // (OPC_SW_REQ is 4, the CRC is not stored, plus a length byte) can be
     // enqueued
     EXPECT_EQ(0u,loconet_adapter_->get_buffer_high_watermark());
     EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,true));
-    EXPECT_EQ(3u,loconet_adapter_->get_buffer_high_watermark());
+    EXPECT_EQ(4u,loconet_adapter_->get_buffer_high_watermark());
     EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,false));
-    EXPECT_EQ(6u,loconet_adapter_->get_buffer_high_watermark());
-    EXPECT_FALSE(loconet_adapter_->send_opc_sw_req(0x123,false,true));
-    EXPECT_EQ(6u,loconet_adapter_->get_buffer_high_watermark());
+    EXPECT_EQ(8u,loconet_adapter_->get_buffer_high_watermark());
+    EXPECT_FALSE(loconet_adapter_->send_opc_sw_req(0x124,false,true));
+    EXPECT_EQ(8u,loconet_adapter_->get_buffer_high_watermark());
 
 
     // Expected bytes for send_opc_sw_req(0x123,true,true)
@@ -502,12 +647,240 @@ TEST_F(MrrwaAdapter_test,TxLoopTest)
     loconet_adapter_->loop(); // should not call send() as insufficient time has elapsed
 
     // High watermark should remain the same after all the dequeuing
-    EXPECT_EQ(6u,loconet_adapter_->get_buffer_high_watermark());
+    EXPECT_EQ(8u,loconet_adapter_->get_buffer_high_watermark());
 
     // With one transmit error
     EXPECT_EQ(1u,loconet_adapter_->get_tx_error_count());
 }
 
+/*
+ * Test the transmit queue telemetry: rejected queue attempts, the occupancy
+ * histogram and the time messages wait in the queue before transmission
+ */
+TEST_F(MrrwaAdapter_test,TxTelemetry)
+{
+    const std::size_t buffer_size = 8;
+
+    SetupParams(0,buffer_size);
+
+    const Mrrwa_loconet_tx_telemetry& telemetry = loconet_adapter_->get_tx_telemetry();
+
+    EXPECT_EQ(0u,telemetry.queued_count());
+    EXPECT_EQ(0u,telemetry.latency_max());
+
+    // Queue two messages at 10ms and 20ms; the third is rejected as the buffer is full
+    set_millis(10);
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,true));
+    set_millis(20);
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,false));
+    EXPECT_FALSE(loconet_adapter_->send_opc_sw_req(0x124,false,true));
+
+    EXPECT_EQ(2u,telemetry.queued_count());
+    EXPECT_EQ(1u,telemetry.rejected_count());
+
+    // Occupancy after each attempt was 4, 8 and 8 bytes
+    EXPECT_EQ(1u,telemetry.occupancy_histogram(Mrrwa_loconet_tx_telemetry::bin_of(4)));
+    EXPECT_EQ(2u,telemetry.occupancy_histogram(Mrrwa_loconet_tx_telemetry::bin_of(8)));
+    EXPECT_EQ(4u,Mrrwa_loconet_tx_telemetry::bin_lower_bound(Mrrwa_loconet_tx_telemetry::bin_of(4)));
+
+    // Transmit both messages
+    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(loconet_mock,send(_)).Times(2).WillRepeatedly(Return(LN_DONE));
+
+    Runtime_ms timestamp = Loconet_txmgr::slow_tx_delay_default;   // First transmission at 200ms
+
+    set_millis(timestamp);
+    loconet_adapter_->loop();
+
+    set_millis(timestamp * 2);                                      // Second at 400ms
+    loconet_adapter_->loop();
+
+    EXPECT_EQ(2u,telemetry.transmitted_count());
+
+#if MRRWA_LN_TX_LATENCY_TRACKING
+    EXPECT_EQ(190u,telemetry.latency_min());
+    EXPECT_EQ(380u,telemetry.latency_max());
+    EXPECT_EQ(285u,telemetry.latency_mean());
+
+    EXPECT_EQ(1u,telemetry.latency_histogram(Mrrwa_loconet_tx_telemetry::bin_of(190)));
+    EXPECT_EQ(1u,telemetry.latency_histogram(Mrrwa_loconet_tx_telemetry::bin_of(380)));
+#else
+    EXPECT_EQ(0u,telemetry.latency_max());
+    EXPECT_EQ(0u,telemetry.latency_mean());
+#endif
+}
+
+/*
+ * Test that the queue times of a lane emptied as corrupted are discarded, so
+ * that the next message queued is not timed from an older one
+ */
+TEST(MrrwaTxTelemetry,Flush)
+{
+    Mrrwa_loconet_tx_telemetry telemetry;
+
+    telemetry.record_queue(true, 4, 10);
+    telemetry.record_queue(true, 8, 20);
+    telemetry.record_queue(true, 4, 30, Switch_priority::urgent);
+
+    telemetry.record_flush();
+
+    telemetry.record_queue(true, 4, 500);
+    telemetry.record_dequeue();
+    telemetry.record_transmit(600);
+    telemetry.record_dequeue(Switch_priority::urgent);
+    telemetry.record_transmit(700);
+
+    EXPECT_EQ(2u,telemetry.transmitted_count());
+
+#if MRRWA_LN_TX_LATENCY_TRACKING
+    // The urgent lane was not flushed
+    EXPECT_EQ(100u,telemetry.latency_min());
+    EXPECT_EQ(670u,telemetry.latency_max());
+#endif
+}
+
+/*
+ * Test that messages queued behind MRRWA_LN_TX_LATENCY_MESSAGES timed
+ * messages are sent untimed, without the later messages taking their times,
+ * and that a retransmission is not counted again
+ */
+TEST(MrrwaTxTelemetry,UntimedMessages)
+{
+    Mrrwa_loconet_tx_telemetry telemetry;
+
+    const uint32_t extra = 3;
+    const uint32_t count = MRRWA_LN_TX_LATENCY_MESSAGES + extra;
+
+    for(uint32_t i = 0; i < count; i++) {
+        telemetry.record_queue(true, 4, 100);
+    }
+
+    // Space is freed for one timestamp, but the message is queued behind untimed ones
+    telemetry.record_dequeue();
+    telemetry.record_transmit(150);
+    telemetry.record_transmit(160);     // Retransmission
+    telemetry.record_queue(true, 4, 200);
+
+    for(uint32_t i = 1; i <= count; i++) {
+        telemetry.record_dequeue();
+        telemetry.record_transmit(1000);
+    }
+
+    EXPECT_EQ(count + 1,telemetry.transmitted_count());
+
+#if MRRWA_LN_TX_LATENCY_TRACKING
+    EXPECT_EQ((uint32_t)MRRWA_LN_TX_LATENCY_MESSAGES,telemetry.timed_count());
+    EXPECT_EQ(50u,telemetry.latency_min());
+    EXPECT_EQ(900u,telemetry.latency_max());
+
+    // With the lane empty, messages are timed again
+    telemetry.record_queue(true, 4, 2000);
+    telemetry.record_dequeue();
+    telemetry.record_transmit(2010);
+    EXPECT_EQ(MRRWA_LN_TX_LATENCY_MESSAGES + 1u,telemetry.timed_count());
+    EXPECT_EQ(10u,telemetry.latency_min());
+#endif
+}
+
+/*
+ * Test that urgent switch requests are transmitted ahead of queued bulk
+ * requests, and that a bulk request is sent after MRRWA_LN_TX_URGENT_BURST
+ * urgent requests so that the bulk lane is not starved
+ */
+TEST_F(MrrwaAdapter_test,TxPriorityLanes)
+{
+    SetupParams(0,100);
+
+    const Loconet_address bulk_count = 10;
+    const Loconet_address urgent_count = MRRWA_LN_TX_URGENT_BURST + 2;
+
+    for(Loconet_address address = 1; address <= bulk_count; address++) {
+        EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(address,true,true));
+    }
+
+    for(Loconet_address address = 101; address < 101 + urgent_count; address++) {
+        EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(address,true,true,Switch_priority::urgent));
+    }
+
+    EXPECT_EQ(4u * bulk_count,loconet_adapter_->get_buffer_high_watermark());
+    EXPECT_EQ(4u * urgent_count,loconet_adapter_->get_urgent_buffer_high_watermark());
+
+    // Record the address of each transmitted message
+    std::vector<Loconet_address> sent;
+
+    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(loconet_mock,send(_)).Times(bulk_count + urgent_count).WillRepeatedly(
+            testing::Invoke([&sent](lnMsg* msg) {
+                sent.push_back(msg->data[1] + 1);
+                return LN_DONE;
+            }));
+
+    Runtime_ms timestamp = 0;
+
+    for(int i = 0; i < bulk_count + urgent_count + 5; i++) {
+        timestamp += Loconet_txmgr::slow_tx_delay_default;
+        set_millis(timestamp);
+        loconet_adapter_->loop();
+    }
+
+    std::vector<Loconet_address> expected;
+
+    for(Loconet_address address = 101; address < 101 + MRRWA_LN_TX_URGENT_BURST; address++) {
+        expected.push_back(address);
+    }
+
+    expected.push_back(1);                                  // Starvation protection
+
+    for(Loconet_address address = 101 + MRRWA_LN_TX_URGENT_BURST; address < 101 + urgent_count; address++) {
+        expected.push_back(address);
+    }
+
+    for(Loconet_address address = 2; address <= bulk_count; address++) {
+        expected.push_back(address);
+    }
+
+    EXPECT_EQ(expected,sent);
+
+    EXPECT_EQ(bulk_count + urgent_count,loconet_adapter_->get_tx_telemetry().transmitted_count());
+}
+
+
+/*
+ * Test that an urgent request for an address with a bulk request queued
+ * supersedes it: the stale bulk direction is never sent after the urgent one
+ */
+TEST_F(MrrwaAdapter_test,TxPrioritySupersede)
+{
+    SetupParams(0,100);
+
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(5,true,true));
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(5,false,true,Switch_priority::urgent));
+
+    // Record the direction and output bits of each transmitted message
+    std::vector<uint8_t> sent;
+
+    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(loconet_mock,send(_)).WillRepeatedly(
+            testing::Invoke([&sent](lnMsg* msg) {
+                EXPECT_EQ(5u,msg->data[1] + 1u);
+                sent.push_back(msg->data[2]);
+                return LN_DONE;
+            }));
+
+    Runtime_ms timestamp = 0;
+
+    for(int i = 0; i < 5; i++) {
+        timestamp += Loconet_txmgr::slow_tx_delay_default;
+        set_millis(timestamp);
+        loconet_adapter_->loop();
+    }
+
+    const uint8_t closed_on = OPC_SW_REQ_DIR | OPC_SW_REQ_OUT;
+
+    EXPECT_EQ(std::vector<uint8_t>({ closed_on, closed_on }),sent);
+}
+
+
 /*
  * Test the Loconet_switch implementation
  *
@@ -603,6 +976,108 @@ TEST_F(MrrwaAdapter_test,LocoNetSwitchTest)
 
 }
 
+/// Adapter that passes requests to another, but has no timer service or
+/// sensor state store (as an adapter written before they were added)
+class Untimed_adapter : public Loconet_adapter_interface {
+public:
+    explicit Untimed_adapter(Loconet_adapter_interface& adapter) : adapter_(adapter), requests_(0) {}
+
+    void attach_sensor(Loconet_sensor* sensor) override { adapter_.attach_sensor(sensor); }
+
+    bool send_opc_sw_req(Loconet_address address, bool thrown, bool on, Switch_priority priority) override {
+        requests_++;
+        return adapter_.send_opc_sw_req(address, thrown, on, priority);
+    }
+
+    bool send_opc_gp_on() override { return adapter_.send_opc_gp_on(); }
+    bool insert_ln_tx_delay(uint8_t delay) override { return adapter_.insert_ln_tx_delay(delay); }
+    Runtime_ms get_time_ms() const override { return adapter_.get_time_ms(); }
+
+    std::size_t requests() const { return requests_; }
+
+private:
+    Loconet_adapter_interface& adapter_;
+    std::size_t requests_;
+};
+
+
+/*
+ * Test the Loconet_switch with an adapter that has no timer service
+ *
+ * The 'off' command is sent from the switch's loop() once the delay has
+ * passed, and a new request before then replaces the pending 'off'
+ */
+TEST_F(MrrwaAdapter_test,LocoNetSwitchNoTimerService)
+{
+    const std::size_t buffer_size = 8;
+    Runtime_ms timestamp = 0;
+
+    SetupParams(0,buffer_size);
+
+    Untimed_adapter untimed_adapter(*loconet_adapter_);
+
+    EXPECT_EQ(nullptr, untimed_adapter.get_timer_service());
+    EXPECT_EQ(nullptr, untimed_adapter.get_sensor_state_store());
+
+    Loconet_switch switch1(0x123,&untimed_adapter);
+
+
+    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(nullptr));
+
+
+    uint8_t thrown_on[3]  = { 0xB0, 0x22, 0x12 };   // OPC_SW_REQ Addr:0x123, thrown, on
+    uint8_t thrown_off[3] = { 0xB0, 0x22, 0x02 };   // OPC_SW_REQ Addr:0x123, thrown, off
+
+    {
+        testing::InSequence sequence;
+
+        // Two 'on' commands, then a single 'off' for the second
+        EXPECT_CALL(loconet_mock,send(test_3_byte_send(thrown_on))).Times(2).WillRepeatedly(Return(LN_DONE));
+        EXPECT_CALL(loconet_mock,send(test_3_byte_send(thrown_off))).Times(1).WillOnce(Return(LN_DONE));
+    }
+
+    timestamp = Loconet_txmgr::slow_tx_delay_default;
+    set_millis(timestamp);
+
+    EXPECT_TRUE(switch1.request_direction(Switch_direction::thrown));
+
+    switch1.loop();
+    loconet_adapter_->loop();
+
+    // Request again before the 'off' is due; the 'off' is moved to 60ms after this
+    timestamp += 40;
+    set_millis(timestamp);
+
+    EXPECT_TRUE(switch1.request_direction(Switch_direction::thrown));
+    switch1.loop();
+    loconet_adapter_->loop();
+
+    timestamp += 59;
+    set_millis(timestamp);      // Not yet time for the 'off'
+
+    switch1.loop();
+    EXPECT_EQ((std::size_t)2, untimed_adapter.requests());
+
+    timestamp ++;
+    set_millis(timestamp);
+
+    switch1.loop();             // Requests the 'off'
+    EXPECT_EQ((std::size_t)3, untimed_adapter.requests());
+
+    switch1.loop();             // Will not request it again
+    EXPECT_EQ((std::size_t)3, untimed_adapter.requests());
+
+    // Let the queued commands go out
+    for(int i = 0; i < 10; i++) {
+        timestamp += Loconet_txmgr::slow_tx_delay_default;
+        set_millis(timestamp);
+
+        switch1.loop();
+        loconet_adapter_->loop();
+    }
+}
+
+
 /////////////////////////// Mrrwa_loconet_tx_buffer tests ////////////////////
 
 
@@ -611,7 +1086,7 @@ TEST_F(MrrwaAdapter_test,LocoNetSwitchTest)
  */
 TEST(MrrwaTxBuffer,Enqueue)
 {
-    Mrrwa_loconet_tx_buffer tx_buffer;
+    Mrrwa_loconet_tx_buffer<MRRWA_LN_TX_BUFFER_CAPACITY> tx_buffer;
     lnMsg msg;
 
     const std::size_t buffer_size=5;
@@ -632,10 +1107,10 @@ TEST(MrrwaTxBuffer,Enqueue)
     EXPECT_FALSE(tx_buffer.queue_loconet_msg(msg));
 
 
-    EXPECT_EQ(buffer_size,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size,tx_buffer.get_free());
 
 
-    // Enqueue a valid 4 byte message (3 bytes are encoded); there should be space
+    // Enqueue a valid 4 byte message (3 bytes are encoded plus a length byte); there should be space
     msg.data[0] = OPC_SW_REQ;
     msg.data[1] = 12;
     msg.data[2] = 34;
@@ -643,7 +1118,8 @@ TEST(MrrwaTxBuffer,Enqueue)
 
     EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));
 
-    EXPECT_EQ(buffer_size-3,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size-4,tx_buffer.get_free());
+    EXPECT_EQ(1U,tx_buffer.msg_count());
 
 
     // Attempt to enqueue the same message; as the buffer is only 5 bytes this should fail
@@ -657,45 +1133,46 @@ TEST(MrrwaTxBuffer,Enqueue)
 
 TEST(MrrwaTxBuffer,Dequeue)
 {
-    Mrrwa_loconet_tx_buffer tx_buffer;
+    Mrrwa_loconet_tx_buffer<MRRWA_LN_TX_BUFFER_CAPACITY> tx_buffer;
     lnMsg msg1,msg2,msg3,read_msg;
 
-    const std::size_t buffer_size=8;
+    const std::size_t buffer_size=11;
 
     tx_buffer.initialize(buffer_size);
 
 
     EXPECT_FALSE(tx_buffer.dequeue_loconet_msg(read_msg));
-    EXPECT_EQ(buffer_size,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size,tx_buffer.get_free());
 
 
-    // Enqueue two valid 4 byte message (3 bytes are stored for each)
+    // Enqueue two valid 4 byte message (3 bytes plus a length byte are stored for each)
     msg1.data[0] = OPC_SW_REQ;
     msg1.data[1] = 12;
     msg1.data[2] = 34;
     EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg1));
-    EXPECT_EQ(buffer_size-3,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size-4,tx_buffer.get_free());
 
 
     msg2.data[0] = OPC_SW_REQ;
     msg2.data[1] = 56;
     msg2.data[2] = 78;
     EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg2));
-    EXPECT_EQ(buffer_size-6,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size-8,tx_buffer.get_free());
 
 
     // Should not be able to enque msg2 again; not enough space
     EXPECT_FALSE(tx_buffer.queue_loconet_msg(msg2));
-    EXPECT_EQ(buffer_size-6,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size-8,tx_buffer.get_free());
 
 
     // Enqueue a 2 byte message
     msg3.data[0] = OPC_GPON;
     msg3.data[1] = 90;
     EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg3));
-    EXPECT_EQ(buffer_size-8,tx_buffer.loconet_tx_buffer_.get_free());
-
+    EXPECT_EQ(buffer_size-11,tx_buffer.get_free());
 
+    EXPECT_EQ(3U,tx_buffer.msg_count());
+    EXPECT_EQ(buffer_size,tx_buffer.size());
 
 
 
@@ -704,7 +1181,7 @@ TEST(MrrwaTxBuffer,Dequeue)
     std::memset(&read_msg,0x00,sizeof(lnMsg));
 
     EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
-    EXPECT_EQ(buffer_size-5,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size-7,tx_buffer.get_free());
 
     EXPECT_EQ(0,std::memcmp(&read_msg,&msg1,3));
 
@@ -714,7 +1191,7 @@ TEST(MrrwaTxBuffer,Dequeue)
     std::memset(&read_msg,0x00,sizeof(lnMsg));
 
     EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
-    EXPECT_EQ(buffer_size-2,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size-3,tx_buffer.get_free());
 
     EXPECT_EQ(0,std::memcmp(&read_msg,&msg2,3));
 
@@ -724,9 +1201,208 @@ TEST(MrrwaTxBuffer,Dequeue)
     std::memset(&read_msg,0x00,sizeof(lnMsg));
 
     EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
-    EXPECT_EQ(buffer_size,tx_buffer.loconet_tx_buffer_.get_free());
+    EXPECT_EQ(buffer_size,tx_buffer.get_free());
 
     EXPECT_EQ(0,std::memcmp(&read_msg,&msg3,2));
+
+    EXPECT_EQ(0U,tx_buffer.msg_count());
+}
+
+
+/*
+ * Skip messages without reading them, and confirm that a corrupted record
+ * length empties the buffer rather than desynchronizing it
+ */
+TEST(MrrwaTxBuffer,SkipAndCorruption)
+{
+    Mrrwa_loconet_tx_buffer<MRRWA_LN_TX_BUFFER_CAPACITY> tx_buffer;
+    lnMsg msg,read_msg;
+
+    EXPECT_FALSE(tx_buffer.skip_loconet_msg());
+
+    msg.data[0] = OPC_SW_REQ;
+
+    for(uint8_t i=0; i < 3; i++) {
+        msg.data[1] = i;
+        msg.data[2] = 0;
+        EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));
+    }
+    EXPECT_EQ(3U,tx_buffer.msg_count());
+
+    // Skip the first, the second is then at the head
+    EXPECT_TRUE(tx_buffer.skip_loconet_msg());
+    EXPECT_EQ(2U,tx_buffer.msg_count());
+
+    EXPECT_TRUE(tx_buffer.peek_loconet_msg(read_msg));
+    EXPECT_EQ(1,read_msg.data[1]);
+
+
+    // Overwrite the length byte of the record at the head with an invalid value
+    std::size_t length = 0;
+    uint8_t* head = const_cast<uint8_t*>(tx_buffer.loconet_tx_buffer_.peek(length));
+    head[0] = 0xFF;
+
+    EXPECT_EQ(0U,tx_buffer.flush_count());
+    EXPECT_FALSE(tx_buffer.dequeue_loconet_msg(read_msg));
+    EXPECT_EQ(0U,tx_buffer.msg_count());
+    EXPECT_EQ(tx_buffer.max_size(),tx_buffer.get_free());
+    EXPECT_EQ(1U,tx_buffer.flush_count());
+
+    // The buffer is usable again
+    EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));
+    EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
+    EXPECT_EQ(0,std::memcmp(&read_msg,&msg,3));
+}
+
+
+/*
+ * Peek at the next message without dequeuing it, and confirm messages are
+ * read back intact when they straddle the end of the buffer storage
+ */
+TEST(MrrwaTxBuffer,PeekAndWrap)
+{
+    Mrrwa_loconet_tx_buffer<MRRWA_LN_TX_BUFFER_CAPACITY> tx_buffer;
+    lnMsg msg,read_msg;
+
+    EXPECT_FALSE(tx_buffer.peek_loconet_msg(read_msg));
+
+    // Offset the records by 3 bytes (a 2 byte message plus its length) so
+    // that the following 4 byte records do not align with the end of the storage
+    msg.data[0] = OPC_GPON;
+    msg.data[1] = 0;
+    EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));
+    EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
+
+    msg.data[0] = OPC_SW_REQ;
+
+    // Cycle enough 3-byte messages through the buffer that the stored
+    // messages straddle the end of the storage several times
+    for(std::size_t i=0; i < (MRRWA_LN_TX_BUFFER_CAPACITY * 2) / 4 + 1; i++) {
+
+        msg.data[1] = i & 0x7F;
+        msg.data[2] = (i >> 7) & 0x0F;
+
+        EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));
+
+        // Peeking does not remove the message
+        std::memset(&read_msg,0x00,sizeof(lnMsg));
+        EXPECT_TRUE(tx_buffer.peek_loconet_msg(read_msg));
+        EXPECT_EQ(0,std::memcmp(&read_msg,&msg,3));
+        EXPECT_EQ(tx_buffer.max_size()-4,tx_buffer.get_free());
+
+        std::memset(&read_msg,0x00,sizeof(lnMsg));
+        EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
+        EXPECT_EQ(0,std::memcmp(&read_msg,&msg,3));
+        EXPECT_EQ(tx_buffer.max_size(),tx_buffer.get_free());
+    }
+}
+
+/*
+ * Test that queued switch requests are updated in place by a newer request
+ * for the same address and on/off flag
+ */
+TEST(MrrwaTxBuffer,CoalesceSwReq)
+{
+    Mrrwa_loconet_tx_buffer<MRRWA_LN_TX_BUFFER_CAPACITY> tx_buffer;
+    lnMsg read_msg;
+
+    // Make a switch request: sw1 is the address, sw2 the direction and on/off flags
+    auto sw_req = [](uint8_t address, bool thrown, bool on) {
+        lnMsg msg;
+        msg.data[0] = OPC_SW_REQ;
+        msg.data[1] = address;
+        msg.data[2] = (thrown ? 0 : OPC_SW_REQ_DIR) | (on ? OPC_SW_REQ_OUT : 0);
+        return msg;
+    };
+
+    lnMsg msg = sw_req(5,true,true);
+
+    // Nothing to supersede
+    EXPECT_FALSE(tx_buffer.coalesce_sw_req(msg));
+    EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));
+
+    msg = sw_req(6,true,true);                      // Different address
+    EXPECT_FALSE(tx_buffer.coalesce_sw_req(msg));
+    EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));
+
+    msg = sw_req(5,true,false);                     // Different on/off flag
+    EXPECT_FALSE(tx_buffer.coalesce_sw_req(msg));
+    EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));
+
+    // Closed 'on' for address 5 replaces the thrown 'on', and 'off' replaces the 'off'
+    EXPECT_TRUE(tx_buffer.coalesce_sw_req(sw_req(5,false,true)));
+    EXPECT_TRUE(tx_buffer.coalesce_sw_req(sw_req(5,false,false)));
+
+    EXPECT_EQ(3U,tx_buffer.msg_count());
+
+    // A new 'on' after the 'off' means a later 'off' cannot replace the queued one
+    msg = sw_req(5,true,true);
+    EXPECT_TRUE(tx_buffer.coalesce_sw_req(msg));    // Replaces the first 'on'
+    EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
+    EXPECT_EQ(0,std::memcmp(&read_msg,&msg,3));
+
+    EXPECT_TRUE(tx_buffer.queue_loconet_msg(msg));  // 'on' now queued after the 'off'
+    EXPECT_FALSE(tx_buffer.coalesce_sw_req(sw_req(5,true,false)));
+
+    // Other messages are never coalesced
+    msg.data[0] = OPC_GPON;
+    EXPECT_FALSE(tx_buffer.coalesce_sw_req(msg));
+
+    // Queue is now 6 on, 5 closed off, 5 thrown on
+    EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
+    EXPECT_EQ(6,read_msg.data[1]);
+
+    msg = sw_req(5,false,false);
+    EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
+    EXPECT_EQ(0,std::memcmp(&read_msg,&msg,3));
+
+    EXPECT_TRUE(tx_buffer.dequeue_loconet_msg(read_msg));
+    EXPECT_EQ(OPC_SW_REQ_OUT,read_msg.data[2]);
+}
+
+/*
+ * Test that the adapter coalesces switch requests across the priority lanes,
+ * so that a stale direction is never sent after a newer one
+ */
+TEST_F(MrrwaAdapter_test,TxCoalescing)
+{
+    SetupParams(0,100);
+
+    // Startup: thrown 'on' for 0x123 and 0x124 in the bulk lane
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,true));
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x124,true,true));
+
+    // A bulk request replaces the queued one
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x124,false,true));
+    EXPECT_EQ(8u,loconet_adapter_->get_buffer_high_watermark());
+
+    // An urgent request updates the bulk request and is queued urgently
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,false,true,Switch_priority::urgent));
+    EXPECT_EQ(4u,loconet_adapter_->get_urgent_buffer_high_watermark());
+
+    // A bulk request after the urgent one updates both
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,true));
+    EXPECT_EQ(8u,loconet_adapter_->get_buffer_high_watermark());
+
+    const Mrrwa_loconet_tx_telemetry& telemetry = loconet_adapter_->get_tx_telemetry();
+    EXPECT_EQ(3u,telemetry.queued_count());
+    EXPECT_EQ(2u,telemetry.coalesced_count());
+
+    // 0x123 thrown (urgent), 0x123 thrown, 0x124 closed
+    uint8_t thrown_123[3] = { 0xB0, 0x22, 0x12 };
+    uint8_t closed_124[3] = { 0xB0, 0x23, 0x32 };
+
+    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(loconet_mock,send(test_3_byte_send(thrown_123))).Times(2).WillRepeatedly(Return(LN_DONE));
+    EXPECT_CALL(loconet_mock,send(test_3_byte_send(closed_124))).Times(1).WillOnce(Return(LN_DONE));
+
+    Runtime_ms timestamp = 0;
+
+    for(int i = 0; i < 5; i++) {
+        timestamp += Loconet_txmgr::slow_tx_delay_default;
+        set_millis(timestamp);
+        loconet_adapter_->loop();
+    }
 }
 
 TEST_F(MrrwaAdapter_test, BasicTest) {
@@ -746,6 +1422,125 @@ TEST_F(MrrwaAdapter_test, BasicTest) {
     EXPECT_FALSE(loconet_adapter_->any_sensor_indeterminate());
 }
 
+#if MR_SIGNALS_SENSOR_STORE
+/*
+ * Test that Loconet sensors hold their state in the adapter's state store,
+ * and hold their own state once it is full
+ */
+TEST_F(MrrwaAdapter_test, SensorStateStore) {
+
+    Sensor_state_store* store = loconet_adapter_->get_sensor_state_store();
+    ASSERT_NE(nullptr,store);
+
+    Loconet_sensor sensor1("Sen1",50,*loconet_adapter_);
+    Loconet_sensor sensor2("Sen2",51,*loconet_adapter_);
+
+    EXPECT_EQ(0u,sensor1.get_slot());
+    EXPECT_EQ(1u,sensor2.get_slot());
+    EXPECT_EQ(2u,store->indeterminate_count());
+
+    loconet_adapter_->notify_sensors(51, true);
+    EXPECT_TRUE(sensor2.is_active());
+    EXPECT_TRUE(store->is_active(sensor2.get_slot()));
+    EXPECT_EQ(1u,store->indeterminate_count());
+
+    Sensor_set set;
+    set.add(sensor1.get_slot());
+    set.add(sensor2.get_slot());
+    EXPECT_TRUE(store->any_active(set));
+    EXPECT_TRUE(store->any_indeterminate(set));
+
+    // Fill the store; the next sensor holds its own state
+    std::vector<std::unique_ptr<Loconet_sensor>> sensors;
+    while(store->size() < Sensor_state_store::capacity) {
+        sensors.emplace_back(new Loconet_sensor("S", 100 + store->size(), *loconet_adapter_));
+        sensors.back()->set_state(false);
+    }
+
+    Loconet_sensor overflow("Over",10,*loconet_adapter_);
+    EXPECT_EQ(Sensor_state_store::no_slot,overflow.get_slot());
+    EXPECT_TRUE(overflow.is_indeterminate());
+
+    sensor1.set_state(false);
+    EXPECT_EQ(0u,store->indeterminate_count());
+    EXPECT_TRUE(loconet_adapter_->any_sensor_indeterminate());
+
+    loconet_adapter_->notify_sensors(10, true);
+    EXPECT_TRUE(overflow.is_active());
+    EXPECT_FALSE(loconet_adapter_->any_sensor_indeterminate());
+}
+
+/*
+ * Test that the sensors of two adapters each use their own adapter's store
+ */
+TEST_F(MrrwaAdapter_test, SensorStatePerAdapter) {
+
+    Loconet_sensor sensor1("Sen1",50,*loconet_adapter_);
+
+    Loconet_txmgr tx_mgr;
+    Mrrwa_loconet_adapter adapter2(*setup_coll_, *loop_coll_, loconet_mock, tx_pin, 0, 100, tx_mgr);
+
+    Loconet_sensor sensor2("Sen2",50,adapter2);
+
+    EXPECT_EQ(0u,sensor1.get_slot());
+    EXPECT_EQ(0u,sensor2.get_slot());
+
+    adapter2.notify_sensors(50, true);
+    EXPECT_TRUE(sensor2.is_active());
+    EXPECT_TRUE(sensor1.is_indeterminate());
+    EXPECT_TRUE(loconet_adapter_->any_sensor_indeterminate());
+    EXPECT_FALSE(adapter2.any_sensor_indeterminate());
+
+    loconet_adapter_->notify_sensors(50, false);
+    EXPECT_FALSE(sensor1.is_active());
+    EXPECT_TRUE(sensor2.is_active());
+}
+#endif
+
+namespace {
+
+/// Records the last change reported
+class Last_change : public Change_listener {
+public:
+    void changed(const void* source) override { source_ = source; count_++; }
+
+    const void* source_ = nullptr;
+    int count_ = 0;
+};
+
+}
+
+/*
+ * Setting a Loconet sensor's state through a Sensor_base& writes the store
+ * (with MR_SIGNALS_SENSOR_STORE) and reports the change, as set_state() is
+ * virtual
+ */
+TEST_F(MrrwaAdapter_test, SensorStateThroughBase) {
+
+    Loconet_sensor sensor("Sen1",50,*loconet_adapter_);
+#if MR_SIGNALS_SENSOR_STORE
+    ASSERT_NE(Sensor_state_store::no_slot,sensor.get_slot());
+#endif
+
+    Last_change listener;
+    Change_listener::set_listener(&listener);
+
+    Sensor_base& base = sensor;
+
+    EXPECT_TRUE(base.set_state(true));
+    EXPECT_TRUE(sensor.is_active());
+    EXPECT_FALSE(sensor.is_indeterminate());
+#if MR_SIGNALS_SENSOR_STORE
+    EXPECT_TRUE(loconet_adapter_->get_sensor_state_store()->is_active(sensor.get_slot()));
+#endif
+    EXPECT_EQ(static_cast<const Sensor_interface*>(&sensor), listener.source_);
+
+    EXPECT_FALSE(base.set_state(true));     // No change, not reported
+    EXPECT_EQ(1, listener.count_);
+
+    Change_listener::set_listener(nullptr);
+}
+
 TEST_F(Loconet_txmgr_test,Basic_Timing) {
 
     Runtime_ms last_tx_time=0;
@@ -826,3 +1621,423 @@ TEST_F(Loconet_txmgr_test,Retransmission_Limit) {
     }
 }
 
+
+
+/*
+ * Test that the AIMD manager starts at its slowest rate, doubles the rate
+ * every clean window until the fastest rate ends slow start, and spaces
+ * messages from the time they were transmitted
+ */
+TEST(Loconet_aimd_txmgr_test,SlowStart) {
+
+    // 10-200ms delays (100-5 messages/s), window of 4, +1 message/s, 3 retransmits
+    Loconet_aimd_txmgr tx_mgr(10, 200, 4, 1, 3);
+
+    EXPECT_TRUE(tx_mgr.is_slow_start());
+    EXPECT_EQ(5u,tx_mgr.get_rate());
+    EXPECT_EQ(200u,tx_mgr.get_tx_delay());
+
+    Runtime_ms time_ms = 1000;
+
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms));
+    tx_mgr.set_transmitted(time_ms);
+
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms + 199));
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms + 200));
+
+    // Idle time does not build up transmit opportunities
+    time_ms += 5000;
+    tx_mgr.set_transmitted(time_ms);
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms + 199));
+
+    // Rate doubles every 4 messages: 5 -> 10 -> 20 -> 40 -> 80 -> 100 (limited)
+    tx_mgr.set_transmitted(time_ms);
+    tx_mgr.set_transmitted(time_ms);
+    EXPECT_EQ(10u,tx_mgr.get_rate());
+
+    const uint16_t expected_rates[] = { 20, 40, 80, 100 };
+
+    for(uint16_t expected_rate : expected_rates) {
+        EXPECT_TRUE(tx_mgr.is_slow_start());
+
+        for(int i = 0; i < 4; i++) {
+            time_ms += tx_mgr.get_tx_delay();
+            EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms));
+            tx_mgr.set_transmitted(time_ms);
+        }
+
+        EXPECT_EQ(expected_rate,tx_mgr.get_rate());
+    }
+
+    EXPECT_FALSE(tx_mgr.is_slow_start());
+    EXPECT_EQ(10u,tx_mgr.get_tx_delay());
+
+    // Slow start can be restarted
+    tx_mgr.set_slow_duration(time_ms);
+    EXPECT_TRUE(tx_mgr.is_slow_start());
+    EXPECT_EQ(5u,tx_mgr.get_rate());
+}
+
+/*
+ * Test the multiplicative decrease on a retransmit request, the additive
+ * increase that follows, and the retransmission limit
+ */
+TEST(Loconet_aimd_txmgr_test,Backoff) {
+
+    Loconet_aimd_txmgr tx_mgr(10, 200, 4, 1, 3);
+
+    Runtime_ms time_ms = 0;
+
+    // Ramp up to 40 messages/s
+    for(int i = 0; i < 12; i++) {
+        time_ms += tx_mgr.get_tx_delay();
+        tx_mgr.set_transmitted(time_ms);
+    }
+    EXPECT_EQ(40u,tx_mgr.get_rate());
+
+    // LONG_ACK halves the rate, ends slow start and spaces the retransmission
+    tx_mgr.set_retransmit();
+    EXPECT_FALSE(tx_mgr.is_slow_start());
+    EXPECT_EQ(20u,tx_mgr.get_rate());
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms + 49));
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms + 50));
+    EXPECT_TRUE(tx_mgr.is_retransmission());
+    EXPECT_FALSE(tx_mgr.is_retransmission());
+
+    // Additive increase of 1 message/s per clean window of 4
+    for(int i = 0; i < 8; i++) {
+        time_ms += tx_mgr.get_tx_delay();
+        tx_mgr.set_transmitted(time_ms);
+    }
+    EXPECT_EQ(22u,tx_mgr.get_rate());
+
+    // Repeated back offs stop at the slowest rate, and retransmissions are limited
+    for(int i = 0; i < Loconet_aimd_txmgr::retransmit_limit_default; i++) {
+        tx_mgr.set_retransmit();
+        EXPECT_TRUE(tx_mgr.is_retransmission());
+    }
+
+    tx_mgr.set_retransmit();
+    EXPECT_FALSE(tx_mgr.is_retransmission());
+
+    EXPECT_EQ(5u,tx_mgr.get_rate());
+    EXPECT_EQ(200u,tx_mgr.get_tx_delay());
+}
+
+
+/*
+ * Test that the token bucket manager sends a burst back-to-back after idle,
+ * then limits sustained traffic to one message per interval
+ */
+TEST(Loconet_token_bucket_txmgr_test,Burst) {
+
+    // 20ms interval, burst of 4, 200ms slow delay for 1000ms, 3 retransmits
+    Loconet_token_bucket_txmgr tx_mgr(20, 4, 200, 1000, 3);
+
+    Runtime_ms time_ms = 5000;
+
+    // Bucket starts full; loops with nothing sent do not use tokens
+    for(int i = 0; i < 10; i++) {
+        EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms));
+    }
+
+    for(int i = 0; i < 4; i++) {
+        EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms));
+        tx_mgr.set_transmitted(time_ms);
+    }
+
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms));
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms + 19));
+
+    // Sustained rate of one per 20ms
+    for(int i = 0; i < 10; i++) {
+        time_ms += 20;
+        EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms));
+        tx_mgr.set_transmitted(time_ms);
+        EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms));
+    }
+
+    // Idle refills the bucket, but no further than the burst depth
+    time_ms += 10000;
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms));
+    EXPECT_EQ(4u,tx_mgr.get_tokens());
+}
+
+/*
+ * Test the slow period, the delay after a retransmit request and the
+ * retransmission limit
+ */
+TEST(Loconet_token_bucket_txmgr_test,SlowAndRetransmit) {
+
+    Loconet_token_bucket_txmgr tx_mgr(20, 4, 200, 1000, 3);
+
+    tx_mgr.set_slow_duration(0);
+
+    // One message per 200ms while slow
+    Runtime_ms time_ms = 100;
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms));
+    tx_mgr.set_transmitted(time_ms);
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms + 199));
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms + 200));
+
+    // A retransmit request while slow is allowed at the end of its delay
+    time_ms += 200;
+    tx_mgr.set_transmitted(time_ms);
+    tx_mgr.set_retransmit();
+
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms + 199));
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms + 200));
+
+    // After the slow period, bursts are allowed again
+    time_ms = 2000;
+    for(int i = 0; i < 4; i++) {
+        EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms));
+        tx_mgr.set_transmitted(time_ms);
+    }
+
+    // A retransmit request holds transmission for the slow delay, with no burst after it
+    time_ms += 1000;
+    tx_mgr.set_transmitted(time_ms);
+    tx_mgr.set_retransmit();
+
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms + 199));
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms + 200));
+    EXPECT_EQ(1u,tx_mgr.get_tokens());
+    tx_mgr.set_transmitted(time_ms + 200);
+    EXPECT_FALSE(tx_mgr.is_tx_allowed(time_ms + 219));
+    EXPECT_TRUE(tx_mgr.is_tx_allowed(time_ms + 220));
+
+    // Retransmissions are limited as for Loconet_txmgr
+    for(int i = 0; i < Loconet_token_bucket_txmgr::retransmit_limit_default; i++) {
+        tx_mgr.set_retransmit();
+        EXPECT_TRUE(tx_mgr.is_retransmission());
+    }
+
+    tx_mgr.set_retransmit();
+    EXPECT_FALSE(tx_mgr.is_retransmission());
+}
+
+
+/*
+ * Test that backoff and busy results from LocoNet are retried quickly without
+ * the transmission manager's delay or retransmit limit, and that collisions
+ * are retried after the slow delay
+ */
+TEST_F(MrrwaAdapter_test,TxStatusRetry)
+{
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,true));
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x124,true,true));
+
+    uint8_t first_bytes[3] = { 0xB0, 0x22, 0x12 };
+    uint8_t second_bytes[3] = { 0xB0, 0x23, 0x12 };
+
+    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(nullptr));
+
+    // More backoffs than the retransmit limit, then success
+    EXPECT_CALL(loconet_mock,send(test_3_byte_send(first_bytes))).Times(6)
+        .WillOnce(Return(LN_CD_BACKOFF))
+        .WillOnce(Return(LN_PRIO_BACKOFF))
+        .WillOnce(Return(LN_NETWORK_BUSY))
+        .WillOnce(Return(LN_CD_BACKOFF))
+        .WillOnce(Return(LN_CD_BACKOFF))
+        .WillOnce(Return(LN_DONE));
+
+    Runtime_ms timestamp = Loconet_txmgr::slow_tx_delay_default;
+
+    for(int i = 0; i < 6; i++) {
+        set_millis(timestamp);
+        loconet_adapter_->loop();
+
+        // Not before the fast retry delay
+        set_millis(timestamp + MRRWA_LN_TX_FAST_RETRY_MS - 1);
+        loconet_adapter_->loop();
+
+        timestamp += MRRWA_LN_TX_FAST_RETRY_MS;
+    }
+
+    EXPECT_EQ(0u,loconet_adapter_->get_tx_error_count());
+    EXPECT_EQ(3u,loconet_adapter_->get_tx_status_count(LN_CD_BACKOFF));
+    EXPECT_EQ(1u,loconet_adapter_->get_tx_status_count(LN_PRIO_BACKOFF));
+    EXPECT_EQ(1u,loconet_adapter_->get_tx_status_count(LN_NETWORK_BUSY));
+    EXPECT_EQ(1u,loconet_adapter_->get_tx_status_count(LN_DONE));
+
+    // A collision is retransmitted after the slow delay
+    EXPECT_CALL(loconet_mock,send(test_3_byte_send(second_bytes))).Times(2)
+        .WillOnce(Return(LN_COLLISION))
+        .WillOnce(Return(LN_DONE));
+
+    timestamp = Loconet_txmgr::slow_tx_delay_default * 2;
+    set_millis(timestamp);
+    loconet_adapter_->loop();
+
+    EXPECT_EQ(1u,loconet_adapter_->get_tx_error_count());
+    EXPECT_EQ(1u,loconet_adapter_->get_tx_status_count(LN_COLLISION));
+
+    set_millis(timestamp + MRRWA_LN_TX_FAST_RETRY_MS);
+    loconet_adapter_->loop();   // No fast retry
+
+    set_millis(timestamp + Loconet_txmgr::slow_tx_delay_default * 2);
+    loconet_adapter_->loop();
+
+    EXPECT_EQ(2u,loconet_adapter_->get_tx_status_count(LN_DONE));
+}
+
+/*
+ * Test that a LONG_ACK received while the next message waits for a fast retry
+ * retransmits the rejected message, not the waiting one, and that the waiting
+ * message is sent after it.  A token bucket sends messages closely enough for
+ * this to happen at startup.
+ */
+TEST_F(MrrwaAdapter_test,TxLongAckDuringFastRetry)
+{
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,true));
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x124,true,true));
+
+    uint8_t first_bytes[3] = { 0xB0, 0x22, 0x12 };
+    uint8_t second_bytes[3] = { 0xB0, 0x23, 0x12 };
+
+    lnMsg long_ack;
+    long_ack.data[0] = OPC_LONG_ACK;
+    long_ack.data[1] = 0x30;
+    long_ack.data[2] = 0x00;
+    long_ack.data[3] = 0x7B;
+
+    bool ack_pending = false;
+    ON_CALL(loconet_mock,receive()).WillByDefault(testing::Invoke([&]() -> lnMsg* {
+        bool ack = ack_pending;
+        ack_pending = false;
+        return ack ? &long_ack : nullptr;
+    }));
+    EXPECT_CALL(loconet_mock,receive()).Times(testing::AnyNumber());
+    EXPECT_CALL(loconet_mock,processSwitchSensorMessage(_)).Times(testing::AnyNumber());
+
+    {
+        testing::InSequence sequence;
+
+        EXPECT_CALL(loconet_mock,send(test_3_byte_send(first_bytes))).WillOnce(Return(LN_DONE));
+        EXPECT_CALL(loconet_mock,send(test_3_byte_send(second_bytes))).WillOnce(Return(LN_NETWORK_BUSY));
+        EXPECT_CALL(loconet_mock,send(test_3_byte_send(first_bytes))).WillOnce(Return(LN_DONE));
+        EXPECT_CALL(loconet_mock,send(test_3_byte_send(second_bytes))).WillOnce(Return(LN_DONE));
+    }
+
+    Runtime_ms timestamp = Loconet_txmgr::slow_tx_delay_default;
+
+    set_millis(timestamp);
+    loconet_adapter_->loop();           // First sent
+
+    timestamp *= 2;
+    set_millis(timestamp);
+    loconet_adapter_->loop();           // Second finds the bus busy, and waits for a fast retry
+
+    // The command station's LONG_ACK for the first arrives before the fast retry
+    ack_pending = true;
+    set_millis(timestamp + 1);
+    loconet_adapter_->loop();
+    EXPECT_EQ(1u,loconet_adapter_->get_long_ack_count());
+
+    // No fast retry of the second; the first is retransmitted after the slow delay
+    set_millis(timestamp + MRRWA_LN_TX_FAST_RETRY_MS);
+    loconet_adapter_->loop();
+
+    for(int i = 0; i < 4; i++) {
+        timestamp += Loconet_txmgr::slow_tx_delay_default;
+        set_millis(timestamp);
+        loconet_adapter_->loop();
+    }
+
+    EXPECT_EQ(3u,loconet_adapter_->get_tx_status_count(LN_DONE));
+    EXPECT_EQ(2u,loconet_adapter_->get_tx_telemetry().transmitted_count());
+}
+
+/*
+ * Test that a bus that stays busy is treated as a transmit error after the
+ * fast retry limit
+ */
+TEST_F(MrrwaAdapter_test,TxFastRetryLimit)
+{
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,true));
+
+    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(loconet_mock,send(_)).Times(MRRWA_LN_TX_FAST_RETRY_LIMIT + 1)
+        .WillRepeatedly(Return(LN_NETWORK_BUSY));
+
+    Runtime_ms timestamp = Loconet_txmgr::slow_tx_delay_default;
+
+    for(int i = 0; i <= MRRWA_LN_TX_FAST_RETRY_LIMIT; i++) {
+        set_millis(timestamp);
+        loconet_adapter_->loop();
+        timestamp += MRRWA_LN_TX_FAST_RETRY_MS;
+    }
+
+    EXPECT_EQ(1u,loconet_adapter_->get_tx_error_count());
+    EXPECT_EQ(MRRWA_LN_TX_FAST_RETRY_LIMIT + 1u,loconet_adapter_->get_tx_status_count(LN_NETWORK_BUSY));
+
+    // The retransmission waits for the transmission manager
+    set_millis(timestamp);
+    loconet_adapter_->loop();
+}
+
+/*
+ * Test that a message's queue time runs until its send completes, including
+ * a fast retry, and that it is not counted again when retransmitted
+ */
+TEST_F(MrrwaAdapter_test,TxLatencyIncludesRetry)
+{
+    set_millis(10);
+    EXPECT_TRUE(loconet_adapter_->send_opc_sw_req(0x123,true,true));
+
+    EXPECT_CALL(loconet_mock,receive()).WillRepeatedly(Return(nullptr));
+    EXPECT_CALL(loconet_mock,send(_)).WillOnce(Return(LN_CD_BACKOFF)).WillRepeatedly(Return(LN_DONE));
+
+    const Mrrwa_loconet_tx_telemetry& telemetry = loconet_adapter_->get_tx_telemetry();
+
+    Runtime_ms timestamp = Loconet_txmgr::slow_tx_delay_default;
+
+    set_millis(timestamp);
+    loconet_adapter_->loop();
+    EXPECT_EQ(0u,telemetry.transmitted_count());
+
+    timestamp += MRRWA_LN_TX_FAST_RETRY_MS;
+    set_millis(timestamp);
+    loconet_adapter_->loop();
+    EXPECT_EQ(1u,telemetry.transmitted_count());
+
+#if MRRWA_LN_TX_LATENCY_TRACKING
+    EXPECT_EQ(timestamp - 10,telemetry.latency_max());
+#endif
+
+    // A LONG_ACK retransmission sends the message again without counting it
+    tx_mgr_->set_retransmit();
+    set_millis(timestamp * 2);
+    loconet_adapter_->loop();
+    EXPECT_EQ(1u,telemetry.transmitted_count());
+}
+
+/*
+ * Test that a tx buffer size outside MRRWA_LN_TX_BUFFER_CAPACITY is reported
+ * as a configuration error and traced instead of being silently changed
+ */
+TEST_F(MrrwaAdapter_test,TxBufferSizeConfigError)
+{
+    EXPECT_EQ(0u,loconet_adapter_->get_config_error_count());
+    EXPECT_EQ(100u,loconet_adapter_->get_buffer_size());
+
+    std::ostringstream trace_text;
+    Trace_ring trace_ring;
+    Trace_ring::set_active(&trace_ring);
+
+    SetupParams(0,MRRWA_LN_TX_BUFFER_CAPACITY + 88);
+
+    Trace_ring::set_active(nullptr);
+
+    EXPECT_EQ(1u,loconet_adapter_->get_config_error_count());
+    EXPECT_EQ((size_t)MRRWA_LN_TX_BUFFER_CAPACITY,loconet_adapter_->get_buffer_size());
+
+    trace_ring.drain(trace_text);
+
+    std::ostringstream expected;
+    expected << "!!LN TX buffer size " << MRRWA_LN_TX_BUFFER_CAPACITY + 88
+             << " not usable; using MRRWA_LN_TX_BUFFER_CAPACITY ("
+             << MRRWA_LN_TX_BUFFER_CAPACITY << " bytes)\n";
+    EXPECT_NE(std::string::npos,trace_text.str().find(expected.str()));
+}
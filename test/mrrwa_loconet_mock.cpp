@@ -7,6 +7,8 @@
 
 #include "mrrwa_loconet_mock.h"
 
+extern void notifySensor(uint16_t , uint8_t );
+
 
 /* Copied from MRRWA Loconet library; used by Loconet Adapter */
 uint8_t getLnMsgSize( volatile lnMsg * Msg )
@@ -18,5 +20,19 @@ uint8_t getLnMsgSize( volatile lnMsg * Msg )
     return ( ( Msg->sz.command & (uint8_t)0x60 ) == (uint8_t)0x60 ) ? Msg->sz.mesg_size : ( ( Msg->sz.command & (uint8_t)0x60 ) >> (uint8_t)4 ) + 2 ;
 }
 
+/* As MRRWA LocoNetClass::processSwitchSensorMessage() for sensor reports */
+uint8_t process_sensor_message( lnMsg * Msg )
+{
+    if(OPC_INPUT_REP != Msg->data[0]) {
+        return 0;
+    }
+
+    uint16_t address = Msg->ir.in1 | ((Msg->ir.in2 & 0x0F) << 7);
 
+    address <<= 1;
+    address += (Msg->ir.in2 & OPC_INPUT_REP_SW) ? 2 : 1;
 
+    notifySensor(address, Msg->ir.in2 & OPC_INPUT_REP_HI);
+
+    return 1;
+}
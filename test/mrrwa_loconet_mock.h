@@ -98,6 +98,12 @@ typedef union
 
 uint8_t getLnMsgSize( volatile lnMsg * Msg );
 
+/*
+ * Decodes an OPC_INPUT_REP and calls notifySensor() as MRRWA's
+ * processSwitchSensorMessage() does, for LocoNetClass implementations on the host
+ */
+uint8_t process_sensor_message( lnMsg * Msg );
+
 
 /*
  * class LocoNetClass
@@ -0,0 +1,117 @@
+/*
+ * sensor_state_store_tests.cpp
+ *
+ * Unit tests for Sensor_state_store and Sensor_set
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "sensor_state_store.h"
+
+using namespace mr_signals;
+
+
+/*
+ * Slots start indeterminate, and the running count of indeterminate slots
+ * follows the first set_state() of each
+ */
+TEST(SensorStateStore,States)
+{
+    Sensor_state_store store;
+
+    EXPECT_EQ(0u,store.size());
+    EXPECT_EQ(0u,store.indeterminate_count());
+
+    Sensor_slot slot_1 = store.add();
+    Sensor_slot slot_2 = store.add();
+
+    EXPECT_EQ(0u,slot_1);
+    EXPECT_EQ(1u,slot_2);
+    EXPECT_EQ(2u,store.indeterminate_count());
+    EXPECT_TRUE(store.is_indeterminate(slot_1));
+    EXPECT_FALSE(store.is_active(slot_1));
+
+    EXPECT_TRUE(store.set_state(slot_1, false));     // Changed from indeterminate
+    EXPECT_FALSE(store.set_state(slot_1, false));
+    EXPECT_EQ(1u,store.indeterminate_count());
+    EXPECT_FALSE(store.is_indeterminate(slot_1));
+    EXPECT_FALSE(store.is_active(slot_1));
+
+    EXPECT_TRUE(store.set_state(slot_1, true));
+    EXPECT_TRUE(store.is_active(slot_1));
+    EXPECT_TRUE(store.is_indeterminate(slot_2));
+
+    EXPECT_TRUE(store.set_state(slot_2, true));
+    EXPECT_EQ(0u,store.indeterminate_count());
+
+    EXPECT_TRUE(store.set_state(slot_2, false));
+    EXPECT_EQ(0u,store.indeterminate_count());
+
+    // Slots not allocated are never known
+    EXPECT_FALSE(store.set_state(5, true));
+    EXPECT_TRUE(store.is_indeterminate(5));
+    EXPECT_FALSE(store.is_active(5));
+}
+
+/*
+ * The store allocates up to its capacity
+ */
+TEST(SensorStateStore,Capacity)
+{
+    Sensor_state_store store;
+
+    for(Sensor_slot slot = 0; slot < Sensor_state_store::capacity; slot++) {
+        EXPECT_EQ(slot,store.add());
+    }
+
+    EXPECT_EQ(Sensor_state_store::no_slot,store.add());
+    EXPECT_EQ(Sensor_state_store::capacity,store.size());
+    EXPECT_EQ(Sensor_state_store::capacity,store.indeterminate_count());
+
+    Sensor_slot last = Sensor_state_store::capacity - 1;
+    store.set_state(last, true);
+    EXPECT_TRUE(store.is_active(last));
+    EXPECT_EQ(Sensor_state_store::capacity - 1u,store.indeterminate_count());
+}
+
+/*
+ * Bulk queries over a set of slots spanning several words
+ */
+TEST(SensorStateStore,SetQueries)
+{
+    Sensor_state_store store;
+
+    for(Sensor_slot slot = 0; slot < 100; slot++) {
+        store.add();
+    }
+
+    Sensor_set set;
+    set.add(3);
+    set.add(Sensor_set::word_bits + 1);
+    set.add(99);
+    set.add(Sensor_state_store::capacity);    // Ignored
+
+    EXPECT_TRUE(set.contains(99));
+    EXPECT_FALSE(set.contains(98));
+    EXPECT_FALSE(set.contains(Sensor_state_store::capacity));
+
+    EXPECT_TRUE(store.any_indeterminate(set));
+    EXPECT_FALSE(store.any_active(set));
+
+    store.set_state(3, false);
+    store.set_state(Sensor_set::word_bits + 1, false);
+
+    // Slots outside the set do not count
+    store.set_state(98, true);
+    EXPECT_FALSE(store.any_active(set));
+    EXPECT_TRUE(store.any_indeterminate(set));
+
+    store.set_state(99, true);
+    EXPECT_TRUE(store.any_active(set));
+    EXPECT_FALSE(store.any_indeterminate(set));
+
+    store.set_state(99, false);
+    EXPECT_FALSE(store.any_active(set));
+}
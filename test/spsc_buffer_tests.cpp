@@ -0,0 +1,120 @@
+/*
+ * spsc_buffer_tests.cpp
+ *
+ * Unit tests for Spsc_buffer.  The Threaded test runs a producer and a
+ * consumer on separate threads; build with -fsanitize=thread to have TSAN
+ * check the index ordering.
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "spsc_buffer.h"
+#include <cstddef>
+#include <thread>
+
+
+/*
+ * Fill, overflow and drain from a single thread, with the free-running
+ * indexes passing through 255 -> 0 several times
+ */
+TEST(SpscBuffer,FillAndDrain)
+{
+    const std::size_t buffer_size = 4;
+    Spsc_buffer<uint16_t, buffer_size> spsc_buffer;
+
+    uint16_t value = 0;
+
+    EXPECT_TRUE(spsc_buffer.empty());
+    EXPECT_FALSE(spsc_buffer.pop(value));
+    EXPECT_EQ(spsc_buffer.max_size(),buffer_size);
+
+    uint16_t next_in = 0, next_out = 0;
+
+    for(int cycle = 0; cycle < 200; cycle++) {
+
+        for(std::size_t i = 0; i < buffer_size; i++) {
+            EXPECT_TRUE(spsc_buffer.push(next_in++));
+            EXPECT_EQ(spsc_buffer.size(),i+1);
+        }
+
+        // Full; the extra element is dropped and counted
+        EXPECT_FALSE(spsc_buffer.push(0xFFFF));
+        EXPECT_EQ(spsc_buffer.overflows(),cycle+1);
+
+        for(std::size_t i = 0; i < buffer_size; i++) {
+            EXPECT_TRUE(spsc_buffer.pop(value));
+            EXPECT_EQ(next_out++,value);
+        }
+
+        EXPECT_TRUE(spsc_buffer.empty());
+        EXPECT_FALSE(spsc_buffer.pop(value));
+    }
+
+    // The count of dropped elements saturates
+    for(std::size_t i = 0; i < buffer_size; i++) {
+        EXPECT_TRUE(spsc_buffer.push(next_in++));
+    }
+
+    for(int i = 0; i < 100; i++) {
+        EXPECT_FALSE(spsc_buffer.push(0xFFFF));
+    }
+
+    EXPECT_EQ(255U,spsc_buffer.overflows());
+}
+
+
+/*
+ * Stress test: one thread pushes a sequence as fast as it can while another
+ * pops it (yielding when full/empty so it also completes on a single core).  Every value must arrive exactly once and in order.
+ */
+TEST(SpscBuffer,Threaded)
+{
+    const uint32_t element_count = 200000;
+    Spsc_buffer<uint32_t, 128> spsc_buffer;
+
+    uint32_t rejected = 0;
+
+    std::thread producer([&spsc_buffer, &rejected, element_count]() {
+        for(uint32_t i = 0; i < element_count; ) {
+            if(spsc_buffer.push(i)) {
+                i++;
+            }
+            else {
+                rejected++;
+                std::this_thread::yield();  // Full; let the consumer run
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+    uint8_t overflows = 0;
+
+    while(expected < element_count) {
+        uint32_t value;
+
+        // The count read by the consumer never goes backwards
+        if(spsc_buffer.overflows() < overflows) {
+            errors++;
+        }
+        overflows = spsc_buffer.overflows();
+
+        if(spsc_buffer.pop(value)) {
+            if(value != expected) {
+                errors++;
+            }
+            expected++;
+        }
+        else {
+            std::this_thread::yield();      // Empty; let the producer run
+        }
+    }
+
+    producer.join();
+
+    EXPECT_EQ(0U,errors);
+    EXPECT_TRUE(spsc_buffer.empty());
+    EXPECT_EQ(rejected < 255 ? rejected : 255U, spsc_buffer.overflows());
+}
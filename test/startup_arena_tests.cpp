@@ -0,0 +1,197 @@
+/*
+ * startup_arena_tests.cpp
+ *
+ * Unit tests for Startup_arena and the library's storage drawn from it
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "startup_arena.h"
+#include "setup_funcs.h"
+#include "loop_funcs.h"
+#include "logic_collection.h"
+#include "ryg_logic.h"
+#include "apb_logic.h"
+#include "trace.h"
+#include "arduino_mock.h"
+
+#include <sstream>
+#include <string>
+
+using namespace mr_signals;
+
+
+namespace {
+
+/// Every byte drawn from the arena is accounted for by a subsystem or padding
+std::size_t accounted_bytes()
+{
+    std::size_t bytes = Startup_arena::padding();
+
+    for(uint8_t use = 0; use < (uint8_t)Arena_use::max_arena_use; use++) {
+        bytes += Startup_arena::usage((Arena_use)use).arena_bytes;
+        bytes += Startup_arena::usage((Arena_use)use).released_bytes;
+    }
+
+    return bytes;
+}
+
+}
+
+
+/*
+ * Storage is bumped from the buffer, aligned, and reused only when it was the
+ * last drawn
+ */
+TEST(StartupArena,DrawAndRelease)
+{
+    Startup_arena_buffer<64> arena;
+
+    EXPECT_EQ(64U, Startup_arena::capacity());
+
+    void* byte = Startup_arena::allocate(1, 1, Arena_use::logic);
+    void* word = Startup_arena::allocate(8, 8, Arena_use::logic);
+    void* last = Startup_arena::allocate(4, 4, Arena_use::collections);
+
+    EXPECT_EQ(0U, (uintptr_t)word % 8);
+    EXPECT_EQ(13U + Startup_arena::padding(), Startup_arena::used());
+    EXPECT_EQ(Startup_arena::used(), accounted_bytes());
+
+    // The last drawn is reused
+    Startup_arena::release(last, 4, Arena_use::collections);
+    EXPECT_EQ(9U + Startup_arena::padding(), Startup_arena::used());
+    EXPECT_EQ(last, Startup_arena::allocate(4, 4, Arena_use::collections));
+
+    // Others are released but still hold their bytes
+    Startup_arena::release(byte, 1, Arena_use::logic);
+    EXPECT_EQ(8U, Startup_arena::usage(Arena_use::logic).arena_bytes);
+    EXPECT_EQ(1U, Startup_arena::usage(Arena_use::logic).released_bytes);
+    EXPECT_EQ(Startup_arena::used(), accounted_bytes());
+
+    // Too big for what is left: from the heap
+    void* big = Startup_arena::allocate(64, 1, Arena_use::loconet);
+    EXPECT_EQ(1U, Startup_arena::overflows());
+    EXPECT_EQ(64U, Startup_arena::overflow_bytes());
+    EXPECT_EQ(64U, Startup_arena::usage(Arena_use::loconet).heap_bytes);
+
+    Startup_arena::release(big, 64, Arena_use::loconet);
+    EXPECT_EQ(0U, Startup_arena::usage(Arena_use::loconet).heap_bytes);
+    EXPECT_EQ(2U, Startup_arena::usage(Arena_use::logic).allocations);
+}
+
+/*
+ * Storage released after the buffer has ended (as by an object in another
+ * file destroyed after it) is counted rather than freed as heap storage
+ */
+TEST(StartupArena,ReleaseAfterEnd)
+{
+    void* drawn;
+    void* heap;
+
+    {
+        Startup_arena_buffer<16> arena;
+
+        drawn = Startup_arena::allocate(4, 4, Arena_use::logic);
+        heap = Startup_arena::allocate(32, 1, Arena_use::logic);
+
+        EXPECT_EQ(1U, Startup_arena::overflows());
+    }
+
+    EXPECT_EQ(0U, Startup_arena::capacity());
+
+    Startup_arena::release(drawn, 4, Arena_use::logic);
+    EXPECT_EQ(1U, Startup_arena::late_releases());
+    EXPECT_EQ(0U, Startup_arena::usage(Arena_use::logic).arena_bytes);
+
+    std::ostringstream report;
+    Startup_arena::report(report);
+    EXPECT_NE(std::string::npos, report.str().find("!!Releases after end: 1\n"));
+
+    // Heap storage is still freed
+    Startup_arena::release(heap, 32, Arena_use::logic);
+    EXPECT_EQ(1U, Startup_arena::late_releases());
+    EXPECT_EQ(0U, Startup_arena::usage(Arena_use::logic).heap_bytes);
+
+    // The count starts again with the next buffer
+    Startup_arena_buffer<16> arena;
+    EXPECT_EQ(0U, Startup_arena::late_releases());
+}
+
+/*
+ * A layout's collections, logic and sensor lists are drawn from the arena
+ * with no heap; once sealed an allocation comes from the heap and is reported
+ * as an error
+ */
+TEST(StartupArena,LayoutAndSeal)
+{
+    Startup_arena_buffer<1024> arena;
+
+    Trace_ring ring;
+    Trace_ring::set_active(&ring);
+
+    {
+        Setup_collection setup_coll(2);
+        Loop_collection loop_coll(2);
+        Logic_collection logic_coll(3);
+
+        Test_head head_1, head_2;
+        Sensor_base sensors[4];
+
+        Simple_ryg_logic logic_1(logic_coll, head_1, head_2, {&sensors[0], &sensors[1]});
+        Simple_ryg_logic logic_2(logic_coll, head_2, {&sensors[2]});
+        Full_apb apb(logic_coll, {&sensors[0], &sensors[1], &sensors[2], &sensors[3]});
+
+        // The working storage of the index is drawn from the arena, and all
+        // of it released back to the top (none is left as released bytes)
+        const uint16_t logic_allocations = Startup_arena::usage(Arena_use::logic).allocations;
+
+        logic_coll.enable_change_propagation();
+
+        EXPECT_LE(logic_allocations + 9U, Startup_arena::usage(Arena_use::logic).allocations);
+
+        Startup_arena::seal();
+
+        for(uint8_t use = 0; use < (uint8_t)Arena_use::max_arena_use; use++) {
+            EXPECT_EQ(0U, Startup_arena::usage((Arena_use)use).heap_bytes) << (int)use;
+        }
+
+        // Both collections' objects, and the loop collection's round-robin offsets
+        EXPECT_EQ(4 * sizeof(void*) + 2 * sizeof(collec_size),
+                  Startup_arena::usage(Arena_use::collections).arena_bytes);
+        EXPECT_EQ(7 * sizeof(void*) + Full_apb::bit_bytes(4) + 8 * sizeof(Full_apb::Tumbledown),
+                  Startup_arena::usage(Arena_use::logic_sensors).arena_bytes);
+        EXPECT_EQ(0U, Startup_arena::usage(Arena_use::logic).released_bytes);
+        EXPECT_LT(0U, Startup_arena::usage(Arena_use::logic).arena_bytes);
+        EXPECT_EQ(Startup_arena::used(), accounted_bytes());
+
+        // The collection dimensioned for 3 growing (and its timing slots), and the sensor list
+        Simple_ryg_logic logic_4(logic_coll, head_1, {&sensors[3]});
+
+        const uint16_t late = MR_SIGNALS_LOOP_TIMING ? 3 : 2;
+        EXPECT_EQ(late, Startup_arena::late_allocations());
+        EXPECT_EQ(sizeof(void*), Startup_arena::usage(Arena_use::logic_sensors).heap_bytes);
+
+        std::ostringstream report;
+        Startup_arena::report(report);
+        EXPECT_NE(std::string::npos, report.str().find("sealed\n collections:"));
+        EXPECT_NE(std::string::npos, report.str().find("!!Allocations after seal: " + std::to_string(late) + "\n"));
+
+        std::ostringstream traced;
+        ring.drain(traced);
+        std::ostringstream expected;
+        expected << "!!Allocation after setup: logic " << 6 * sizeof(void*) << " bytes\n";
+#if MR_SIGNALS_LOOP_TIMING
+        expected << "!!Allocation after setup: loop timing " << 6 * sizeof(Timing_slot) << " bytes\n";
+#endif
+        expected << "!!Allocation after setup: logic sensors " << sizeof(void*) << " bytes\n";
+        EXPECT_EQ(expected.str(), traced.str());
+    }
+
+    Trace_ring::set_active(nullptr);
+
+    // Everything from the heap was returned
+    EXPECT_EQ(0U, Startup_arena::usage(Arena_use::logic_sensors).heap_bytes);
+    EXPECT_EQ(0U, Startup_arena::usage(Arena_use::logic).heap_bytes);
+}
@@ -0,0 +1,88 @@
+/*
+ * static_vector_tests.cpp
+ *
+ * Unit tests for Static_vector and Array_view
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "static_vector.h"
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+using namespace mr_signals;
+
+
+/*
+ * Elements are held in the object, up to the capacity
+ */
+TEST(StaticVector,PushAndCapacity)
+{
+    Static_vector<int, 3> vector;
+
+    EXPECT_TRUE(vector.empty());
+    EXPECT_EQ(0U, vector.size());
+    static_assert(Static_vector<int, 3>::capacity() == 3, "capacity() should match N");
+
+    EXPECT_TRUE(vector.push_back(1));
+    EXPECT_TRUE(vector.push_back(2));
+    EXPECT_TRUE(vector.push_back(3));
+    EXPECT_FALSE(vector.push_back(4));     // Full
+
+    EXPECT_EQ(3U, vector.size());
+    EXPECT_EQ(1, vector.front());
+    EXPECT_EQ(3, vector.back());
+    EXPECT_EQ(2, vector[1]);
+
+    int sum = 0;
+    for(int element : vector) {
+        sum += element;
+    }
+    EXPECT_EQ(6, sum);
+
+    vector.clear();
+    EXPECT_TRUE(vector.empty());
+    EXPECT_TRUE(vector.push_back(5));
+    EXPECT_EQ(5, vector.front());
+}
+
+/*
+ * A braced list is taken as an array, whose length is checked against the
+ * capacity at compile time.  An initializer_list, whose length is only known
+ * at run time, is not accepted.
+ */
+TEST(StaticVector,Construction)
+{
+    int a = 1, b = 2, c = 3;
+
+    Static_vector<int*, 4> from_array({&a, &b, &c});
+    EXPECT_EQ(3U, from_array.size());
+    EXPECT_EQ(&c, from_array.back());
+
+    static_assert(!std::is_constructible<Static_vector<int, 2>, std::initializer_list<int>>::value,
+                  "An initializer_list could be truncated");
+}
+
+/*
+ * A view covers the vector's elements, and writes through to them
+ */
+TEST(StaticVector,View)
+{
+    Static_vector<int, 4> vector({7, 8});
+    Array_view<int> view = vector.view();
+
+    EXPECT_EQ(2U, view.size());
+    EXPECT_EQ(vector.data(), view.begin());
+    EXPECT_EQ(7, view.front());
+    EXPECT_EQ(8, view.back());
+
+    view[0] = 9;
+    EXPECT_EQ(9, vector[0]);
+
+    Array_view<int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.begin(), empty.end());
+}
@@ -0,0 +1,171 @@
+/*
+ * timer_service_tests.cpp
+ *
+ * Unit tests for Timer_service
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "timer_service.h"
+
+using namespace mr_signals;
+
+
+namespace {
+
+/// Counts callbacks, optionally rescheduling itself
+class Test_timer : public Timer_interface {
+public:
+    Test_timer(Timer_service& service) : service_(service), fired_(0), fired_time_(0), repeat_ms_(0) {}
+
+    void on_timer(const Runtime_ms curr_time) override {
+        fired_++;
+        fired_time_ = curr_time;
+
+        if(repeat_ms_) {
+            service_.schedule(*this, curr_time + repeat_ms_);
+        }
+    }
+
+    Timer_service& service_;
+    int fired_;
+    Runtime_ms fired_time_;
+    Runtime_ms repeat_ms_;
+};
+
+}
+
+
+/*
+ * Timers fire once, at the first tick of the wheel at or after their time
+ */
+TEST(TimerService,Expiry)
+{
+    Timer_service service;
+    Test_timer timer_1(service), timer_2(service);
+
+    const Runtime_ms tick_ms = Timer_service::tick_ms;
+
+    // timer_1 is due on a tick; timer_2 just after it
+    service.schedule(timer_1, 8 * tick_ms);
+    service.schedule(timer_2, 8 * tick_ms + 1);
+
+    EXPECT_EQ(2u,service.count());
+    EXPECT_TRUE(timer_1.is_scheduled());
+
+    Runtime_ms time_ms = 0;
+    for(; time_ms < 8 * tick_ms; time_ms++) {
+        service.service(time_ms);
+    }
+
+    EXPECT_EQ(0,timer_1.fired_);
+
+    service.service(time_ms);
+    EXPECT_EQ(1,timer_1.fired_);
+    EXPECT_EQ(8 * tick_ms,timer_1.fired_time_);
+    EXPECT_FALSE(timer_1.is_scheduled());
+
+    // timer_2 fires on the next tick
+    for(time_ms++; time_ms < 9 * tick_ms; time_ms++) {
+        service.service(time_ms);
+    }
+    EXPECT_EQ(0,timer_2.fired_);
+
+    service.service(time_ms);
+    EXPECT_EQ(1,timer_2.fired_);
+    EXPECT_EQ(0u,service.count());
+
+    for(; time_ms < 1000; time_ms++) {
+        service.service(time_ms);
+    }
+
+    EXPECT_EQ(1,timer_1.fired_);
+    EXPECT_EQ(1,timer_2.fired_);
+}
+
+/*
+ * Rescheduling replaces the pending time, and cancelled or destroyed timers
+ * do not fire
+ */
+TEST(TimerService,RescheduleAndCancel)
+{
+    Timer_service service;
+    Test_timer timer_1(service), timer_2(service);
+
+    const Runtime_ms tick_ms = Timer_service::tick_ms;
+
+    service.schedule(timer_1, 10 * tick_ms);
+    service.schedule(timer_1, 15 * tick_ms);
+    service.schedule(timer_2, 10 * tick_ms);
+    EXPECT_EQ(2u,service.count());
+
+    service.cancel(timer_2);
+    service.cancel(timer_2);
+    EXPECT_EQ(1u,service.count());
+
+    {
+        Test_timer timer_3(service);
+        service.schedule(timer_3, 10 * tick_ms);
+        EXPECT_EQ(2u,service.count());
+    }
+    EXPECT_EQ(1u,service.count());
+
+    Runtime_ms time_ms = 0;
+    for(; time_ms < 15 * tick_ms; time_ms++) {
+        service.service(time_ms);
+    }
+
+    EXPECT_EQ(0,timer_1.fired_);
+    EXPECT_EQ(0,timer_2.fired_);
+
+    service.service(time_ms);
+    EXPECT_EQ(1,timer_1.fired_);
+
+    // A time that has passed fires on the next tick
+    service.schedule(timer_2, 0);
+    service.service(time_ms + tick_ms - 1);
+    EXPECT_EQ(0,timer_2.fired_);
+    service.service(time_ms + tick_ms);
+    EXPECT_EQ(1,timer_2.fired_);
+}
+
+/*
+ * Timers due more than one revolution of the wheel later, or passed over by a
+ * long gap between calls, fire at the right time.  A callback may reschedule
+ * its own timer.
+ */
+TEST(TimerService,LongDelays)
+{
+    Timer_service service;
+    Test_timer near(service), far(service), repeat(service);
+
+    const Runtime_ms tick_ms = Timer_service::tick_ms;
+    const Runtime_ms revolution_ms = Timer_service::slot_count * tick_ms;
+
+    service.schedule(near, 2 * tick_ms);
+    service.schedule(far, 2 * tick_ms + 3 * revolution_ms);
+
+    repeat.repeat_ms_ = 5 * tick_ms;
+    service.schedule(repeat, 5 * tick_ms);
+
+    Runtime_ms time_ms = 0;
+    for(; time_ms < 2 * tick_ms + 3 * revolution_ms; time_ms++) {
+        service.service(time_ms);
+    }
+
+    EXPECT_EQ(1,near.fired_);
+    EXPECT_EQ(0,far.fired_);
+    EXPECT_EQ((int)((time_ms - 1) / (5 * tick_ms)),repeat.fired_);
+
+    service.service(time_ms);
+    EXPECT_EQ(1,far.fired_);
+
+    // Gap of many revolutions
+    service.schedule(far, time_ms + 100);
+    time_ms += 10 * revolution_ms;
+    service.service(time_ms);
+    EXPECT_EQ(2,far.fired_);
+    EXPECT_EQ(time_ms,far.fired_time_);
+}
@@ -0,0 +1,223 @@
+/*
+ * trace_tests.cpp
+ *
+ * Unit tests for Trace_ring and Trace_decoder
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+
+#include "gtest/gtest.h"
+#include "trace.h"
+#include "head_interface.h"
+#include "sensor_interface.h"
+#include "logic_collection.h"
+#include "apb_logic.h"
+#include "arduino_mock.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace mr_signals;
+
+
+namespace {
+
+/// Traces the events of a received sensor message, as the adapter does
+void trace_sensor_message()
+{
+    const uint8_t msg[4] = { 0xB2, 0x13, 0x50, 0x0E };
+    const uint8_t report[3] = { 39, 0, 1 };
+    const uint8_t state = 1;
+
+    trace(Trace_event::ln_rx, msg, sizeof(msg));
+    trace(Trace_event::sensor_report, report, sizeof(report));
+    trace_named(Trace_event::sensor_set, "T20", &state, 1);
+    trace(Trace_event::line_end);
+}
+
+const char* sensor_message_text =
+        "00001234:LN RX B2 13 50 0E Sensor: 39 - Active\nSet Sensor T20 -> Active\n";
+
+}
+
+
+/*
+ * Events are held as records until drained, then formatted as they were
+ * printed before tracing was added
+ */
+TEST(Trace,DrainFormatsEvents)
+{
+    Trace_ring ring;
+    Trace_ring::set_active(&ring);
+
+    set_millis(1234);
+    trace_sensor_message();
+
+    const uint8_t aspects[2] = { (uint8_t)Head_aspect::red, (uint8_t)Head_aspect::green };
+    const uint8_t tx_msg[3] = { 0xB0, 0x01, 0x30 };
+    const uint8_t apb_state = (uint8_t)Trace_apb_state::up_active;
+
+    set_millis(99999);
+    trace_named(Trace_event::aspect_change, "H12", aspects, 2);
+    trace(Trace_event::ln_tx, tx_msg, sizeof(tx_msg));
+    trace(Trace_event::ln_tx_backoff);
+    trace_named(Trace_event::lever_normal, "H3");
+    trace(Trace_event::aspect_accepted);
+    trace(Trace_event::apb_state, &apb_state, 1);
+
+    Trace_ring::set_active(nullptr);
+
+    EXPECT_EQ(10u,ring.size());
+
+    // Drain a limited number of events
+    std::ostringstream out;
+    EXPECT_EQ(4u,ring.drain(out, 4));
+    EXPECT_EQ(sensor_message_text,out.str());
+
+    out.str("");
+    EXPECT_EQ(6u,ring.drain(out));
+    EXPECT_EQ("H12 (red) new aspect : (green)\n"
+              "00099999:LN TX B0 01 30 cs -TX backoff\n"
+              "H3 lever normal; set to red\n"
+              "(Accepted)\n"
+              "Up tumbledowns are active\n",out.str());
+
+    EXPECT_EQ(0u,ring.size());
+    EXPECT_EQ(0u,ring.dropped());
+}
+
+/*
+ * Events with more payload than a record continue into further records, and
+ * events that do not fit are dropped whole
+ */
+TEST(Trace,LongEventsAndOverflow)
+{
+    Trace_ring ring;
+    Trace_ring::set_active(&ring);
+
+    uint8_t msg[14];
+    for(uint8_t i = 0; i < sizeof(msg); i++) {
+        msg[i] = 0xE0 + i;
+    }
+    msg[0] = 0xB4;      // OPC_LONG_ACK
+
+    set_millis(7);
+    trace(Trace_event::ln_rx, msg, sizeof(msg));
+    EXPECT_EQ(2u,ring.size());
+
+    // Fill the ring; the last event cannot fit
+    while(ring.size() + 2 <= Trace_ring::capacity) {
+        trace(Trace_event::ln_rx, msg, sizeof(msg));
+    }
+    trace(Trace_event::ln_rx, msg, sizeof(msg));
+    EXPECT_EQ(1u,ring.dropped());
+
+    Trace_ring::set_active(nullptr);
+
+    std::ostringstream out;
+    EXPECT_EQ(1u,ring.drain(out, 1));
+    EXPECT_EQ("00000007:LN RX B4 E1 E2 E3 E4 E5 E6 E7 E8 E9 EA EB EC ED  LONG_ACK!",out.str());
+}
+
+/*
+ * A binary dump decodes on the host to the same text as draining the ring
+ */
+TEST(Trace,DumpDecodesToText)
+{
+    Trace_ring ring;
+    Trace_ring::set_active(&ring);
+
+    set_millis(1234);
+    trace_sensor_message();
+
+    Trace_ring::set_active(nullptr);
+
+    std::ostringstream dump;
+    EXPECT_EQ(4u,ring.dump(dump));
+    EXPECT_EQ(0u,ring.size());
+
+    std::string bytes = dump.str();
+    ASSERT_EQ(4u * Trace_record::dump_size,bytes.size());
+
+    Trace_decoder decoder;
+    Trace_record record;
+    std::ostringstream out;
+
+    // A continuation record without its start is skipped
+    record.event = Trace_event::continuation;
+    record.size = 12;
+    EXPECT_FALSE(decoder.decode(record, out));
+
+    for(std::size_t offset = 0; offset < bytes.size(); offset += Trace_record::dump_size) {
+        Trace_decoder::from_dump((const uint8_t*)bytes.data() + offset, record);
+        decoder.decode(record, out);
+    }
+
+    EXPECT_EQ(sensor_message_text,out.str());
+}
+
+
+/*
+ * With no active ring, events are dropped unless the Serial fallback has
+ * been enabled
+ */
+TEST(Trace,NoRingSerialFallback)
+{
+    std::ostringstream serial;
+    std::streambuf* cout_buf = std::cout.rdbuf(serial.rdbuf());
+
+    set_millis(1234);
+    trace(Trace_event::ln_tx_backoff);
+    EXPECT_EQ("",serial.str());
+
+    Trace_ring::set_serial_fallback(true);
+    trace(Trace_event::ln_tx_backoff);
+    Trace_ring::set_serial_fallback(false);
+
+    std::cout.rdbuf(cout_buf);
+
+    EXPECT_EQ("-TX backoff\n",serial.str());
+}
+
+/*
+ * Full_apb traces its state when it changes, not on every pass
+ */
+TEST(Trace,ApbStateOnChange)
+{
+    Sensor_base sensors[3];
+    Logic_collection collection(1);
+    Full_apb apb(collection, {&sensors[0], &sensors[1], &sensors[2]});
+
+    for(auto& sensor : sensors) {
+        sensor.set_state(false);
+    }
+
+    Trace_ring ring;
+    Trace_ring::set_active(&ring);
+
+    for(int pass = 0; pass < 3; pass++) {
+        apb.loop();
+    }
+    EXPECT_EQ(1u,ring.size());
+
+    // A train entering the last block in the up direction
+    sensors[2].set_state(true);
+    apb.loop();
+    std::size_t traced = ring.size();
+    EXPECT_LT(1u,traced);
+
+    for(int pass = 0; pass < 3; pass++) {
+        apb.loop();
+    }
+
+    Trace_ring::set_active(nullptr);
+
+    EXPECT_EQ(traced,ring.size());
+
+    std::ostringstream text;
+    ring.drain(text);
+    EXPECT_EQ(0u,text.str().find("No sensors active, clear all tumbledowns\n"
+                                 "Up tumbledowns are inactive, sensor[n-1] active, set down tumbledowns\n"));
+}
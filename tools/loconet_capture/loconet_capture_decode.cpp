@@ -0,0 +1,71 @@
+/*
+ * loconet_capture_decode.cpp
+ *
+ * Host tool that prints a LocoNet capture, as written to Serial by
+ * Loconet_capture::dump(), in the text of the adapter's LN RX / LN TX traces
+ * (times are from the start of the capture).  Replay a capture through the
+ * adapter with test/loconet_replay.h.
+ *
+ * Build from the repository root with e.g.:
+ *
+ * g++ -std=c++11 -Isrc -Isrc/base -Isrc/loconet -Itest \
+ *     tools/loconet_capture/loconet_capture_decode.cpp src/loconet/loconet_capture.cpp \
+ *     src/base/trace.cpp src/base/startup_arena.cpp test/arduino_mock.cpp \
+ *     -o loconet_capture_decode
+ *
+ * Usage: loconet_capture_decode [capture file]     (reads stdin with no file)
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include "loconet_capture.h"
+#include "trace.h"
+
+using namespace mr_signals;
+
+
+int main(int argc, char* argv[])
+{
+    std::ifstream file;
+    std::istream* in = &std::cin;
+
+    if(argc > 1) {
+        file.open(argv[1], std::ios::binary);
+        if(!file) {
+            std::cerr << "Cannot open " << argv[1] << "\n";
+            return 1;
+        }
+        in = &file;
+    }
+
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(*in)), std::istreambuf_iterator<char>());
+
+    Loconet_capture_reader reader(bytes.data(), bytes.size());
+    Loconet_capture_entry entry;
+    unsigned long messages = 0;
+
+    while(reader.next(entry)) {
+        if(Loconet_capture_direction::rx == entry.direction) {
+            Trace_decoder::format(std::cout, entry.time_ms, Trace_event::ln_rx, entry.message, entry.size);
+        }
+        else {
+            // As traced, less the checksum
+            Trace_decoder::format(std::cout, entry.time_ms, Trace_event::ln_tx, entry.message, entry.size - 1);
+        }
+
+        std::cout << "\n";
+        messages++;
+    }
+
+    if(reader.error()) {
+        std::cerr << "\nCapture is not valid after " << messages << " messages\n";
+        return 1;
+    }
+
+    return 0;
+}
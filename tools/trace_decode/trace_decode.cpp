@@ -0,0 +1,55 @@
+/*
+ * trace_decode.cpp
+ *
+ * Host tool that decodes a binary dump of trace records, as written to
+ * Serial by Trace_ring::dump(), into the text the traced code used to print.
+ *
+ * Build from the repository root with e.g.:
+ *
+ * g++ -std=c++11 -Isrc -Isrc/base -Itest tools/trace_decode/trace_decode.cpp \
+ *     src/base/trace.cpp src/base/startup_arena.cpp test/arduino_mock.cpp -o trace_decode
+ *
+ * Usage: trace_decode [dump file]      (reads stdin with no file)
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include "trace.h"
+
+using namespace mr_signals;
+
+
+int main(int argc, char* argv[])
+{
+    std::ifstream file;
+    std::istream* in = &std::cin;
+
+    if(argc > 1) {
+        file.open(argv[1], std::ios::binary);
+        if(!file) {
+            std::cerr << "Cannot open " << argv[1] << "\n";
+            return 1;
+        }
+        in = &file;
+    }
+
+    Trace_decoder decoder;
+    Trace_record record;
+    char bytes[Trace_record::dump_size];
+    unsigned long records = 0;
+
+    while(in->read(bytes, sizeof(bytes))) {
+        Trace_decoder::from_dump((const uint8_t*)bytes, record);
+        decoder.decode(record, std::cout);
+        records++;
+    }
+
+    if(in->gcount()) {
+        std::cerr << "\nIgnored " << in->gcount() << " trailing bytes after " << records << " records\n";
+    }
+
+    return 0;
+}